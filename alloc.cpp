@@ -0,0 +1,130 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "report.hpp"
+
+#include <cstdlib>
+#include <new>
+
+/*
+ *  The allocator of the referee executable, it tells Report about every
+ *  allocation made through the operators new so --time-report can charge
+ *  them to the phases.  Only referee links it: the library, the tests and
+ *  the benchmarks keep the standard operators.  Buffers LLVM takes from
+ *  malloc directly are not seen.
+ */
+
+static void*    allocate(std::size_t size, std::size_t align, bool nothrow)
+{
+    size    = size ? size : 1;
+
+    for(;;)
+    {
+        //  aligned_alloc wants a multiple of the alignment
+        auto    ptr = align > alignof(std::max_align_t)
+                    ? std::aligned_alloc(align, (size + align - 1) / align * align)
+                    : std::malloc(size);
+
+        if(ptr)
+        {
+            Report::allocated();
+            return  ptr;
+        }
+
+        auto    handler = std::get_new_handler();
+        if(!handler)
+        {
+            if(nothrow)
+                return  nullptr;
+
+            throw std::bad_alloc();
+        }
+
+        try
+        {
+            handler();
+        }
+        catch(std::bad_alloc const&)
+        {
+            if(nothrow)
+                return  nullptr;
+
+            throw;
+        }
+    }
+}
+
+void*   operator new(std::size_t size)
+{
+    return  allocate(size, 0, false);
+}
+
+void*   operator new[](std::size_t size)
+{
+    return  allocate(size, 0, false);
+}
+
+void*   operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return  allocate(size, 0, true);
+}
+
+void*   operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return  allocate(size, 0, true);
+}
+
+void*   operator new(std::size_t size, std::align_val_t align)
+{
+    return  allocate(size, std::size_t(align), false);
+}
+
+void*   operator new[](std::size_t size, std::align_val_t align)
+{
+    return  allocate(size, std::size_t(align), false);
+}
+
+void*   operator new(std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept
+{
+    return  allocate(size, std::size_t(align), true);
+}
+
+void*   operator new[](std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept
+{
+    return  allocate(size, std::size_t(align), true);
+}
+
+//  malloc and aligned_alloc memory alike goes back through free
+void    operator delete(void* ptr) noexcept                                             {std::free(ptr);}
+void    operator delete[](void* ptr) noexcept                                           {std::free(ptr);}
+void    operator delete(void* ptr, std::size_t) noexcept                                {std::free(ptr);}
+void    operator delete[](void* ptr, std::size_t) noexcept                              {std::free(ptr);}
+void    operator delete(void* ptr, std::nothrow_t const&) noexcept                      {std::free(ptr);}
+void    operator delete[](void* ptr, std::nothrow_t const&) noexcept                    {std::free(ptr);}
+void    operator delete(void* ptr, std::align_val_t) noexcept                           {std::free(ptr);}
+void    operator delete[](void* ptr, std::align_val_t) noexcept                         {std::free(ptr);}
+void    operator delete(void* ptr, std::size_t, std::align_val_t) noexcept              {std::free(ptr);}
+void    operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept            {std::free(ptr);}
+void    operator delete(void* ptr, std::align_val_t, std::nothrow_t const&) noexcept    {std::free(ptr);}
+void    operator delete[](void* ptr, std::align_val_t, std::nothrow_t const&) noexcept  {std::free(ptr);}
@@ -0,0 +1,135 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "bench.hpp"
+
+#include "referee.hpp"
+#include "jit.hpp"
+
+#include "llvm/Support/TargetSelect.h"
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+static llvm::ExitOnError ExitOnErr;
+
+//  JITs the module compiled from `source`, kept alive for the whole run
+static RefereeJIT*  load(std::string const& source, std::string const& name, Options const& options, std::string& symbol)
+{
+    static std::vector<std::unique_ptr<RefereeJIT>> jits;
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+
+    std::istringstream  is(source);
+
+    auto    TSM         = Referee::module(is, name, options);
+    auto    TheJIT      = ExitOnErr(RefereeJIT::Create(nullptr, options.cpu, options.features));
+
+    TSM.withModuleDo([&](llvm::Module& M) {
+        for(auto& func: M.getFunctionList())
+        {
+            if(!func.isDeclaration() && !func.getName().endswith(".chunk"))
+                symbol  = func.getName().str();
+        }
+    });
+
+    ExitOnErr(TheJIT->addModule(std::move(TSM)));
+
+    jits.push_back(std::move(TheJIT));
+
+    return  jits.back().get();
+}
+
+Bench::func_t   Bench::compile(std::string const& source, std::string const& name, Options const& options)
+{
+    static std::map<std::string, func_t>            funcs;
+
+    auto    iter    = funcs.find(name);
+    if(iter != funcs.end())
+    {
+        return  iter->second;
+    }
+
+    std::string symbol;
+    auto    jit     = load(source, name, options, symbol);
+    auto    func    = func_t((intptr_t)ExitOnErr(jit->lookup(symbol)).getAddress(), options.layout == Layout::columns);
+
+    funcs[name] = func;
+
+    return  func;
+}
+
+Chunks  Bench::chunks(std::string const& source, std::string const& name, Options const& options)
+{
+    static std::map<std::string, Chunks>            chunks;
+
+    auto    iter    = chunks.find(name);
+    if(iter != chunks.end())
+    {
+        return  iter->second;
+    }
+
+    std::string symbol;
+    auto    jit     = load(source, name, options, symbol);
+    auto    chunk   = Chunks(
+                        (Chunks::func_t)(intptr_t)ExitOnErr(jit->lookup(symbol + ".chunk")).getAddress(),
+                        (int64_t const*)(intptr_t)ExitOnErr(jit->lookup(symbol + ".horizon")).getAddress(),
+                        (uint8_t const*)(intptr_t)ExitOnErr(jit->lookup(symbol + ".seams")).getAddress());
+
+    chunks.emplace(name, chunk);
+
+    return  chunk;
+}
+
+static bool const   T   = true;
+static bool const   F   = false;
+
+BenchTrace::BenchTrace(size_t size, int64_t step)
+    : m_rows(size + 2)
+{
+    for(size_t i = 0; i < m_rows.size(); i++)
+    {
+        m_rows[i].time  = int64_t(i) * step;
+        m_rows[i].a     = &F;
+        m_rows[i].b     = &F;
+    }
+
+    //  sentinels sit right next to the real rows, as in Trace
+    m_rows.front().time = m_rows[1].time - 1;
+    m_rows.back().time  = m_rows[size].time + 1;
+}
+
+void    BenchTrace::a(size_t indx, bool value)
+{
+    m_rows[indx + 1].a  = value ? &T : &F;
+}
+
+void    BenchTrace::b(size_t indx, bool value)
+{
+    m_rows[indx + 1].b  = value ? &T : &F;
+}
@@ -0,0 +1,88 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "chunks.hpp"
+#include "options.hpp"
+
+class Bench
+{
+public:
+    //  the entry point of a spec, cols is only passed to functions compiled
+    //  for Layout::columns since the others are emitted without it
+    class func_t
+    {
+    public:
+        func_t(intptr_t addr = 0, bool cols = false) : m_addr(addr), m_cols(cols) {}
+
+        bool    operator()(void* frst, void* last, void* conf, void* cols) const
+        {
+            return  m_cols
+                ? reinterpret_cast<bool (*)(void*, void*, void*, void*)>(m_addr)(frst, last, conf, cols)
+                : reinterpret_cast<bool (*)(void*, void*, void*)>(m_addr)(frst, last, conf);
+        }
+
+    private:
+        intptr_t    m_addr;
+        bool        m_cols;
+    };
+
+    //  compiles the single spec in `source` and returns its entry point, the
+    //  result is cached by `name` since modules are hash-consed by name
+    static func_t   compile(std::string const& source, std::string const& name, Options const& options = Options());
+
+    //  the chunked form of the single G(...) spec in `source`, options.chunk
+    //  must be set
+    static Chunks   chunks(std::string const& source, std::string const& name, Options const& options);
+};
+
+//  __prop_t of a module declaring boolean props `a` and `b`
+struct BenchRow
+{
+    int64_t     time;
+    bool const* a;
+    bool const* b;
+};
+
+class BenchTrace
+{
+public:
+    //  `size` rows `step` time units apart, plus the frst/last sentinels
+    BenchTrace(size_t size, int64_t step);
+
+    void        a(size_t indx, bool value);
+    void        b(size_t indx, bool value);
+
+    void*       frst()  {return &m_rows.front();}
+    void*       last()  {return &m_rows.back();}
+    size_t      size()  {return m_rows.size() - 2;}
+
+private:
+    std::vector<BenchRow>   m_rows;
+};
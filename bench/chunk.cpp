@@ -0,0 +1,87 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "bench.hpp"
+#include "pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+//  G(a => F[0:50](b)) and G(a => F(b)) over one long trace, checked whole or
+//  in chunks of `chunk` rows spread over one worker per hardware thread
+
+static constexpr size_t     rows    = 1 << 20;
+static constexpr int64_t    step    = 10;
+
+static void     chunked(benchmark::State& state, std::string spec, std::string op)
+{
+    auto    chunk   = size_t(state.range(0));
+    auto    name    = "chunk-" + op + "-" + std::to_string(chunk);
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      + spec + "\n";
+
+    Options options;
+    options.chunk   = chunk;
+
+    BenchTrace  trace(rows, step);
+    for(size_t i = 0; i < rows; i++)
+    {
+        trace.a(i, i % 7 == 0);
+        trace.b(i, i % 3 == 0);
+    }
+
+    Pool    pool;
+    auto    func    = chunk ? Bench::func_t() : Bench::compile(source, name, options);
+    auto    chunks  = chunk ? Bench::chunks(source, name, options) : Chunks(nullptr, nullptr, nullptr);
+
+    for(auto _: state)
+    {
+        auto    result  = chunk
+                        ? chunks.run(pool, (char*)trace.frst(), trace.size(), sizeof(BenchRow), nullptr, chunk)
+                        : func(trace.frst(), trace.last(), nullptr, nullptr);
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+static void     ChunkTimed(benchmark::State& state)
+{
+    chunked(state, "G(a => F[0:50](b));", "F50");
+}
+
+static void     ChunkUntimed(benchmark::State& state)
+{
+    chunked(state, "G(a => F(b));", "F");
+}
+
+BENCHMARK(ChunkTimed)  ->ArgNames({"chunk"})->Arg(0)->Arg(1 << 14)->Arg(1 << 17)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(ChunkUntimed)->ArgNames({"chunk"})->Arg(0)->Arg(1 << 14)->Arg(1 << 17)->Unit(benchmark::kMillisecond)->UseRealTime();
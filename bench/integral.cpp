@@ -0,0 +1,84 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+//  G(I[0:w](b, h) <= w * h) with b holding every other row, the scan adds up
+//  about `width` rows from every position while the prefix sums answer each
+//  position with two binary searches
+
+static constexpr size_t     rows    = 1 << 16;
+static constexpr int64_t    step    = 10;
+
+static void     integral(benchmark::State& state, std::string type, std::string height)
+{
+    auto    width   = state.range(0);
+    auto    sweep   = state.range(1) != 0;
+    auto    name    = "I-" + type + "-" + std::to_string(width) + (sweep ? "-sweep" : "-scan");
+    auto    span    = std::to_string(width * step);
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "G(I[0:" + span + "](b, " + height + ") <= " + span + " * " + height + ");\n";
+
+    Options options;
+    options.sweep   = sweep;
+
+    auto    func    = Bench::compile(source, name, options);
+
+    BenchTrace  trace(rows, step);
+    for(size_t i = 0; i < rows; i++)
+    {
+        trace.b(i, i % 2 == 0);
+    }
+
+    for(auto _: state)
+    {
+        auto    result  = func(trace.frst(), trace.last(), nullptr, nullptr);
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+static void     Integer(benchmark::State& state)
+{
+    integral(state, "integer", "2");
+}
+
+static void     Number(benchmark::State& state)
+{
+    integral(state, "number", "1.5");
+}
+
+BENCHMARK(Integer)->ArgNames({"width", "sweep"})->ArgsProduct({{16, 256, 4096}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(Number) ->ArgNames({"width", "sweep"})->ArgsProduct({{16, 256, 4096}, {0, 1}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,144 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  64 boolean props where exactly one of p0 .. p15 holds on every row, laid
+//  out as rows of pointers, as one column per prop or as rows of values
+
+static constexpr size_t     rows    = 1 << 16;
+static constexpr size_t     props   = 64;
+static constexpr int64_t    step    = 10;
+
+//  a __prop_t row under Layout::values
+struct Row
+{
+    int64_t time;
+    bool    p[props];
+};
+
+static void     layout(benchmark::State& state, std::string const& spec, std::string const& name)
+{
+    auto    kind    = Layout(state.range(0));
+    auto    source  = std::string();
+
+    for(size_t j = 0; j < props; j++)
+    {
+        source  += "data p" + std::to_string(j) + ": boolean;\n";
+    }
+    source  += spec + "\n";
+
+    Options options;
+    options.layout  = kind;
+
+    static char const*  names[]   = {"-pointers", "-columns", "-values"};
+
+    auto    func    = Bench::compile(source, name + names[state.range(0)], options);
+
+    //  value of p<j> at row k, the sentinels included
+    std::vector<std::vector<bool>>  values(props, std::vector<bool>(rows + 2));
+    for(size_t k = 1; k <= rows; k++)
+    {
+        for(size_t j = 0; j < 16; j++)
+        {
+            values[j][k]    = (k + j) % 16 == 0;
+        }
+    }
+
+    static bool const   T   = true;
+    static bool const   F   = false;
+
+    std::vector<int64_t>            times(rows + 2);
+    std::vector<std::vector<char>>  column(props, std::vector<char>(rows + 2));
+    std::vector<void*>              cols(props);
+    std::vector<int64_t>            table((rows + 2) * (props + 1));
+    std::vector<Row>                inlined(rows + 2);
+
+    for(size_t k = 0; k < rows + 2; k++)
+    {
+        //  sentinels sit right next to the real rows, as in Trace
+        times[k]    = k == 0 ? step - 1 : k == rows + 1 ? int64_t(rows) * step + 1 : int64_t(k) * step;
+        table[k * (props + 1)]  = times[k];
+        inlined[k].time = times[k];
+
+        for(size_t j = 0; j < props; j++)
+        {
+            column[j][k]    = values[j][k];
+            table[k * (props + 1) + j + 1]  = reinterpret_cast<intptr_t>(values[j][k] ? &T : &F);
+            inlined[k].p[j] = values[j][k];
+        }
+    }
+
+    for(size_t j = 0; j < props; j++)
+    {
+        cols[j] = column[j].data();
+    }
+
+    auto    frst    = kind == Layout::columns ? (void*)&times.front()
+                    : kind == Layout::values  ? (void*)&inlined.front()
+                    : (void*)&table.front();
+    auto    last    = kind == Layout::columns ? (void*)&times.back()
+                    : kind == Layout::values  ? (void*)&inlined.back()
+                    : (void*)&table[(rows + 1) * (props + 1)];
+
+    for(auto _: state)
+    {
+        auto    result  = func(frst, last, nullptr, cols.data());
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+static void     Atoms(benchmark::State& state)
+{
+    auto    spec    = std::string("G(p0");
+
+    for(size_t j = 1; j < 16; j++)
+    {
+        spec    += " || p" + std::to_string(j);
+    }
+
+    layout(state, spec + ");", "layout-atoms");
+}
+
+static void     Window(benchmark::State& state)
+{
+    layout(state, "G(p1 => F[0:" + std::to_string(16 * step) + "](p0));", "layout-window");
+}
+
+//  layout: 0 pointers, 1 columns, 2 values
+BENCHMARK(Atoms) ->ArgNames({"layout"})->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+BENCHMARK(Window)->ArgNames({"layout"})->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
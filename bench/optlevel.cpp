@@ -0,0 +1,90 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "bench.hpp"
+#include "referee.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+//  the same spec compiled at -O0 .. -O3: the time Referee::compile takes to
+//  emit and optimize it, and the rows per second the result checks
+
+static constexpr size_t     rows    = 1 << 20;
+static constexpr int64_t    step    = 10;
+
+static auto const   source  = std::string(
+                        "data a: boolean;\n"
+                        "data b: boolean;\n"
+                        "G(a => (F[0:50](b) && O[0:50](b) || Us(!a, b)));\n");
+
+static void     OptLevelCompile(benchmark::State& state)
+{
+    Options options;
+    options.optLevel    = unsigned(state.range(0));
+
+    //  modules are hash-consed by name, every iteration compiles a fresh one
+    static auto count   = 0;
+    for(auto _: state)
+    {
+        std::istringstream  is(source);
+        std::ostringstream  os;
+        Referee::compile(is, "opt-compile-" + std::to_string(state.range(0)) + "-" + std::to_string(count++), os, options);
+        benchmark::DoNotOptimize(os.str().size());
+    }
+}
+
+static void     OptLevelCheck(benchmark::State& state)
+{
+    Options options;
+    options.optLevel    = unsigned(state.range(0));
+
+    BenchTrace  trace(rows, step);
+    for(size_t i = 0; i < rows; i++)
+    {
+        trace.a(i, i % 7 == 0);
+        trace.b(i, i % 3 == 0);
+    }
+
+    auto    func    = Bench::compile(source, "opt-check-" + std::to_string(state.range(0)), options);
+
+    for(auto _: state)
+    {
+        auto    result  = func(trace.frst(), trace.last(), nullptr, nullptr);
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+BENCHMARK(OptLevelCompile)->ArgNames({"O"})->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+BENCHMARK(OptLevelCheck)  ->ArgNames({"O"})->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
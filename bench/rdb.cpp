@@ -0,0 +1,166 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "../rdb/database.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+//  walks one large rdb file decoding every pushed integer, either copying each
+//  record out of the reader or decoding it in place over the mapped file
+
+static constexpr size_t     records = 1 << 20;
+
+static std::string  rdbFile()
+{
+    using namespace referee::db;
+
+    static std::string  filename;
+
+    if(filename.empty())
+    {
+        auto    integer = TypeInteger();
+
+        Writer  writer;
+        filename    = "bench.rdb";
+        writer.open(filename);
+
+        auto    prop    = writer.declProp(writer.declType(&integer), "n");
+        for(size_t i = 0; i < records; i++)
+        {
+            writer.pushData(prop, i, DataWriter().integer(i).build());
+        }
+        writer.close();
+    }
+
+    return  filename;
+}
+
+template<typename Record>
+static void     rdb(benchmark::State& state)
+{
+    auto    filename    = rdbFile();
+
+    for(auto _: state)
+    {
+        referee::db::Reader reader;
+        Record              record;
+        int64_t             total   = 0;
+
+        reader.open(filename, unsigned(state.range(0)));
+
+        while(reader.next(record))
+        {
+            if(record.type != referee::db::PUSH_PROP)
+                continue;
+
+            int64_t value;
+            referee::db::DataReader(record.data).integer(value);
+            total  += value;
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * records);
+}
+
+static void     RdbCopy(benchmark::State& state)
+{
+    rdb<referee::db::Record>(state);
+}
+
+static void     RdbView(benchmark::State& state)
+{
+    rdb<referee::db::RecordView>(state);
+}
+
+BENCHMARK(RdbCopy)->ArgNames({"advice"})->Arg(referee::db::NORMAL)->Arg(referee::db::SEQUENTIAL)->Unit(benchmark::kMillisecond);
+BENCHMARK(RdbView)->ArgNames({"advice"})->Arg(referee::db::NORMAL)->Arg(referee::db::SEQUENTIAL)->Arg(referee::db::SEQUENTIAL | referee::db::HUGEPAGE)->Unit(benchmark::kMillisecond);
+
+//  3 of 80 integer props read back from a FLAT and a COLUMNS file
+
+static constexpr size_t     samples = 1 << 18;
+
+static std::string  propsFile(referee::db::Format format)
+{
+    using namespace referee::db;
+
+    static std::string  filenames[COLUMNS + 1];
+    auto&   filename    = filenames[format];
+
+    if(filename.empty())
+    {
+        auto    integer = TypeInteger();
+
+        Writer  writer;
+        filename    = "bench." + std::to_string(format) + ".rdb";
+        writer.open(filename, format);
+
+        auto    type    = writer.declType(&integer);
+        for(auto i = 0; i < 80; i++)
+        {
+            writer.declProp(type, "p" + std::to_string(i));
+        }
+        for(size_t i = 0; i < samples; i++)
+        {
+            writer.pushData(1 + i % 80, i, DataWriter().integer(i * 3).build());
+        }
+        writer.close();
+    }
+
+    return  filename;
+}
+
+static void     RdbSelect(benchmark::State& state)
+{
+    auto    filename    = propsFile(referee::db::Format(state.range(0)));
+
+    for(auto _: state)
+    {
+        referee::db::Reader     reader;
+        referee::db::RecordView record;
+        int64_t                 total   = 0;
+
+        reader.open(filename);
+        reader.select({"p3", "p40", "p79"});
+
+        while(reader.next(record))
+        {
+            if(record.type != referee::db::PUSH_PROP)
+                continue;
+
+            int64_t value;
+            referee::db::DataReader(record.data).integer(value);
+            total  += value;
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+
+BENCHMARK(RdbSelect)->ArgNames({"format"})->Arg(referee::db::FLAT)->Arg(referee::db::COLUMNS)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  a nested untimed U over two boolean columns, its rows are packed into
+//  64-bit words by a loop the host features let the backend vectorize;
+//  generated for the baseline x86-64 and for the host cpu
+
+static constexpr size_t     rows    = 1 << 20;
+static constexpr int64_t    step    = 10;
+
+static auto const   source  = std::string(
+                        "data a: boolean;\n"
+                        "data b: boolean;\n"
+                        "G(a || Uw(!a, b));\n");
+
+static void     Target(benchmark::State& state)
+{
+    Options options;
+    options.layout  = Layout::columns;
+    options.cpu     = state.range(0) ? "" : "x86-64";
+
+    auto    func    = Bench::compile(source, "target-" + std::to_string(state.range(0)), options);
+
+    //  a holds every 16th row and b on the row before it, the sentinels included
+    std::vector<int64_t>    times(rows + 2);
+    std::vector<char>       a(rows + 2);
+    std::vector<char>       b(rows + 2);
+
+    for(size_t k = 0; k < rows + 2; k++)
+    {
+        times[k]    = k == 0 ? step - 1 : k == rows + 1 ? int64_t(rows) * step + 1 : int64_t(k) * step;
+        a[k]        = k % 16 == 0;
+        b[k]        = k % 16 == 15;
+    }
+
+    void*   cols[]  = {a.data(), b.data()};
+
+    for(auto _: state)
+    {
+        auto    result  = func(&times.front(), &times.back(), nullptr, cols);
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+//  host: 0 baseline x86-64, 1 the cpu referee runs on
+BENCHMARK(Target)->ArgNames({"host"})->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
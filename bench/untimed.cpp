@@ -0,0 +1,82 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+//  G(a => F(b)) and G(b => O(a)) with the nested untimed operator swept one
+//  row at a time or resolved 64 rows at a time on packed words
+
+static constexpr size_t     rows    = 1 << 18;
+static constexpr int64_t    step    = 10;
+
+static void     untimed(benchmark::State& state, std::string spec, std::string op)
+{
+    auto    bitset  = state.range(0) != 0;
+    auto    name    = "untimed-" + op + (bitset ? "-bitset" : "-bytes");
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      + spec + "\n";
+
+    Options options;
+    options.bitset  = bitset;
+
+    auto    func    = Bench::compile(source, name, options);
+
+    BenchTrace  trace(rows, step);
+    for(size_t i = 0; i < rows; i++)
+    {
+        trace.a(i, i % 7 == 0);
+        trace.b(i, i % 3 == 0);
+    }
+
+    for(auto _: state)
+    {
+        auto    result  = func(trace.frst(), trace.last(), nullptr, nullptr);
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+static void     UntimedFuture(benchmark::State& state)
+{
+    untimed(state, "G(a => F(b));", "F");
+}
+
+static void     UntimedPast(benchmark::State& state)
+{
+    untimed(state, "G(b => O(a));", "O");
+}
+
+BENCHMARK(UntimedFuture)->ArgNames({"bitset"})->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(UntimedPast)  ->ArgNames({"bitset"})->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,84 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+//  G(F[0:w](b)) and G(O[0:w](b)) with b holding once every `width` rows, so
+//  the forward/backward scan visits about width/2 rows from every position
+//  while the sliding window does a constant amount of work per row
+
+static constexpr size_t     rows    = 1 << 16;
+static constexpr int64_t    step    = 10;
+
+static void     window(benchmark::State& state, std::string op, size_t phase)
+{
+    auto    width   = state.range(0);
+    auto    sweep   = state.range(1) != 0;
+    auto    name    = op + "-" + std::to_string(width) + (sweep ? "-sweep" : "-scan");
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "G(" + op + "[0:" + std::to_string(width * step) + "](b));\n";
+
+    Options options;
+    options.sweep   = sweep;
+
+    auto    func    = Bench::compile(source, name, options);
+
+    BenchTrace  trace(rows, step);
+    for(size_t i = 0; i < rows; i++)
+    {
+        trace.b(i, i % width == phase % width);
+    }
+
+    for(auto _: state)
+    {
+        auto    result  = func(trace.frst(), trace.last(), nullptr, nullptr);
+        benchmark::DoNotOptimize(result);
+
+        if(!result)
+        {
+            state.SkipWithError("spec failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+static void     Future(benchmark::State& state)
+{
+    window(state, "F", state.range(0) - 1);
+}
+
+static void     Past(benchmark::State& state)
+{
+    window(state, "O", 0);
+}
+
+BENCHMARK(Future)->ArgNames({"width", "sweep"})->ArgsProduct({{16, 256, 4096}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(Past)  ->ArgNames({"width", "sweep"})->ArgsProduct({{16, 256, 4096}, {0, 1}})->Unit(benchmark::kMillisecond);
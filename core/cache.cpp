@@ -0,0 +1,217 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cache.hpp"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA1.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+Cache::Cache(std::string const& dir, size_t limit)
+    : m_dir(dir)
+    , m_limit(limit)
+{
+    std::filesystem::create_directories(m_dir);
+}
+
+std::string Cache::key(std::string const& source, Options const& options)
+{
+    llvm::SHA1  hash;
+
+    auto    field   = [&](std::string const& text)
+    {
+        hash.update(text);
+        hash.update(llvm::StringRef("", 1));
+    };
+
+    //  function names carry the positions of the specs, so only what does
+    //  not move a token is normalized
+    std::istringstream  lines(source);
+    std::string         line;
+    std::string         text;
+    while(std::getline(lines, line))
+    {
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        text    += line + "\n";
+    }
+    field(text);
+
+    //  one field per option, so no two settings hash the same text
+    field(std::to_string(options.sweep));
+    field(std::to_string(options.bitset));
+    field(std::to_string(options.monitor));
+    field(std::to_string(int(options.layout)));
+    field(std::to_string(options.chunk != 0));
+    field(std::to_string(options.witness));
+    field(std::to_string(options.optLevel));
+    field(std::to_string(options.share));
+    field(options.cpu);
+    field(options.features);
+
+    field(REFEREE_VERSION);
+    field(LLVM_VERSION_STRING);
+    field(llvm::sys::getProcessTriple());
+    field(llvm::sys::getHostCPUName().str());
+
+    llvm::StringMap<bool>           features;
+    std::map<std::string, bool>     sorted;
+    llvm::sys::getHostCPUFeatures(features);
+    for(auto& feature: features)
+    {
+        sorted[feature.first().str()]   = feature.second;
+    }
+    for(auto& [name, enabled]: sorted)
+    {
+        field((enabled ? "+" : "-") + name);
+    }
+
+    return  llvm::toHex(hash.final(), true);
+}
+
+std::unique_ptr<llvm::MemoryBuffer> Cache::load(std::string const& key)
+{
+    auto    path    = m_dir / (key + ".o");
+    auto    buffer  = llvm::MemoryBuffer::getFile(path.string());
+
+    if(!buffer)
+        return  nullptr;
+
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    return  std::move(*buffer);
+}
+
+std::set<std::string>   Cache::symbols(llvm::MemoryBuffer const& object, char prefix)
+{
+    std::set<std::string>   result;
+
+    auto    file    = llvm::object::ObjectFile::createObjectFile(object.getMemBufferRef());
+    if(!file)
+    {
+        llvm::consumeError(file.takeError());
+        return  result;
+    }
+
+    for(auto& symbol: (*file)->symbols())
+    {
+        auto    flags   = symbol.getFlags();
+        auto    name    = symbol.getName();
+
+        if(!flags || !name)
+        {
+            llvm::consumeError(flags.takeError());
+            llvm::consumeError(name.takeError());
+            continue;
+        }
+
+        if(!(*flags & llvm::object::SymbolRef::SF_Global) || (*flags & llvm::object::SymbolRef::SF_Undefined))
+            continue;
+
+        auto    text    = name->str();
+        if(prefix && text.starts_with(prefix))
+            text.erase(0, 1);
+
+        result.insert(text);
+    }
+
+    return  result;
+}
+
+void    Cache::notifyObjectCompiled(llvm::Module const* module, llvm::MemoryBufferRef object)
+{
+    //  written aside and renamed, runs sharing the directory never read half an object
+    auto    path    = m_dir / (module->getModuleIdentifier() + ".o");
+    auto    temp    = path;
+    temp    += ".tmp" + std::to_string(llvm::sys::Process::getProcessId());
+
+    {
+        std::ofstream   os(temp, std::ios::binary);
+        os.write(object.getBufferStart(), object.getBufferSize());
+
+        if(!os)
+        {
+            std::error_code error;
+            std::filesystem::remove(temp, error);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+
+    evict();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> Cache::getObject(llvm::Module const* module)
+{
+    return  load(module->getModuleIdentifier());
+}
+
+void    Cache::evict()
+{
+    struct Entry
+    {
+        std::filesystem::path           path;
+        std::filesystem::file_time_type time;
+        size_t                          size;
+    };
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::vector<Entry>  entries;
+    size_t              total   = 0;
+    std::error_code     error;
+
+    for(auto& entry: std::filesystem::directory_iterator(m_dir, error))
+    {
+        if(!entry.is_regular_file(error) || entry.path().extension() != ".o")
+            continue;
+
+        entries.push_back({entry.path(), entry.last_write_time(error), entry.file_size(error)});
+        total   += entries.back().size;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](Entry const& lhs, Entry const& rhs) {return lhs.time < rhs.time;});
+
+    for(auto& entry: entries)
+    {
+        if(total <= m_limit)
+            break;
+
+        if(std::filesystem::remove(entry.path, error))
+            total   -= entry.size;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+#include "options.hpp"
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+/*
+ *  Cache keeps the objects the JIT compiles in a directory between runs, one
+ *  "<key>.o" per module.  The key hashes everything the object depends on:
+ *  the spec source with line endings and trailing blanks normalized, the
+ *  options that change the generated code, the referee and LLVM versions and
+ *  the host CPU and its features.  A module is looked up by its identifier,
+ *  which Referee::check sets to the key, and a part number when the module
+ *  is split to be compiled concurrently.
+ *
+ *  Once the directory outgrows its limit the least recently used objects are
+ *  removed; a hit refreshes the modification time of its object.
+ */
+class Cache : public llvm::ObjectCache
+{
+public:
+    Cache(std::string const& dir, size_t limit);
+
+    static std::string  key(std::string const& source, Options const& options);
+
+    //  the object stored under key, nullptr if there is none
+    std::unique_ptr<llvm::MemoryBuffer> load(std::string const& key);
+
+    //  defined symbols of an object, without the global prefix
+    static std::set<std::string>        symbols(llvm::MemoryBuffer const& object, char prefix);
+
+    void    notifyObjectCompiled(llvm::Module const* module, llvm::MemoryBufferRef object) override;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(llvm::Module const* module) override;
+
+private:
+    void    evict();
+
+    std::filesystem::path   m_dir;
+    size_t                  m_limit;
+    std::mutex              m_lock;     //  parts are compiled, and stored, concurrently
+};
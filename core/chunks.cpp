@@ -0,0 +1,167 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "chunks.hpp"
+#include "pool.hpp"
+
+#include <algorithm>
+#include <vector>
+
+Chunks::Chunks(func_t func, int64_t const* horizon, uint8_t const* seams)
+    : m_func(func)
+    , m_horizon(horizon)
+    , m_seams(seams)
+{
+}
+
+bool    Chunks::run(Pool& pool, char* frst, size_t size, size_t rowSize, void* conf, size_t chunk) const
+{
+    auto    rows    = int64_t(size);
+    auto    step    = int64_t(std::max<size_t>(chunk, 1));
+    auto    count   = rows > 0 ? (rows + step - 1) / step : 1;
+    auto    ahead   = m_horizon[0];
+    auto    next    = m_horizon[1];
+    auto    back    = m_horizon[2];
+    auto    prev    = m_horizon[3];
+    auto    seams   = size_t(m_horizon[4]);
+
+    auto    time    = [&](int64_t k) {return *reinterpret_cast<int64_t const*>(frst + k * rowSize);};
+
+    //  first row from k on at or after t, rows + 1 if none
+    auto    after   = [&](int64_t k, int64_t t)
+    {
+        auto    hi  = rows + 1;
+
+        while(k < hi)
+        {
+            auto    mid = k + (hi - k) / 2;
+
+            if(time(mid) < t)
+                k   = mid + 1;
+            else
+                hi  = mid;
+        }
+
+        return  k;
+    };
+
+    //  last row up to k at or before t, 0 if none
+    auto    before  = [&](int64_t k, int64_t t)
+    {
+        auto    lo  = int64_t(0);
+
+        while(lo < k)
+        {
+            auto    mid = k - (k - lo) / 2;
+
+            if(time(mid) <= t)
+                lo  = mid;
+            else
+                k   = mid - 1;
+        }
+
+        return  lo;
+    };
+
+    //  the window [beg, end] holds the chunk [lo, hi), the rows its horizon
+    //  reaches and one more row on either side for the lengths of the edge
+    //  rows, nothing is read past the sentinels
+    struct  Span
+    {
+        int64_t beg;
+        int64_t end;
+        int64_t lo;
+        int64_t hi;
+    };
+
+    std::vector<Span>   spans(count);
+    for(int64_t j = 0; j < count; j++)
+    {
+        auto&   span    = spans[j];
+
+        span.lo     = 1 + j * step;
+        span.hi     = std::min(span.lo + step, rows + 1);
+        span.end    = span.hi - 1;
+        span.beg    = span.lo;
+
+        //  rows sharing a time stamp all count, hence the + 1 and - 1
+        for(int64_t i = 0; i <= next; i++)
+            span.end    = std::min(after(span.end, time(span.end) + ahead + 1) + (i < next), rows + 1);
+
+        for(int64_t i = 0; i <= prev; i++)
+            span.beg    = std::max(before(span.beg, time(span.beg) - back - 1) - (i < prev), int64_t(0));
+
+        span.end    = std::min(span.end + 2, rows + 1);
+        span.beg    = std::max(span.beg - 2, int64_t(0));
+    }
+
+    std::vector<uint8_t>    carry(count * seams);
+    std::vector<uint8_t>    summary(count * seams * 2);
+    std::vector<char>       results(count);
+
+    auto    depth   = 0;
+    for(size_t i = 0; i < seams; i++)
+        depth   = std::max(depth, (m_seams[i] >> 1) + 1);
+
+    for(auto round = 0; ; round++)
+    {
+        pool.run(count, [&](size_t j) {
+            auto&   span    = spans[j];
+
+            results[j]  = m_func(
+                            frst + span.beg * rowSize,
+                            frst + span.end * rowSize,
+                            conf,
+                            span.lo - span.beg,
+                            span.hi - span.beg,
+                            carry.data() + j * seams,
+                            summary.data() + j * seams * 2);
+        });
+
+        if(round == depth)
+            break;
+
+        //  a chunk that does not decide a seam passes on what it got
+        for(size_t i = 0; i < seams; i++)
+        {
+            if((m_seams[i] >> 1) != round)
+                continue;
+
+            auto    decided = [&](int64_t j) {return summary[(j * seams + i) * 2 + 1] != 0;};
+            auto    value   = [&](int64_t j) {return summary[(j * seams + i) * 2 + 0];};
+
+            if(m_seams[i] & 1)
+            {
+                for(int64_t j = 1; j < count; j++)
+                    carry[j * seams + i]    = decided(j - 1) ? value(j - 1) : carry[(j - 1) * seams + i];
+            }
+            else
+            {
+                for(int64_t j = count - 2; j >= 0; j--)
+                    carry[j * seams + i]    = decided(j + 1) ? value(j + 1) : carry[(j + 1) * seams + i];
+            }
+        }
+    }
+
+    return  std::all_of(results.begin(), results.end(), [](char result) {return result != 0;});
+}
@@ -0,0 +1,62 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class Pool;
+
+/*
+ *  Chunks checks G(expr) over one trace by splitting its rows into chunks
+ *  that are evaluated in parallel.  Each chunk runs "<name>.chunk", see
+ *  Compile, on a window of the trace that extends past the chunk by the
+ *  horizon of expr: the time and the number of rows its bounded operators
+ *  look ahead and back.
+ *
+ *  An untimed U/R/S/T may depend on any row up to the end (start) of the
+ *  trace, so it is a seam instead: every chunk resolves it up to its own
+ *  edge from the verdict carried in across that edge and summarizes what
+ *  its neighbour needs, its verdict at the edge row and whether that was
+ *  decided inside the chunk.  Seams nested d deep are stitched after round
+ *  d, one sequential pass over the summaries, and the chunks run again
+ *  with the new carries; the verdicts of the last round are exact.
+ */
+class Chunks
+{
+public:
+    using   func_t  = bool (*)(void* frst, void* last, void* conf, int64_t lo, int64_t hi, uint8_t const* carry, uint8_t* summary);
+
+    //  horizon is "<name>.horizon" and seams is "<name>.seams"
+    Chunks(func_t func, int64_t const* horizon, uint8_t const* seams);
+
+    //  checks rows 1 .. size of the rowSize bytes wide rows at frst, rows 0
+    //  and size + 1 being the sentinels, in chunks of chunk rows
+    bool    run(Pool& pool, char* frst, size_t size, size_t rowSize, void* conf, size_t chunk) const;
+
+private:
+    func_t          m_func;
+    int64_t const*  m_horizon;
+    uint8_t const*  m_seams;
+};
@@ -28,9 +28,12 @@
 
 #include <tuple>
 #include <map>
+#include <mutex>
 #include <iostream>
 
 
+//  hash-consing of T by its constructor arguments; Referee::monitor parses a
+//  reloaded file on a thread of its own, so each table is locked while used
 template<typename T>
 class Factory
 {
@@ -38,6 +41,10 @@ public:
     template<typename ... Args>
     static T*  create(Args ... args)
     {
+        static std::recursive_mutex lock;   //  one per table, a T may create another T
+
+        std::lock_guard<std::recursive_mutex>   guard(lock);
+
         auto    key = std::tuple<Args...>(args...);
         auto&   obj = get<decltype(key), T>(key);
 
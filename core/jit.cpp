@@ -0,0 +1,203 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "jit.hpp"
+#include "monitor.hpp"
+#include "report.hpp"
+
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/TargetRegistry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+//  LCOV_EXCL_START 
+//  GCOV_EXCL_START 
+extern "C"
+void    debug(int64_t value)
+{
+    printf("debug: %lld\n", (long long)value);
+}
+//  GCOV_EXCL_STOP
+//  LCOV_EXCL_STOP
+
+//  LCOV_EXCL_START 
+//  GCOV_EXCL_START 
+//  a stub whose function can't be compiled lands here
+static void lazyCallThroughError()
+{
+    fprintf(stderr, "referee: a lazily compiled function could not be materialized\n");
+    abort();
+}
+//  GCOV_EXCL_STOP
+//  LCOV_EXCL_STOP
+
+//  the ConcurrentIRCompiler, timed as the "codegen" phase of the Report
+class TimedIRCompiler : public llvm::orc::IRCompileLayer::IRCompiler
+{
+public:
+    TimedIRCompiler(std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler> compiler)
+        : IRCompiler(compiler->getManglingOptions())
+        , m_compiler(std::move(compiler))
+    {
+    }
+
+    llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(llvm::Module& M) override
+    {
+        Report::Scope   scope("codegen");
+
+        return  (*m_compiler)(M);
+    }
+
+private:
+    std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>  m_compiler;
+};
+
+RefereeJIT::RefereeJIT(
+        std::unique_ptr<llvm::orc::ExecutionSession>    ES,
+        llvm::orc::JITTargetMachineBuilder              JTMB, 
+        llvm::DataLayout                                DL,
+        std::unique_ptr<llvm::orc::LazyCallThroughManager>  LCTMgr,
+        llvm::ObjectCache*                              cache)
+    : ES(std::move(ES))
+    , DL(std::move(DL))
+    , Mangle(*this->ES, this->DL)
+    , ObjectLayer(*this->ES,[]() { return std::make_unique<llvm::SectionMemoryManager>(); })
+    , CompileLayer(*this->ES, ObjectLayer, std::make_unique<TimedIRCompiler>(std::make_unique<llvm::orc::ConcurrentIRCompiler>(JTMB, cache)))
+    , TransformLayer(*this->ES, CompileLayer)
+    , LCTMgr(std::move(LCTMgr))
+    , CODLayer(*this->ES, TransformLayer, *this->LCTMgr, llvm::orc::createLocalIndirectStubsManagerBuilder(JTMB.getTargetTriple()))
+    , MainJD(this->ES->createBareJITDylib("<main>")) 
+    , JTMB(std::move(JTMB))
+{
+    //  partitions of a lazy module share its context, the lock keeps them
+    //  from being optimized at the same time
+    TransformLayer.setTransform([this](llvm::orc::ThreadSafeModule TSM, llvm::orc::MaterializationResponsibility const&) {
+        TSM.withModuleDo([this](llvm::Module& M) {
+            if(Optimize)
+                Optimize(M);
+
+            for(auto& func: M.functions())
+                Compiled   += !func.isDeclaration();
+        });
+        return  llvm::Expected<llvm::orc::ThreadSafeModule>(std::move(TSM));
+    });
+
+    llvm::ExitOnError()(MainJD.define(
+        llvm::orc::absoluteSymbols(llvm::orc::SymbolMap{
+            { Mangle("debug"), llvm::JITEvaluatedSymbol::fromPointer(&debug)},
+            { Mangle("referee_window_push"), llvm::JITEvaluatedSymbol::fromPointer(&referee_window_push)},
+            { Mangle("referee_window_pop"),  llvm::JITEvaluatedSymbol::fromPointer(&referee_window_pop)},
+            { Mangle("referee_window_free"), llvm::JITEvaluatedSymbol::fromPointer(&referee_window_free)}})));
+
+    MainJD.addGenerator(cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(this->DL.getGlobalPrefix())));
+}
+
+RefereeJIT::~RefereeJIT() 
+{
+    if (auto Err = ES->endSession())
+    {
+        ES->reportError(std::move(Err));
+    }
+}
+
+llvm::Expected<llvm::orc::JITTargetMachineBuilder> RefereeJIT::target(std::string const& cpu, std::string const& features)
+{
+    auto    JTMB    = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!JTMB)
+        return JTMB.takeError();
+
+    //  host features would outvote an older cpu asked for, it brings its own
+    if (!cpu.empty() && cpu != "native")
+    {
+        JTMB->setCPU(cpu);
+        JTMB->setFeatures("");
+    }
+
+    auto    added   = llvm::SubtargetFeatures(features);
+    for(auto& feature: added.getFeatures())
+    {
+        JTMB->getFeatures().AddFeature(feature);
+    }
+
+    //  asked before a TargetMachine is made for it, that one only warns
+    std::string error;
+    auto    target  = llvm::TargetRegistry::lookupTarget(JTMB->getTargetTriple().str(), error);
+    if (!target)
+        throw std::runtime_error(error);
+
+    auto    info    = std::unique_ptr<llvm::MCSubtargetInfo>(target->createMCSubtargetInfo(JTMB->getTargetTriple().str(), "", ""));
+    if (!info->isCPUStringValid(JTMB->getCPU()))
+    {
+        throw std::runtime_error("cpu '" + cpu + "' is not known to " + JTMB->getTargetTriple().str());
+    }
+
+    return  JTMB;
+}
+
+llvm::Expected<std::unique_ptr<RefereeJIT>> RefereeJIT::Create(llvm::ObjectCache* cache, std::string const& cpu, std::string const& features) 
+{
+    auto EPC = llvm::orc::SelfExecutorProcessControl::Create();
+    if (!EPC)
+        return EPC.takeError();
+
+    auto    ES     = std::make_unique<llvm::orc::ExecutionSession>(std::move(*EPC));
+    auto    JTMB   = target(cpu, features);
+    if (!JTMB)
+        return JTMB.takeError();
+
+    auto    DL     = JTMB->getDefaultDataLayoutForTarget();
+    
+    if (!DL)
+        return DL.takeError();
+
+    auto    LCTMgr = llvm::orc::createLocalLazyCallThroughManager(JTMB->getTargetTriple(), *ES, llvm::pointerToJITTargetAddress(&lazyCallThroughError));
+    if (!LCTMgr)
+        return LCTMgr.takeError();
+
+    return std::make_unique<RefereeJIT>(std::move(ES), std::move(*JTMB), std::move(*DL), std::move(*LCTMgr), cache);
+}
+
+llvm::Error RefereeJIT::addModule(llvm::orc::ThreadSafeModule TSM, llvm::orc::ResourceTrackerSP RT)
+{
+    if (!RT)
+        RT = MainJD.getDefaultResourceTracker();
+    return TransformLayer.add(RT, std::move(TSM));
+}
+
+llvm::Error RefereeJIT::addLazyModule(llvm::orc::ThreadSafeModule TSM)
+{
+    return CODLayer.add(MainJD, std::move(TSM));
+}
+
+llvm::Error RefereeJIT::addObject(std::unique_ptr<llvm::MemoryBuffer> object)
+{
+    return ObjectLayer.add(MainJD, std::move(object));
+}
+
+llvm::Expected<llvm::JITEvaluatedSymbol>    RefereeJIT::lookup(llvm::StringRef Name)
+{
+    return ES->lookup({&MainJD}, Mangle(Name.str()));
+}
@@ -0,0 +1,109 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+extern "C"
+void    debug(int64_t value);
+
+class RefereeJIT 
+{
+private:
+    std::unique_ptr<llvm::orc::ExecutionSession>    ES;
+    llvm::DataLayout                                DL;
+    llvm::orc::MangleAndInterner                    Mangle;
+    llvm::orc::RTDyldObjectLinkingLayer             ObjectLayer;
+    llvm::orc::IRCompileLayer                       CompileLayer;
+    llvm::orc::IRTransformLayer                     TransformLayer;
+    std::unique_ptr<llvm::orc::LazyCallThroughManager>  LCTMgr;
+    llvm::orc::CompileOnDemandLayer                 CODLayer;
+    llvm::orc::JITDylib&                            MainJD;
+    llvm::orc::JITTargetMachineBuilder              JTMB;
+
+    std::function<void(llvm::Module&)>              Optimize;
+    std::atomic<size_t>                             Compiled{0};
+
+public:
+    RefereeJIT(
+            std::unique_ptr<llvm::orc::ExecutionSession>    ES,
+            llvm::orc::JITTargetMachineBuilder              JTMB, 
+            llvm::DataLayout                                DL,
+            std::unique_ptr<llvm::orc::LazyCallThroughManager>  LCTMgr,
+            llvm::ObjectCache*                              cache = nullptr);
+    ~RefereeJIT();
+
+    //  with a cache, compiled modules are looked up in and stored to it;
+    //  code is generated for the target of RefereeJIT::target(cpu, features)
+    static llvm::Expected<std::unique_ptr<RefereeJIT>> Create(
+                                                llvm::ObjectCache*  cache    = nullptr,
+                                                std::string const&  cpu      = "",
+                                                std::string const&  features = "");
+
+    //  the host, or `cpu` with its default features when given, plus `features`
+    //  as "+avx2,-avx512f"; throws for a cpu the target does not know
+    static llvm::Expected<llvm::orc::JITTargetMachineBuilder> target(std::string const& cpu, std::string const& features);
+
+    const llvm::DataLayout& getDataLayout() const   { return DL; }
+    const llvm::Triple&     getTargetTriple() const { return JTMB.getTargetTriple(); }
+    llvm::orc::JITDylib&    getMainJITDylib()       { return MainJD; }
+
+    //  a TargetMachine is not thread-safe, every concurrent user creates its own
+    llvm::Expected<std::unique_ptr<llvm::TargetMachine>>    createTargetMachine()   { return JTMB.createTargetMachine(); }
+
+    llvm::Error             addModule(llvm::orc::ThreadSafeModule TSM, llvm::orc::ResourceTrackerSP RT = nullptr);
+
+    //  every function of the module gets a stub and is optimized and compiled,
+    //  on its own, the first time it is called
+    llvm::Error             addLazyModule(llvm::orc::ThreadSafeModule TSM);
+
+    //  runs on each module, or function of a lazy one, right before codegen
+    void                    setOptimizer(std::function<void(llvm::Module&)> optimize)   { Optimize = std::move(optimize); }
+
+    //  functions compiled so far
+    size_t                  compiled() const        { return Compiled; }
+    llvm::Error             addObject(std::unique_ptr<llvm::MemoryBuffer> object);
+
+    llvm::Expected<llvm::JITEvaluatedSymbol>    lookup(llvm::StringRef Name);
+};
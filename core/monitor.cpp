@@ -0,0 +1,75 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "monitor.hpp"
+
+#include <deque>
+
+struct Window
+{
+    struct Row
+    {
+        int64_t t0;
+        int64_t t1;
+        bool    value;
+    };
+
+    std::deque<Row> rows;
+};
+
+extern "C"
+void    referee_window_push(void** window, int64_t t0, int64_t t1, bool value)
+{
+    if(*window == nullptr)
+        *window = new Window();
+
+    static_cast<Window*>(*window)->rows.push_back(Window::Row{t0, t1, value});
+}
+
+extern "C"
+void    referee_window_pop( void** window, int64_t bound, int64_t* t0, int64_t* t1, bool* value, bool* valid)
+{
+    if(*window == nullptr)
+        return;
+
+    auto&   rows    = static_cast<Window*>(*window)->rows;
+
+    while(!rows.empty() && rows.front().t0 < bound)
+    {
+        *t0     = rows.front().t0;
+        *t1     = rows.front().t1;
+        *value  = rows.front().value;
+        *valid  = true;
+
+        rows.pop_front();
+    }
+}
+
+extern "C"
+void    referee_window_free(void** window)
+{
+    delete static_cast<Window*>(*window);
+
+    *window = nullptr;
+}
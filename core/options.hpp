@@ -0,0 +1,58 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//  how Compile::make lays out a sample, Trace fills the same layout
+enum class Layout
+{
+    pointers,   //  __prop_t rows hold __time__ and a pointer per prop
+    columns,    //  __prop_t rows hold __time__ only, props live in the __cols_t column arrays
+    values,     //  __prop_t rows hold boolean/integer/number/enum props by value, a pointer for the rest
+};
+
+struct Options
+{
+    bool    sweep   = true;     //  evaluate nested U/R/S/T for the whole trace in one pass
+    bool    bitset  = true;     //  resolve swept untimed U/R/S/T 64 rows at a time on packed words
+    bool    share   = true;     //  evaluate U/R/S/T nested in several functions once, see Compile::make
+    bool    monitor = false;    //  also emit init/step/done for G over past-time formulas
+    Layout  layout  = Layout::pointers;
+    unsigned jobs   = 0;        //  threads check evaluates specs on, 0 - one per hardware thread
+    size_t  chunk   = 0;        //  rows per chunk check splits a G(...) spec into, 0 - whole trace
+    bool    witness = false;    //  failing functions report the sample they failed at, see Compile::make
+    unsigned optLevel = 2;      //  -O level of the PassBuilder pipeline the module is optimized with, 0..3
+    std::string cache;          //  directory check keeps compiled objects in, empty - no cache
+    size_t  cacheSize = size_t(256) << 20;  //  bytes the cache directory is trimmed to
+    bool    lazy    = true;     //  check compiles a function the first time it is called, false - all up front
+    std::vector<unsigned> lines;//  lines of the exprs and specs check runs, empty - all of them
+    std::string cpu;            //  cpu code is generated and tuned for, empty - the host
+    std::string features;       //  target features added to those of the cpu, as "+avx2,-avx512f"
+    bool    specialize = false; //  check folds the conf values it loads into the functions, see Compile::specialize
+    std::string watch;          //  .ref file monitor reloads the specs from when it changes, empty - none
+};
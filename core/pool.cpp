@@ -0,0 +1,197 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct  Pool::Impl
+{
+    struct  Queue
+    {
+        std::mutex          lock;
+        std::deque<size_t>  tasks;
+    };
+
+    Impl(unsigned workers);
+    ~Impl();
+
+    bool    take(unsigned self, size_t& task);
+    void    work(unsigned self);
+    void    loop(unsigned self);
+
+    std::vector<Queue>          m_queues;
+    std::vector<std::thread>    m_threads;
+
+    std::mutex                  m_lock;
+    std::condition_variable     m_wake;
+    std::condition_variable     m_done;
+    size_t                      m_batch     = 0;
+    bool                        m_stop      = false;
+
+    std::function<void(size_t)> const*  m_task  = nullptr;
+    std::atomic<size_t>         m_pending   = 0;
+};
+
+Pool::Impl::Impl(unsigned workers)
+    : m_queues(std::max(1u, workers))
+{
+    //  worker 0 is whoever calls run
+    for(unsigned i = 1; i < m_queues.size(); i++)
+    {
+        m_threads.emplace_back(&Impl::loop, this, i);
+    }
+}
+
+Pool::Impl::~Impl()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop  = true;
+    }
+    m_wake.notify_all();
+
+    for(auto& thread: m_threads)
+    {
+        thread.join();
+    }
+}
+
+bool    Pool::Impl::take(unsigned self, size_t& task)
+{
+    {
+        auto&   own = m_queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+
+        if(!own.tasks.empty())
+        {
+            task    = own.tasks.back();
+            own.tasks.pop_back();
+            return  true;
+        }
+    }
+
+    for(size_t i = 1; i < m_queues.size(); i++)
+    {
+        auto&   other   = m_queues[(self + i) % m_queues.size()];
+        std::lock_guard<std::mutex> guard(other.lock);
+
+        if(!other.tasks.empty())
+        {
+            task    = other.tasks.front();
+            other.tasks.pop_front();
+            return  true;
+        }
+    }
+
+    return  false;
+}
+
+void    Pool::Impl::work(unsigned self)
+{
+    size_t  task;
+
+    while(take(self, task))
+    {
+        (*m_task)(task);
+
+        if(--m_pending == 0)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_done.notify_all();
+        }
+    }
+}
+
+void    Pool::Impl::loop(unsigned self)
+{
+    size_t  seen    = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex>    guard(m_lock);
+            m_wake.wait(guard, [&]() {return m_stop || m_batch != seen;});
+
+            if(m_stop)
+                return;
+
+            seen    = m_batch;
+        }
+
+        work(self);
+    }
+}
+
+Pool::Pool(unsigned workers)
+    : m_impl(std::make_unique<Impl>(workers ? workers : std::max(1u, std::thread::hardware_concurrency())))
+{
+}
+
+Pool::~Pool()
+{
+}
+
+unsigned    Pool::size() const
+{
+    return  m_impl->m_queues.size();
+}
+
+void    Pool::run(size_t count, std::function<void(size_t)> const& task)
+{
+    if(count == 0)
+        return;
+
+    auto&   queues  = m_impl->m_queues;
+
+    //  the task is published before any index becomes visible in a queue
+    m_impl->m_task      = &task;
+    m_impl->m_pending   = count;
+
+    for(size_t i = 0; i < queues.size(); i++)
+    {
+        std::lock_guard<std::mutex> guard(queues[i].lock);
+
+        for(size_t j = count * i / queues.size(); j < count * (i + 1) / queues.size(); j++)
+        {
+            queues[i].tasks.push_back(j);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_impl->m_lock);
+        m_impl->m_batch++;
+    }
+    m_impl->m_wake.notify_all();
+
+    m_impl->work(0);
+
+    std::unique_lock<std::mutex>    guard(m_impl->m_lock);
+    m_impl->m_done.wait(guard, [&]() {return m_impl->m_pending == 0;});
+}
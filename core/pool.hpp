@@ -0,0 +1,52 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+/*
+ *  Pool runs batches of independent tasks on a fixed set of workers, the
+ *  calling thread being one of them.  A batch of count tasks is split into
+ *  contiguous slices, one per worker deque; a worker pops from the back of
+ *  its own deque and, once that is empty, steals from the front of the
+ *  others'.  Tasks may differ in cost by orders of magnitude (specs do), the
+ *  stealing keeps every worker busy until the batch runs dry.
+ */
+class Pool
+{
+public:
+    explicit Pool(unsigned workers = 0);    //  0 - one per hardware thread
+    ~Pool();
+
+    unsigned    size() const;
+
+    //  calls task(i) for i in 0 .. count - 1 and returns once all are done
+    void        run(size_t count, std::function<void(size_t)> const& task);
+
+private:
+    struct  Impl;
+    std::unique_ptr<Impl>   m_impl;
+};
@@ -0,0 +1,326 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "report.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <vector>
+
+//  allocations of the thread so far while the report is enabled, counted by
+//  Report::allocated; constant initialized, so counting needs no guard of its own
+static thread_local size_t  allocations = 0;
+
+namespace
+{
+    struct Times
+    {
+        int64_t     wall    = 0;
+        int64_t     cpu     = 0;
+        size_t      allocs  = 0;
+        size_t      calls   = 0;
+    };
+
+    struct Sizes
+    {
+        size_t      nodes   = 0;
+        size_t      blocks  = 0;
+        size_t      insts   = 0;
+        size_t      optBlocks   = 0;
+        size_t      optInsts    = 0;
+        bool        optimized   = false;
+    };
+
+    struct Function
+    {
+        Times       times;
+        Sizes       sizes;
+    };
+
+    //  both keep the order phases and functions were first seen in
+    template<typename T>
+    struct Ordered
+    {
+        T&  operator[](std::string const& key)
+        {
+            auto    found   = index.find(key);
+            if(found == index.end())
+            {
+                found   = index.emplace(key, items.size()).first;
+                items.emplace_back(key, T{});
+            }
+            return  items[found->second].second;
+        }
+
+        std::map<std::string, size_t>               index;
+        std::vector<std::pair<std::string, T>>      items;
+    };
+
+    std::atomic<bool>   on      = false;
+    std::mutex          lock;
+    Ordered<Times>      phases;
+    Ordered<Function>   functions;
+
+    //  the phase of the innermost scope of the thread
+    thread_local std::string    current;
+
+    int64_t     wall()
+    {
+        return  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int64_t     cpu()
+    {
+        timespec    ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+        return  int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    double      ms(int64_t ns)
+    {
+        return  ns / 1e6;
+    }
+
+    //  a JSON string, control characters as \u00XX
+    std::string jsonString(std::string const& text)
+    {
+        std::string result  = "\"";
+        for(unsigned char c: text)
+        {
+            if(c < 0x20)
+            {
+                char    escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                result  += escaped;
+                continue;
+            }
+            if(c == '"' || c == '\\')
+                result  += '\\';
+            result  += char(c);
+        }
+        return  result + "\"";
+    }
+}
+
+Report::Scope::Scope(char const* phase, std::string function)
+    : m_active(on.load(std::memory_order_relaxed))
+{
+    if(!m_active)
+        return;
+
+    m_outer     = current;
+    m_phase     = current.empty() ? phase : current + "/" + phase;
+    m_function  = std::move(function);
+    current     = m_phase;
+
+    {
+        //  registered here rather than when done, so a phase precedes those it encloses
+        std::lock_guard<std::mutex> guard(lock);
+        phases[m_phase];
+    }
+
+    m_allocs    = allocations;
+    m_cpu       = cpu();
+    m_wall      = wall();
+}
+
+Report::Scope::~Scope()
+{
+    if(!m_active)
+        return;
+
+    auto    dwall   = wall() - m_wall;
+    auto    dcpu    = cpu() - m_cpu;
+    auto    dallocs = allocations - m_allocs;
+
+    current = m_outer;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto    add     = [&](Times& times)
+    {
+        times.wall      += dwall;
+        times.cpu       += dcpu;
+        times.allocs    += dallocs;
+        times.calls     += 1;
+    };
+
+    add(phases[m_phase]);
+    if(!m_function.empty())
+        add(functions[m_function].times);
+}
+
+void    Report::allocated()
+{
+    if(on.load(std::memory_order_relaxed))
+        allocations++;
+}
+
+void    Report::enable(bool enable)
+{
+    on  = enable;
+}
+
+bool    Report::enabled()
+{
+    return  on.load(std::memory_order_relaxed);
+}
+
+void    Report::reset()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    phases      = {};
+    functions   = {};
+}
+
+void    Report::emitted(std::string const& function, size_t nodes, size_t blocks, size_t insts)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto&   sizes   = functions[function].sizes;
+    sizes.nodes     = nodes;
+    sizes.blocks    = blocks;
+    sizes.insts     = insts;
+}
+
+void    Report::optimized(std::string const& function, size_t blocks, size_t insts)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto&   sizes   = functions[function].sizes;
+    sizes.optBlocks = blocks;
+    sizes.optInsts  = insts;
+    sizes.optimized = true;
+}
+
+void    Report::print(std::ostream& os, bool json)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Sizes   total;
+    for(auto& [name, function]: functions.items)
+    {
+        total.nodes     += function.sizes.nodes;
+        total.blocks    += function.sizes.blocks;
+        total.insts     += function.sizes.insts;
+        total.optBlocks += function.sizes.optBlocks;
+        total.optInsts  += function.sizes.optInsts;
+    }
+
+    auto    flags   = os.flags();
+    auto    prec    = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    if(json)
+    {
+        os << "{\n  \"phases\": [";
+        auto    sep = "\n";
+        for(auto& [name, times]: phases.items)
+        {
+            os  << sep << "    {\"name\": " << jsonString(name)
+                << ", \"wall_ms\": " << ms(times.wall)
+                << ", \"cpu_ms\": " << ms(times.cpu)
+                << ", \"allocs\": " << times.allocs
+                << ", \"calls\": " << times.calls << "}";
+            sep = ",\n";
+        }
+        os << "\n  ],\n  \"functions\": [";
+        sep = "\n";
+        for(auto& [name, function]: functions.items)
+        {
+            auto&   times   = function.times;
+            auto&   sizes   = function.sizes;
+
+            os  << sep << "    {\"name\": " << jsonString(name)
+                << ", \"wall_ms\": " << ms(times.wall)
+                << ", \"cpu_ms\": " << ms(times.cpu)
+                << ", \"allocs\": " << times.allocs
+                << ", \"nodes\": " << sizes.nodes
+                << ", \"blocks\": " << sizes.blocks
+                << ", \"insts\": " << sizes.insts;
+            if(sizes.optimized)
+                os  << ", \"opt_blocks\": " << sizes.optBlocks
+                    << ", \"opt_insts\": " << sizes.optInsts;
+            os  << "}";
+            sep = ",\n";
+        }
+        os  << "\n  ],\n  \"totals\": {"
+            << "\"nodes\": " << total.nodes
+            << ", \"blocks\": " << total.blocks
+            << ", \"insts\": " << total.insts
+            << ", \"opt_blocks\": " << total.optBlocks
+            << ", \"opt_insts\": " << total.optInsts << "}\n}\n";
+    }
+    else
+    {
+        os  << std::left << std::setw(32) << "phase" << std::right
+            << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms"
+            << std::setw(12) << "allocs" << std::setw(8) << "calls" << "\n";
+        for(auto& [name, times]: phases.items)
+        {
+            //  nested phases are indented under the enclosing one
+            auto    depth   = std::count(name.begin(), name.end(), '/');
+            auto    last    = name.substr(name.rfind('/') + 1);
+
+            os  << std::left << std::setw(32) << std::string(2 * depth, ' ') + last << std::right
+                << std::setw(12) << ms(times.wall) << std::setw(12) << ms(times.cpu)
+                << std::setw(12) << times.allocs << std::setw(8) << times.calls << "\n";
+        }
+
+        if(!functions.items.empty())
+        {
+            os  << "\n" << std::left << std::setw(32) << "function" << std::right
+                << std::setw(12) << "wall ms" << std::setw(12) << "allocs"
+                << std::setw(8) << "nodes" << std::setw(8) << "blocks" << std::setw(8) << "insts"
+                << std::setw(12) << "opt blocks" << std::setw(10) << "opt insts" << "\n";
+            for(auto& [name, function]: functions.items)
+            {
+                auto&   times   = function.times;
+                auto&   sizes   = function.sizes;
+
+                os  << std::left << std::setw(32) << name << std::right
+                    << std::setw(12) << ms(times.wall) << std::setw(12) << times.allocs
+                    << std::setw(8) << sizes.nodes << std::setw(8) << sizes.blocks << std::setw(8) << sizes.insts;
+                if(sizes.optimized)
+                    os  << std::setw(12) << sizes.optBlocks << std::setw(10) << sizes.optInsts;
+                os  << "\n";
+            }
+            os  << std::left << std::setw(32) << "total" << std::right
+                << std::setw(24) << ""
+                << std::setw(8) << total.nodes << std::setw(8) << total.blocks << std::setw(8) << total.insts
+                << std::setw(12) << total.optBlocks << std::setw(10) << total.optInsts << "\n";
+        }
+    }
+
+    os.flags(flags);
+    os.precision(prec);
+}
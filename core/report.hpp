@@ -0,0 +1,87 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+ *  Report collects where the time of a run goes, for --time-report.  Each
+ *  phase is timed by a Scope that lives as long as the phase: wall time, the
+ *  CPU time of its thread and the allocations it made.  Scopes nest within a
+ *  thread, the phase "typecalc" inside "function" inside "build" is reported
+ *  as "build/function/typecalc"; scopes of different threads add up in the
+ *  phase of the same name, so the CPU time of a phase run concurrently can
+ *  exceed its wall time.  A scope given a function is charged to it as well.
+ *
+ *  Next to the times, the sizes of each function: the AST nodes it was built
+ *  from and the basic blocks and instructions emitted, before and after the
+ *  optimizer.
+ *
+ *  Allocations are only known where the executable tells Report about them,
+ *  referee does from its operators new (see alloc.cpp), elsewhere they read 0.
+ *
+ *  Nothing is recorded until the report is enabled, a disabled Scope costs
+ *  a load and a branch.
+ */
+class Report
+{
+public:
+    class Scope
+    {
+    public:
+        Scope(char const* phase, std::string function = "");
+        ~Scope();
+
+        Scope(Scope const&)             = delete;
+        Scope&  operator=(Scope const&) = delete;
+
+    private:
+        bool            m_active;
+        std::string     m_outer;    //  the phase of the enclosing scope
+        std::string     m_phase;
+        std::string     m_function;
+        int64_t         m_wall;     //  ns
+        int64_t         m_cpu;      //  ns
+        size_t          m_allocs;
+    };
+
+    //  one more allocation of the calling thread, ignored unless enabled
+    static void     allocated();
+
+    static void     enable(bool on = true);
+    static bool     enabled();
+    static void     reset();
+
+    //  `function` as emitted, from `nodes` distinct AST nodes
+    static void     emitted(std::string const& function, size_t nodes, size_t blocks, size_t insts);
+
+    //  `function` as the optimizer left it
+    static void     optimized(std::string const& function, size_t blocks, size_t insts);
+
+    //  a table of the phases and the functions, or the same as a JSON object
+    static void     print(std::ostream& os, bool json = false);
+};
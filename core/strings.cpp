@@ -25,6 +25,7 @@
 #include "strings.hpp"
 
 #include <memory>
+#include <mutex>
 #include <string.h>
 
 struct cstrless {
@@ -41,6 +42,7 @@ public:
     char const* getString(char const* data) override;
 
 private:
+    std::mutex                      m_lock; //  trace decoding and a reload may intern at once
     std::set<const char*, cstrless> m_set;
 };
 
@@ -51,6 +53,8 @@ char const* Strings::getString(std::string const& data)
 
 char const* StringsImpl::getString(char const* data)
 {
+    std::lock_guard<std::mutex> guard(m_lock);
+
     auto iter = m_set.find(data);
 
     if(iter == m_set.end())
@@ -0,0 +1,759 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "trace.hpp"
+#include "strings.hpp"
+#include "visitors/csvHeaders.hpp"
+#include "../rdb/database.hpp"
+
+#include "rapidcsv.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <vector>
+
+class Arena
+{
+public:
+    char*   alloc(size_t size)
+    {
+        size    = (size + 7) & ~size_t(7);
+
+        if(m_used + size > m_size)
+        {
+            m_size  = std::max(size, s_chunk);
+            m_used  = 0;
+            m_chunks.push_back(std::make_unique<char[]>(m_size));
+            std::memset(m_chunks.back().get(), 0, m_size);
+        }
+
+        auto    result  = m_chunks.back().get() + m_used;
+        m_used += size;
+
+        return  result;
+    }
+
+private:
+    static constexpr size_t s_chunk = 1 << 20;
+
+    std::vector<std::unique_ptr<char[]>>    m_chunks;
+    size_t                                  m_size  = 0;
+    size_t                                  m_used  = 0;
+};
+
+struct Event
+{
+    int64_t     time;
+    unsigned    prop;
+    char*       data;
+};
+
+class Trace::Impl
+{
+public:
+    Impl(   Module*                 refmod,
+            llvm::DataLayout const& layout,
+            llvm::StructType*       propType,
+            llvm::StructType*       confType,
+            llvm::StructType*       colsType);
+
+    char*   alloc(llvm::Type* type);
+    llvm::Type* valueType(unsigned prop);
+    void    build(std::vector<Event>& events);
+    void    putRow(char* base, int64_t time, std::vector<char*> const& curr);
+    void    readRdb(std::string const& filename, std::function<char*(int64_t time, unsigned prop, llvm::Type* type)> event);
+
+    Module*                     m_refmod;
+    llvm::DataLayout            m_layout;
+    llvm::StructType*           m_propType;
+    llvm::StructType*           m_confType;
+    llvm::StructType*           m_colsType;
+    llvm::StructLayout const*   m_propLayout;
+    llvm::StructLayout const*   m_confLayout;
+    std::vector<std::string>    m_propNames;
+    std::vector<std::string>    m_confNames;
+    std::vector<char*>          m_defaults;
+    Arena                       m_arena;
+    std::vector<char>           m_rows;
+    size_t                      m_rowSize;
+    char*                       m_conf;
+    char*                       m_cols  = nullptr;
+    std::vector<std::vector<char>>
+                                m_columns;
+};
+
+struct DecodeDataImpl
+    : Visitor<  TypeInteger
+             ,  TypeNumber
+             ,  TypeString
+             ,  TypeBoolean
+             ,  TypeStruct
+             ,  TypeEnum
+             ,  TypeArray>
+{
+    DecodeDataImpl(
+            Trace::Impl*                trace,
+            referee::db::DataReader&    reader);
+
+    void    make(Type* type, llvm::Type* llvmType, char* dst);
+
+    void    visit(TypeInteger*          type) override;
+    void    visit(TypeNumber*           type) override;
+    void    visit(TypeString*           type) override;
+    void    visit(TypeBoolean*          type) override;
+    void    visit(TypeStruct*           type) override;
+    void    visit(TypeEnum*             type) override;
+    void    visit(TypeArray*            type) override;
+
+private:
+    Trace::Impl*                m_trace;
+    referee::db::DataReader&    m_reader;
+    llvm::Type*                 m_type;
+    char*                       m_dst;
+};
+
+struct DecodeCsvImpl
+    : Visitor<  TypeInteger
+             ,  TypeNumber
+             ,  TypeString
+             ,  TypeBoolean
+             ,  TypeStruct
+             ,  TypeEnum
+             ,  TypeArray>
+{
+    DecodeCsvImpl(
+            Trace::Impl*                trace,
+            rapidcsv::Document&         doc,
+            size_t                      row);
+
+    void    make(Type* type, llvm::Type* llvmType, char* dst, std::string const& name);
+
+    void    visit(TypeInteger*          type) override;
+    void    visit(TypeNumber*           type) override;
+    void    visit(TypeString*           type) override;
+    void    visit(TypeBoolean*          type) override;
+    void    visit(TypeStruct*           type) override;
+    void    visit(TypeEnum*             type) override;
+    void    visit(TypeArray*            type) override;
+
+private:
+    std::string cell();
+
+    Trace::Impl*                m_trace;
+    rapidcsv::Document&         m_doc;
+    size_t                      m_row;
+    llvm::Type*                 m_type;
+    char*                       m_dst;
+    std::string                 m_name;
+};
+
+template<typename T>
+static void store(char* dst, T value)
+{
+    std::memcpy(dst, &value, sizeof(value));
+}
+
+DecodeDataImpl::DecodeDataImpl(
+            Trace::Impl*                trace,
+            referee::db::DataReader&    reader)
+    : m_trace(trace)
+    , m_reader(reader)
+{
+}
+
+void    DecodeDataImpl::make(Type* type, llvm::Type* llvmType, char* dst)
+{
+    auto    saveType    = m_type;
+    auto    saveDst     = m_dst;
+
+    m_type  = llvmType;
+    m_dst   = dst;
+
+    type->accept(*this);
+
+    m_type  = saveType;
+    m_dst   = saveDst;
+}
+
+void    DecodeDataImpl::visit(TypeInteger*          type)
+{
+    int64_t data;
+    m_reader.integer(data);
+    store(m_dst, data);
+}
+
+void    DecodeDataImpl::visit(TypeNumber*           type)
+{
+    double  data;
+    m_reader.number(data);
+    store(m_dst, data);
+}
+
+void    DecodeDataImpl::visit(TypeString*           type)
+{
+    std::string data;
+    m_reader.string(data);
+    store(m_dst, Strings::instance()->getString(data));
+}
+
+void    DecodeDataImpl::visit(TypeBoolean*          type)
+{
+    bool    data;
+    m_reader.boolean(data);
+    store(m_dst, uint8_t(data));
+}
+
+void    DecodeDataImpl::visit(TypeStruct*           type)
+{
+    auto    structType  = llvm::cast<llvm::StructType>(m_type);
+    auto    layout      = m_trace->m_layout.getStructLayout(structType);
+
+    for(unsigned i = 0; i < type->members.size(); i++)
+    {
+        make(type->members[i].data, structType->getElementType(i), m_dst + layout->getElementOffset(i));
+    }
+}
+
+void    DecodeDataImpl::visit(TypeEnum*             type)
+{
+    int64_t data;
+    m_reader.integer(data);
+    store(m_dst, uint8_t(data));
+}
+
+void    DecodeDataImpl::visit(TypeArray*            type)
+{
+    unsigned    size;
+    m_reader.size(size);
+
+    if(type->size != 0)
+    {
+        auto    arrayType   = llvm::cast<llvm::ArrayType>(m_type);
+        auto    elemType    = arrayType->getElementType();
+        auto    elemSize    = m_trace->m_layout.getTypeAllocSize(elemType);
+
+        if(size != type->size)
+        {
+            throw std::runtime_error("array size mismatch");
+        }
+
+        for(unsigned i = 0; i < size; i++)
+        {
+            make(type->type, elemType, m_dst + i * elemSize);
+        }
+    }
+    else
+    {
+        auto    structType  = llvm::cast<llvm::StructType>(m_type);
+        auto    layout      = m_trace->m_layout.getStructLayout(structType);
+        auto    elemType    = llvm::cast<llvm::PointerType>(structType->getElementType(1))->getPointerElementType();
+        auto    elemSize    = m_trace->m_layout.getTypeAllocSize(elemType);
+        auto    data        = m_trace->m_arena.alloc(elemSize * size);
+
+        for(unsigned i = 0; i < size; i++)
+        {
+            make(type->type, elemType, data + i * elemSize);
+        }
+
+        store(m_dst + layout->getElementOffset(0), uint16_t(size));
+        store(m_dst + layout->getElementOffset(1), data);
+    }
+}
+
+DecodeCsvImpl::DecodeCsvImpl(
+            Trace::Impl*                trace,
+            rapidcsv::Document&         doc,
+            size_t                      row)
+    : m_trace(trace)
+    , m_doc(doc)
+    , m_row(row)
+{
+}
+
+void    DecodeCsvImpl::make(Type* type, llvm::Type* llvmType, char* dst, std::string const& name)
+{
+    auto    saveType    = m_type;
+    auto    saveDst     = m_dst;
+    auto    saveName    = m_name;
+
+    m_type  = llvmType;
+    m_dst   = dst;
+    m_name  = name;
+
+    type->accept(*this);
+
+    m_type  = saveType;
+    m_dst   = saveDst;
+    m_name  = saveName;
+}
+
+std::string DecodeCsvImpl::cell()
+{
+    auto    data    = m_doc.GetCell<std::string>(m_name, m_row);
+
+    if(data.size() >= 2 && data.front() == '"' && data.back() == '"')
+    {
+        data    = data.substr(1, data.size() - 2);
+    }
+
+    return  data;
+}
+
+void    DecodeCsvImpl::visit(TypeInteger*           type)
+{
+    store(m_dst, int64_t(std::stoll(cell(), nullptr, 0)));
+}
+
+void    DecodeCsvImpl::visit(TypeNumber*            type)
+{
+    store(m_dst, std::stod(cell()));
+}
+
+void    DecodeCsvImpl::visit(TypeString*            type)
+{
+    store(m_dst, Strings::instance()->getString(cell()));
+}
+
+void    DecodeCsvImpl::visit(TypeBoolean*           type)
+{
+    auto    data    = cell();
+    bool    value   = false;
+
+    if(data == "true" || data == "yes" || data == "1")
+        value   = true;
+    else if(data == "false" || data == "no" || data == "0")
+        value   = false;
+    else
+        throw std::runtime_error("invalid boolean '" + data + "' in column " + m_name);
+
+    store(m_dst, uint8_t(value));
+}
+
+void    DecodeCsvImpl::visit(TypeStruct*            type)
+{
+    auto    structType  = llvm::cast<llvm::StructType>(m_type);
+    auto    layout      = m_trace->m_layout.getStructLayout(structType);
+
+    for(unsigned i = 0; i < type->members.size(); i++)
+    {
+        auto&   member  = type->members[i];
+
+        make(member.data, structType->getElementType(i), m_dst + layout->getElementOffset(i), m_name + "." + member.name);
+    }
+}
+
+void    DecodeCsvImpl::visit(TypeEnum*              type)
+{
+    auto    data    = cell();
+    auto    iter    = std::find(type->items.begin(), type->items.end(), data);
+
+    if(iter != type->items.end())
+    {
+        store(m_dst, uint8_t(type->index(data)));
+    }
+    else
+    {
+        store(m_dst, uint8_t(std::stoul(data, nullptr, 0)));
+    }
+}
+
+void    DecodeCsvImpl::visit(TypeArray*             type)
+{
+    if(type->size != 0)
+    {
+        auto    arrayType   = llvm::cast<llvm::ArrayType>(m_type);
+        auto    elemType    = arrayType->getElementType();
+        auto    elemSize    = m_trace->m_layout.getTypeAllocSize(elemType);
+
+        for(unsigned i = 0; i < type->size; i++)
+        {
+            make(type->type, elemType, m_dst + i * elemSize, m_name + "[" + std::to_string(i) + "]");
+        }
+    }
+    else
+    {
+        auto    size        = m_doc.GetCell<unsigned>(m_name + "#size", m_row);
+        auto    structType  = llvm::cast<llvm::StructType>(m_type);
+        auto    layout      = m_trace->m_layout.getStructLayout(structType);
+        auto    elemType    = llvm::cast<llvm::PointerType>(structType->getElementType(1))->getPointerElementType();
+        auto    elemSize    = m_trace->m_layout.getTypeAllocSize(elemType);
+        auto    data        = m_trace->m_arena.alloc(elemSize * size);
+
+        for(unsigned i = 0; i < size; i++)
+        {
+            make(type->type, elemType, data + i * elemSize, m_name + "[" + std::to_string(i) + "]");
+        }
+
+        store(m_dst + layout->getElementOffset(0), uint16_t(size));
+        store(m_dst + layout->getElementOffset(1), data);
+    }
+}
+
+Trace::Impl::Impl(
+            Module*                 refmod,
+            llvm::DataLayout const& layout,
+            llvm::StructType*       propType,
+            llvm::StructType*       confType,
+            llvm::StructType*       colsType)
+    : m_refmod(refmod)
+    , m_layout(layout)
+    , m_propType(propType)
+    , m_confType(confType)
+    , m_colsType(colsType)
+    , m_propLayout(layout.getStructLayout(propType))
+    , m_confLayout(layout.getStructLayout(confType))
+    , m_rowSize(layout.getTypeAllocSize(propType))
+{
+    for(auto name: refmod->getPropNames())
+    {
+        if(name != "__time__")
+            m_propNames.push_back(name);
+    }
+    m_confNames = refmod->getConfNames();
+
+    for(unsigned i = 0; i < m_propNames.size(); i++)
+    {
+        m_defaults.push_back(alloc(valueType(i)));
+    }
+
+    m_conf  = alloc(confType);
+
+    if(colsType)
+    {
+        m_cols  = alloc(colsType);
+        m_columns.resize(m_propNames.size());
+    }
+
+    std::vector<Event>  events;
+    build(events);
+}
+
+char*   Trace::Impl::alloc(llvm::Type* type)
+{
+    return  m_arena.alloc(m_layout.getTypeAllocSize(type));
+}
+
+llvm::Type* Trace::Impl::valueType(unsigned prop)
+{
+    auto    type    = m_colsType
+                    ? m_colsType->getElementType(prop)
+                    : m_propType->getElementType(prop + 1);
+
+    //  held by value in the row, see Layout::values
+    if(!type->isPointerTy())
+        return  type;
+
+    return  llvm::cast<llvm::PointerType>(type)->getPointerElementType();
+}
+
+void    Trace::Impl::build(std::vector<Event>& events)
+{
+    std::stable_sort(events.begin(), events.end(), [](Event const& lhs, Event const& rhs) {
+        return  lhs.time < rhs.time;
+    });
+
+    auto    curr    = m_defaults;
+    auto    count   = size_t(0);
+
+    for(size_t i = 0; i < events.size(); i++)
+    {
+        if(i == 0 || events[i].time != events[i - 1].time)
+            count++;
+    }
+
+    m_rows.assign((count + 2) * m_rowSize, 0);
+
+    auto    colsLayout  = m_colsType ? m_layout.getStructLayout(m_colsType) : nullptr;
+    for(unsigned i = 0; i < m_columns.size(); i++)
+    {
+        m_columns[i].assign((count + 2) * m_layout.getTypeAllocSize(valueType(i)), 0);
+        store(m_cols + colsLayout->getElementOffset(i), m_columns[i].data());
+    }
+
+    auto    putRow  = [&](size_t row, int64_t time) {
+        this->putRow(m_rows.data() + row * m_rowSize, time, curr);
+
+        for(unsigned i = 0; i < m_columns.size(); i++)
+        {
+            auto    size    = m_layout.getTypeAllocSize(valueType(i));
+            std::memcpy(m_columns[i].data() + row * size, curr[i], size);
+        }
+    };
+
+    auto    row     = size_t(0);
+    for(size_t i = 0; i < events.size(); )
+    {
+        auto    time    = events[i].time;
+
+        for(; i < events.size() && events[i].time == time; i++)
+        {
+            curr[events[i].prop]    = events[i].data;
+        }
+
+        if(row == 0)
+        {
+            putRow(row++, time - 1);    //  frst
+        }
+
+        putRow(row++, time);
+    }
+
+    if(row == 0)
+    {
+        putRow(row++, -1);              //  frst
+        putRow(row++, 0);               //  last
+    }
+    else
+    {
+        auto    time    = events.back().time;
+
+        putRow(row++, time + 1);        //  last
+    }
+}
+
+void    Trace::Impl::putRow(char* base, int64_t time, std::vector<char*> const& curr)
+{
+    store(base + m_propLayout->getElementOffset(0), time);
+
+    for(unsigned i = 0; i < curr.size() && !m_colsType; i++)
+    {
+        auto    type    = m_propType->getElementType(i + 1);
+
+        if(type->isPointerTy())
+            store(base + m_propLayout->getElementOffset(i + 1), curr[i]);
+        else
+            std::memcpy(base + m_propLayout->getElementOffset(i + 1), curr[i], m_layout.getTypeAllocSize(type));
+    }
+}
+
+//  decodes every pushed prop into the buffer event returns for it, in file order
+void    Trace::Impl::readRdb(std::string const& filename, std::function<char*(int64_t time, unsigned prop, llvm::Type* type)> event)
+{
+    referee::db::Reader     reader;
+    referee::db::RecordView record;
+    std::vector<int>        prop2indx   = {-1};
+    std::vector<int>        conf2indx   = {-1};
+
+    reader.open(filename);
+    reader.select(m_propNames);
+
+    while(reader.next(record))
+    {
+        switch(record.type)
+        {
+            case referee::db::DECL_PROP:
+            {
+                auto    iter    = std::find(m_propNames.begin(), m_propNames.end(), record.data);
+                prop2indx.push_back(iter == m_propNames.end() ? -1 : iter - m_propNames.begin());
+                break;
+            }
+            case referee::db::DECL_CONF:
+            {
+                auto    iter    = std::find(m_confNames.begin(), m_confNames.end(), record.data);
+                conf2indx.push_back(iter == m_confNames.end() ? -1 : iter - m_confNames.begin());
+                break;
+            }
+            case referee::db::PUSH_PROP:
+            {
+                if(record.indx >= prop2indx.size())
+                    throw std::runtime_error("undeclared prop in " + filename);
+
+                auto    indx    = prop2indx[record.indx];
+                if(indx < 0)
+                    break;
+
+                auto    type    = m_refmod->getProp(m_propNames[indx]);
+                auto    llvmType= valueType(indx);
+                auto    data    = event(int64_t(record.time), unsigned(indx), llvmType);
+
+                referee::db::DataReader reader(record.data);
+                DecodeDataImpl(this, reader).make(type, llvmType, data);
+                break;
+            }
+            case referee::db::PUSH_CONF:
+            {
+                if(record.indx >= conf2indx.size())
+                    throw std::runtime_error("undeclared conf in " + filename);
+
+                auto    indx    = conf2indx[record.indx];
+                if(indx < 0)
+                    break;
+
+                auto    type    = m_refmod->getConf(m_confNames[indx]);
+                auto    llvmType= m_confType->getElementType(indx);
+                auto    data    = m_conf + m_confLayout->getElementOffset(indx);
+
+                referee::db::DataReader reader(record.data);
+                DecodeDataImpl(this, reader).make(type, llvmType, data);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+Trace::Trace(
+            Module*                 refmod,
+            llvm::DataLayout const& layout,
+            llvm::StructType*       propType,
+            llvm::StructType*       confType,
+            llvm::StructType*       colsType)
+    : m_impl(std::make_unique<Impl>(refmod, layout, propType, confType, colsType))
+{
+}
+
+Trace::~Trace() = default;
+
+void    Trace::loadCsv(     std::string const&  filename)
+{
+    rapidcsv::Document  doc(filename, rapidcsv::LabelParams(0, -1), rapidcsv::SeparatorParams(',', true));
+    std::vector<Event>  events;
+
+    auto    rows    = doc.GetRowCount();
+    auto&   names   = m_impl->m_propNames;
+    auto    present = std::vector<bool>(names.size());
+
+    for(unsigned i = 0; i < names.size(); i++)
+    {
+        auto    headers = CsvHeaders::make(names[i], m_impl->m_refmod->getProp(names[i]));
+
+        present[i]  = doc.GetColumnIdx(headers.front()) >= 0;
+    }
+
+    for(size_t row = 0; row < rows; row++)
+    {
+        DecodeCsvImpl   decode(m_impl.get(), doc, row);
+        auto            time    = doc.GetCell<int64_t>("__time__", row);
+
+        for(unsigned i = 0; i < names.size(); i++)
+        {
+            if(!present[i])
+                continue;
+
+            auto    type    = m_impl->m_refmod->getProp(names[i]);
+            auto    llvmType= m_impl->valueType(i);
+            auto    data    = m_impl->alloc(llvmType);
+
+            decode.make(type, llvmType, data, names[i]);
+            events.push_back(Event{time, i, data});
+        }
+    }
+
+    m_impl->build(events);
+}
+
+void    Trace::loadRdb(     std::string const&  filename)
+{
+    std::vector<Event>  events;
+
+    m_impl->readRdb(filename, [&](int64_t time, unsigned prop, llvm::Type* type) {
+        auto    data    = m_impl->alloc(type);
+
+        events.push_back(Event{time, prop, data});
+
+        return  data;
+    });
+
+    m_impl->build(events);
+}
+
+void    Trace::streamRdb(   std::string const&  filename,
+                            std::function<void(void* curr)> const&  step)
+{
+    auto    curr    = m_impl->m_defaults;
+    auto    slots   = std::vector<char*>(curr.size(), nullptr);
+    auto    row     = std::vector<char>(m_impl->m_rowSize, 0);
+    auto    time    = int64_t(0);
+    auto    pending = false;
+
+    auto    flush   = [&]() {
+        m_impl->putRow(row.data(), time, curr);
+        step(row.data());
+    };
+
+    m_impl->readRdb(filename, [&](int64_t when, unsigned prop, llvm::Type* type) {
+        if(pending && when < time)
+            throw std::runtime_error("samples out of time order in " + filename);
+
+        if(pending && when != time)
+            flush();
+
+        if(slots[prop] == nullptr)
+            slots[prop] = m_impl->alloc(type);
+
+        curr[prop]  = slots[prop];
+        time        = when;
+        pending     = true;
+
+        return  slots[prop];
+    });
+
+    if(pending)
+        flush();
+}
+
+void    Trace::loadConf(    std::string const&  filename)
+{
+    rapidcsv::Document  doc(filename, rapidcsv::LabelParams(0, -1), rapidcsv::SeparatorParams(',', true));
+    DecodeCsvImpl       decode(m_impl.get(), doc, 0);
+
+    auto&   names   = m_impl->m_confNames;
+
+    for(unsigned i = 0; i < names.size(); i++)
+    {
+        auto    type    = m_impl->m_refmod->getConf(names[i]);
+        auto    llvmType= m_impl->m_confType->getElementType(i);
+        auto    data    = m_impl->m_conf + m_impl->m_confLayout->getElementOffset(i);
+
+        decode.make(type, llvmType, data, names[i]);
+    }
+}
+
+void*   Trace::frst()
+{
+    return  m_impl->m_rows.data();
+}
+
+void*   Trace::last()
+{
+    return  m_impl->m_rows.data() + m_impl->m_rows.size() - m_impl->m_rowSize;
+}
+
+void*   Trace::conf()
+{
+    return  m_impl->m_conf;
+}
+
+void*   Trace::cols()
+{
+    return  m_impl->m_cols;
+}
+
+size_t  Trace::size() const
+{
+    return  m_impl->m_rows.size() / m_impl->m_rowSize - 2;
+}
@@ -0,0 +1,80 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+#include "module.hpp"
+
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DerivedTypes.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+/*
+ *  Trace holds the samples a compiled spec is evaluated on, laid out exactly
+ *  as Compile::make lowers them: an array of __prop_t rows bracketed by two
+ *  sentinel rows (frst and last), and a single __conf_t instance.
+ *
+ *  Every row carries a pointer per prop; props are sample-and-hold, i.e. a row
+ *  points to the latest value pushed for the prop at or before its __time__.
+ *  Props without any value yet read as zero.
+ *
+ *  Given a __cols_t type (Layout::columns) rows carry __time__ only and every
+ *  prop gets a column array holding a copy of its value for each row instead.
+ *  Props whose __prop_t field is not a pointer (Layout::values) are copied
+ *  into the row itself.
+ */
+class Trace
+{
+public:
+    Trace(  Module*                 refmod,
+            llvm::DataLayout const& layout,
+            llvm::StructType*       propType,
+            llvm::StructType*       confType,
+            llvm::StructType*       colsType = nullptr);
+    ~Trace();
+
+    void    loadCsv(    std::string const&  filename);
+    void    loadRdb(    std::string const&  filename);
+    void    loadConf(   std::string const&  filename);
+
+    //  feeds the samples of an rdb file to step one at a time, through a
+    //  single row that is rewritten in place, without loading the trace
+    void    streamRdb(  std::string const&  filename,
+                        std::function<void(void* curr)> const&  step);
+
+    void*   frst();
+    void*   last();
+    void*   conf();
+    void*   cols();     //  __cols_t instance, nullptr unless Layout::columns
+
+    size_t  size() const;   //  number of samples, sentinels excluded
+
+    class Impl;
+
+private:
+    std::unique_ptr<Impl>   m_impl;
+};
@@ -0,0 +1,240 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "cheader.hpp"
+
+#include <cctype>
+#include <set>
+#include <sstream>
+
+struct CHeaderImpl
+    : Visitor<  TypeInteger
+             ,  TypeNumber
+             ,  TypeString
+             ,  TypeBoolean
+             ,  TypeStruct
+             ,  TypeEnum
+             ,  TypeArray>
+{
+    //  declaration of `declarator` as `type`, types are named after the path
+    //  of the data they belong to, as CompileTypeImpl names them
+    std::string make(Type* type, std::string const& name, std::string const& declarator);
+
+    void    visit(TypeInteger*          type) override;
+    void    visit(TypeNumber*           type) override;
+    void    visit(TypeString*           type) override;
+    void    visit(TypeBoolean*          type) override;
+    void    visit(TypeStruct*           type) override;
+    void    visit(TypeEnum*             type) override;
+    void    visit(TypeArray*            type) override;
+
+    std::ostringstream      m_types;
+    std::set<std::string>   m_defined;
+    std::string             m_name;
+    std::string             m_declarator;
+    std::string             m_decl;
+};
+
+//  "conf::range[]" -> "conf__range_"
+static std::string  identifier(std::string const& name)
+{
+    std::string result;
+
+    for(auto c: name)
+    {
+        result  += std::isalnum((unsigned char)c) ? c : '_';
+    }
+
+    return  result;
+}
+
+void    CHeaderImpl::visit(TypeInteger*          type)
+{
+    m_decl  = "int64_t " + m_declarator;
+}
+
+void    CHeaderImpl::visit(TypeNumber*           type)
+{
+    m_decl  = "double " + m_declarator;
+}
+
+void    CHeaderImpl::visit(TypeString*           type)
+{
+    m_decl  = "char const* " + m_declarator;
+}
+
+void    CHeaderImpl::visit(TypeBoolean*          type)
+{
+    m_decl  = "bool " + m_declarator;
+}
+
+void    CHeaderImpl::visit(TypeStruct*           type)
+{
+    auto    name    = identifier(m_name);
+
+    if(m_defined.insert(name).second)
+    {
+        std::string members;
+        for(auto member: type->members)
+        {
+            members += "    " + make(member.data, m_name + "::" + member.name, member.name) + ";\n";
+        }
+
+        m_types << "struct " << name << "\n{\n" << members << "};\n\n";
+    }
+
+    m_decl  = "struct " + name + " " + m_declarator;
+}
+
+void    CHeaderImpl::visit(TypeEnum*             type)
+{
+    auto    name    = identifier(m_name);
+
+    if(m_defined.insert(name).second)
+    {
+        m_types << "enum\n{\n";
+        for(auto item: type->items)
+        {
+            m_types << "    " << name << "_" << item << " = " << type->index(item) << ",\n";
+        }
+        m_types << "};\n\n";
+    }
+
+    m_decl  = "int8_t " + m_declarator;
+}
+
+void    CHeaderImpl::visit(TypeArray*            type)
+{
+    //  a dynamic array is its size and a pointer to the elements
+    if(type->size == 0)
+    {
+        auto    name    = identifier(m_name);
+
+        if(m_defined.insert(name).second)
+        {
+            auto    data    = make(type->type, m_name + "[]", "*data");
+            m_types << "struct " << name << "\n{\n    int16_t size;\n    " << data << ";\n};\n\n";
+        }
+
+        m_decl  = "struct " + name + " " + m_declarator;
+        return;
+    }
+
+    auto    inner   = m_declarator.starts_with("*") ? "(" + m_declarator + ")" : m_declarator;
+
+    m_decl  = make(type->type, m_name + "[]", inner + "[" + std::to_string(type->size) + "]");
+}
+
+std::string CHeaderImpl::make(Type* type, std::string const& name, std::string const& declarator)
+{
+    auto    saveName        = m_name;
+    auto    saveDeclarator  = m_declarator;
+
+    m_name          = name;
+    m_declarator    = declarator;
+
+    type->accept(*this);
+
+    m_name          = saveName;
+    m_declarator    = saveDeclarator;
+
+    return  m_decl;
+}
+
+void    CHeader::make(
+                std::ostream&       os,
+                std::string const&  guard,
+                Module*             mod,
+                Options const&      options,
+                std::vector<std::pair<std::string, std::string>> const& functions)
+{
+    CHeaderImpl impl;
+
+    std::string conf;
+    for(auto name: mod->getConfNames())
+    {
+        conf    += "    " + impl.make(mod->getConf(name), name, name) + ";\n";
+    }
+
+    //  the same split Compile::declare makes
+    std::string prop    = "    int64_t __time__;\n";
+    std::string cols;
+    for(auto name: mod->getPropNames())
+    {
+        if(name == "__time__")
+            continue;
+
+        auto    type    = mod->getProp(name);
+        auto    scalar  = dynamic_cast<TypeBoolean*>(type) || dynamic_cast<TypeInteger*>(type)
+                       || dynamic_cast<TypeNumber*>(type)  || dynamic_cast<TypeEnum*>(type);
+
+        if(options.layout == Layout::columns)
+            cols    += "    " + impl.make(type, name, "*" + name) + ";\n";
+        else if(options.layout == Layout::values && scalar)
+            prop    += "    " + impl.make(type, name, name) + ";\n";
+        else
+            prop    += "    " + impl.make(type, name, "*" + name) + ";\n";
+    }
+
+    auto    macro   = identifier(guard) + "_H";
+
+    os  << "/*  generated by referee, do not edit */\n\n"
+        << "#ifndef " << macro << "\n"
+        << "#define " << macro << "\n\n"
+        << "#include <stdbool.h>\n"
+        << "#include <stdint.h>\n\n"
+        << "#ifdef __cplusplus\n"
+        << "extern \"C\" {\n"
+        << "#endif\n\n"
+        << impl.m_types.str()
+        << "typedef struct __conf_t\n{\n" << conf << "} __conf_t;\n\n"
+        << "typedef struct __prop_t\n{\n" << prop << "} __prop_t;\n\n";
+
+    if(options.layout == Layout::columns)
+    {
+        os  << "typedef struct __cols_t\n{\n" << cols << "} __cols_t;\n\n";
+    }
+
+    os  << "/*\n"
+        << " *  every function checks the samples between frst and last, both of them\n"
+        << " *  sentinel rows: frst sits right before the first sample and last right\n"
+        << " *  after the last one\n"
+        << " */\n";
+
+    for(auto& [symbol, position]: functions)
+    {
+        os  << "\n/*  " << position << "  */\n"
+            << "bool    " << symbol << "(__prop_t const* frst, __prop_t const* last, __conf_t const* conf";
+        if(options.layout == Layout::columns)
+            os  << ", __cols_t const* cols";
+        if(options.witness)
+            os  << ", int64_t* witness";
+        os  << ");\n";
+    }
+
+    os  << "\n#ifdef __cplusplus\n"
+        << "}\n"
+        << "#endif\n\n"
+        << "#endif\n";
+}
@@ -27,10 +27,240 @@
 #include "typecalc.hpp"
 #include "strings.hpp"
 #include "../factory.hpp"
+#include "../report.hpp"
 
+#include "llvm/Analysis/ConstantFolding.h"
+
+#include <algorithm>
+#include <cstring>
 #include <functional>
+#include <map>
+#include <set>
 #include <vector>
 
+static bool isInvariant(Expr* expr)
+{
+    if(dynamic_cast<ExprData*>(expr))
+    {
+        return  false;
+    }
+
+    if(auto conf = dynamic_cast<ExprConf*>(expr))
+    {
+        return  conf->ctxt->name == "__conf__";
+    }
+
+    if(auto ctxt = dynamic_cast<ExprContext*>(expr))
+    {
+        return  ctxt->name == "__conf__";
+    }
+
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+    {
+        return  isInvariant(unary->arg);
+    }
+
+    if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        return  isInvariant(binary->lhs) && isInvariant(binary->rhs);
+    }
+
+    if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+    {
+        return  isInvariant(ternary->lhs) && isInvariant(ternary->mhs) && isInvariant(ternary->rhs);
+    }
+
+    return  dynamic_cast<ExprNullary*>(expr) != nullptr;
+}
+
+//  true if expr only looks at the current and earlier samples, so a step
+//  function can evaluate it one sample at a time with a fixed-size state
+static bool isPastTime(Expr* expr)
+{
+    if(auto data = dynamic_cast<ExprData*>(expr))
+    {
+        return  data->ctxt->name == "__curr__";
+    }
+
+    if(auto ctxt = dynamic_cast<ExprContext*>(expr))
+    {
+        return  ctxt->name == "__curr__" || ctxt->name == "__conf__";
+    }
+
+    if(dynamic_cast<ExprAt*>(expr) || dynamic_cast<ExprInt*>(expr)
+    || dynamic_cast<ExprXs*>(expr) || dynamic_cast<ExprXw*>(expr)
+    || dynamic_cast<ExprUs*>(expr) || dynamic_cast<ExprUw*>(expr)
+    || dynamic_cast<ExprRs*>(expr) || dynamic_cast<ExprRw*>(expr))
+    {
+        return  false;
+    }
+
+    if(dynamic_cast<ExprYs*>(expr) || dynamic_cast<ExprYw*>(expr))
+    {
+        auto    binary  = dynamic_cast<ExprBinary*>(expr);
+        auto    count   = dynamic_cast<ExprConstInteger*>(binary->lhs);
+
+        return  count && count->value >= 0 && isPastTime(binary->rhs);
+    }
+
+    if(auto temporal = dynamic_cast<Temporal<ExprBinary>*>(expr))
+    {
+        auto    time    = temporal->time;
+
+        if(time && time->lo && !isInvariant(time->lo))
+            return  false;
+
+        if(time && time->hi && !isInvariant(time->hi))
+            return  false;
+    }
+
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+    {
+        return  isPastTime(unary->arg);
+    }
+
+    if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        return  isPastTime(binary->lhs) && isPastTime(binary->rhs);
+    }
+
+    if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+    {
+        return  isPastTime(ternary->lhs) && isPastTime(ternary->mhs) && isPastTime(ternary->rhs);
+    }
+
+    return  dynamic_cast<ExprNullary*>(expr) != nullptr;
+}
+
+//  how far from the current row an expr reads, in time and in rows, forward
+//  (ahead, next) and backward (back, prev)
+struct Reach
+{
+    int64_t ahead   = 0;
+    int64_t next    = 0;
+    int64_t back    = 0;
+    int64_t prev    = 0;
+};
+
+static bool isUntimed(Temporal<ExprBinary>* temporal)
+{
+    return  !temporal->time || (!temporal->time->lo && !temporal->time->hi);
+}
+
+static bool isFuture(Expr* expr)
+{
+    return  dynamic_cast<ExprUs*>(expr) || dynamic_cast<ExprUw*>(expr)
+        ||  dynamic_cast<ExprRs*>(expr) || dynamic_cast<ExprRw*>(expr);
+}
+
+//  widens most by the rows expr reads when evaluated at an offset of at from
+//  the current row, false if that is not bounded.  An untimed U/R/S/T is
+//  resolved up to the chunk edge and carried across it, see Chunks, so it
+//  adds nothing, but whatever reads it must not look past that edge.
+static bool reach(Expr* expr, Reach at, Reach& most)
+{
+    most.ahead  = std::max(most.ahead,  at.ahead);
+    most.next   = std::max(most.next,   at.next);
+    most.back   = std::max(most.back,   at.back);
+    most.prev   = std::max(most.prev,   at.prev);
+
+    if(dynamic_cast<ExprAt*>(expr))
+    {
+        return  false;
+    }
+
+    if(dynamic_cast<ExprXs*>(expr) || dynamic_cast<ExprXw*>(expr) || dynamic_cast<ExprYs*>(expr) || dynamic_cast<ExprYw*>(expr))
+    {
+        auto    binary  = dynamic_cast<ExprBinary*>(expr);
+        auto    count   = dynamic_cast<ExprConstInteger*>(binary->lhs);
+
+        if(!count)
+            return  false;
+
+        auto    rows    = dynamic_cast<ExprXs*>(expr) || dynamic_cast<ExprXw*>(expr) ? count->value : -count->value;
+
+        if(rows > 0)
+            at.next += rows;
+        else
+            at.prev -= rows;
+
+        return  reach(binary->rhs, at, most);
+    }
+
+    if(auto temporal = dynamic_cast<Temporal<ExprBinary>*>(expr))
+    {
+        auto    integral    = dynamic_cast<ExprInt*>(expr) != nullptr;
+        auto    future      = integral || isFuture(expr);
+
+        if(!integral && isUntimed(temporal))
+        {
+            if(future ? at.ahead || at.next : at.back || at.prev)
+                return  false;
+        }
+        else
+        {
+            auto    lo  = temporal->time && temporal->time->lo ? dynamic_cast<ExprConstInteger*>(temporal->time->lo) : nullptr;
+            auto    hi  = temporal->time && temporal->time->hi ? dynamic_cast<ExprConstInteger*>(temporal->time->hi) : nullptr;
+
+            if(!hi || (temporal->time->lo && !lo))
+                return  false;
+
+            if(future)
+                at.ahead    += hi->value;
+            else
+                at.back     += hi->value;
+        }
+
+        return  reach(temporal->lhs, at, most) && reach(temporal->rhs, at, most);
+    }
+
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+    {
+        return  reach(unary->arg, at, most);
+    }
+
+    if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        return  reach(binary->lhs, at, most) && reach(binary->rhs, at, most);
+    }
+
+    if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+    {
+        return  reach(ternary->lhs, at, most) && reach(ternary->mhs, at, most) && reach(ternary->rhs, at, most);
+    }
+
+    return  true;
+}
+
+//  nesting level of the untimed U/R/S/T in expr, 1 for one that has none
+//  inside, 0 if expr is none of them and has none inside
+static int  depth(Expr* expr)
+{
+    auto    most    = 0;
+
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+    {
+        most    = depth(unary->arg);
+    }
+    else if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        most    = std::max(depth(binary->lhs), depth(binary->rhs));
+    }
+    else if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+    {
+        most    = std::max({depth(ternary->lhs), depth(ternary->mhs), depth(ternary->rhs)});
+    }
+
+    auto    temporal    = dynamic_cast<Temporal<ExprBinary>*>(expr);
+
+    if(temporal && !dynamic_cast<ExprInt*>(expr) && isUntimed(temporal))
+    {
+        most++;
+    }
+
+    return  most;
+}
+
 struct CompileTypeImpl
     : Visitor<  TypeInteger
              ,  TypeNumber
@@ -121,7 +351,15 @@ struct CompileExprImpl
             llvm::Module*       module,
             llvm::IRBuilder<>*  builder,
             llvm::Function*     function,
-            Module*             refmod);
+            Module*             refmod,
+            Options const&      options = Options());
+    CompileExprImpl(
+            llvm::LLVMContext*  context,
+            llvm::Module*       module,
+            llvm::IRBuilder<>*  builder,
+            llvm::Function*     function,
+            Module*             refmod,
+            llvm::StructType*   stateType);
 
     void    visit(ExprAdd*          expr) override;
     void    visit(ExprAnd*          expr) override;
@@ -191,18 +429,109 @@ struct CompileExprImpl
                 llvm::Value*            lhsV,
                 llvm::Value*            endV,
                 std::string             name);
+    void    sweep(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                llvm::Value*            endV,
+                std::string             name);
+    void    slideUR(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                llvm::Value*            endV,
+                std::string             name);
+    void    slideST(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                llvm::Value*            endV,
+                std::string             name);
+    bool    sweepable(Temporal<ExprBinary>* expr);
+    void    integral(
+                ExprInt*                expr,
+                std::string             name);
+    llvm::Value*    search(
+                llvm::Value*            time,
+                llvm::Value*            lo,
+                llvm::Value*            hi,
+                std::string             name);
+    void    bits(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                llvm::Value*            endV,
+                bool                    past,
+                std::string             name);
+    llvm::Value*    carry(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                llvm::Value*            endV,
+                bool                    past,
+                std::string             name);
+    llvm::Value*    pack(Expr* expr);
+    bool            columnar(Expr* expr);
+    llvm::Value*    lanes(Expr* expr, llvm::Value* base);
+    unsigned        seam(
+                Temporal<ExprBinary>*   expr,
+                bool                    past);
+    llvm::Value*    carryIn(
+                unsigned                seam,
+                bool                    past,
+                llvm::Value*            endV,
+                llvm::Value*            size);
+    void            summarize(
+                unsigned                seam,
+                llvm::Value*            value,
+                llvm::Value*            decided);
+    void            witness(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            result,
+                llvm::Value*            curr,
+                llvm::Value*            which,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                std::string             name);
+    void            decider(llvm::Value* curr);
     void    ST( Temporal<ExprBinary>*   expr,
                 llvm::Value*            rhsV,
                 llvm::Value*            lhsV,
                 llvm::Value*            endV,
                 std::string             name);
+    void    stepY(
+                ExprBinary*             expr,
+                llvm::Value*            endV,
+                std::string             name);
+    void    stepST(
+                Temporal<ExprBinary>*   expr,
+                llvm::Value*            rhsV,
+                llvm::Value*            lhsV,
+                llvm::Value*            endV,
+                std::string             name);
 
     llvm::Value*    make(Expr* expr);
     llvm::Value*    make(Spec* spec);
+    llvm::Value*    verdict(Expr* expr);
+    void            share(std::map<Expr*, std::string> const* shared) {m_shared = shared;}
+    bool            shares(Expr* expr);
+    llvm::Value*    shared(Expr* expr);
+    llvm::Value*    tabulate(Expr* expr);
+    void            chain(llvm::BasicBlock* head, llvm::BasicBlock* tail);
+    void            release();
+    llvm::Value*    step(Expr* expr);
+    llvm::Value*    chunk(ExprRw* globally);
+    std::vector<uint8_t> const&
+                    seams() const {return m_seams;}
+    void            layout(Expr* expr, std::vector<llvm::Type*>& fields);
+    void            done(llvm::Value* state);
+    size_t          nodes() const {return m_nodes;}
 
     llvm::Value*    getNext(llvm::Value* curr);
     llvm::Value*    getPrev(llvm::Value* curr);
     llvm::Value*    getTime(llvm::Value* curr, std::string name = "__time__");
+    llvm::Value*    getTime(llvm::Value* frst, llvm::Value* indx, std::string name);
+    llvm::Value*    getProp(llvm::Type* type, llvm::Value* ptr, std::string name);
     llvm::Value*    getPropPtr(llvm::Value* var);
     llvm::Value*    setPropPtr(llvm::Value* var, llvm::Value* val);
     llvm::Value*    getBool(llvm::Value* var);
@@ -212,6 +541,7 @@ private:
     llvm::Value*        add(llvm::Value* lhs, llvm::Value* rhs, std::string const& name);
     llvm::Value*        mul(llvm::Value* lhs, llvm::Value* rhs, std::string const& name);
     llvm::Value*        sub(llvm::Value* lhs, llvm::Value* rhs, std::string const& name);
+    void                setup();
 
 private:
     llvm::LLVMContext*  m_context;
@@ -234,11 +564,42 @@ private:
     std::vector<llvm::Value*>   m_frst;
     std::vector<llvm::Value*>   m_last;
     llvm::Value*        m_conf;
+    llvm::Value*        m_cols = nullptr;
     llvm::Type*         m_propType;
     llvm::Type*         m_propPtrType;
     llvm::Type*         m_confType;
     llvm::Type*         m_confPtrType;
     llvm::Type*         m_boolType;
+    Options             m_options;
+    std::map<Expr*, llvm::Value*>
+                        m_sweeps;
+    std::map<Expr*, llvm::Value*>
+                        m_packs;
+    llvm::BasicBlock*   m_body;
+    llvm::BasicBlock*   m_chain = nullptr;
+    llvm::Value*        m_state = nullptr;
+    llvm::StructType*   m_stateType = nullptr;
+    std::map<Expr*, unsigned>
+                        m_slots;
+    std::map<Expr*, llvm::Value*>
+                        m_steps;
+    std::vector<unsigned>
+                        m_windows;
+    llvm::Value*        m_lo = nullptr;         //  chunk functions only, see chunk()
+    llvm::Value*        m_hi = nullptr;
+    llvm::Value*        m_carry = nullptr;
+    llvm::Value*        m_summary = nullptr;
+    std::vector<uint8_t>
+                        m_seams;                //  per seam: depth - 1 << 1 | past
+    llvm::Value*        m_witness = nullptr;    //  row, time, deciding row, its depth, see witness()
+    Expr*               m_root = nullptr;
+    bool                m_witnessing = false;
+    std::map<Expr*, std::string> const*
+                        m_shared = nullptr;     //  subformulas computed once, see tabulate()
+    std::map<Expr*, std::pair<llvm::Value*, llvm::Value*>>
+                        m_buffers;              //  shared buffer and whether this function filled it
+    Expr*               m_tabulated = nullptr;
+    size_t              m_nodes = 0;            //  AST nodes compiled, for the Report
 };
 
 
@@ -321,12 +682,61 @@ CompileExprImpl::CompileExprImpl(
             llvm::Module*       module,
             llvm::IRBuilder<>*  builder,
             llvm::Function*     function,
-            Module*             refmod)
+            Module*             refmod,
+            Options const&      options)
+    : m_context(context)
+    , m_module(module)
+    , m_function(function)
+    , m_builder(builder)
+    , m_refmod(refmod)
+    , m_options(options)
+{
+    auto    iter    = function->arg_begin();
+
+    m_frst.push_back(iter++);
+    m_last.push_back(iter++);
+    m_conf  = iter++;
+    m_cols  = options.layout == Layout::columns ? iter++ : nullptr;
+    m_witness   = options.witness ? iter++ : nullptr;
+    if(iter != function->arg_end())
+    {
+        m_lo        = iter++;
+        m_hi        = iter++;
+        m_carry     = iter++;
+        m_summary   = iter++;
+    }
+    m_propPtrType   = m_frst.front()->getType();
+
+    setup();
+
+    m_curr.push_back(getNext(m_frst.front()));
+}
+
+CompileExprImpl::CompileExprImpl(
+            llvm::LLVMContext*  context,
+            llvm::Module*       module,
+            llvm::IRBuilder<>*  builder,
+            llvm::Function*     function,
+            Module*             refmod,
+            llvm::StructType*   stateType)
     : m_context(context)
     , m_module(module)
     , m_function(function)
     , m_builder(builder)
     , m_refmod(refmod)
+    , m_stateType(stateType)
+{
+    auto    iter    = function->arg_begin();
+
+    m_state = iter++;
+    m_curr.push_back(iter++);
+    m_conf  = iter;
+    m_propPtrType   = m_curr.front()->getType();
+
+    setup();
+}
+
+void    CompileExprImpl::setup()
 {
     m_0     = llvm::ConstantInt::getSigned(m_builder->getInt64Ty(), 0);
     m_p1    = llvm::ConstantInt::getSigned(m_builder->getInt64Ty(), +1);
@@ -334,18 +744,12 @@ CompileExprImpl::CompileExprImpl(
     m_T     = llvm::ConstantInt::getTrue(*m_context);
     m_F     = llvm::ConstantInt::getFalse(*m_context);
 
-    auto    iter    = function->arg_begin();
-
-    m_frst.push_back(iter++);
-    m_last.push_back(iter++);
-    m_conf  = iter;
-    m_propType      = cast<llvm::PointerType>(m_frst.front()->getType())->getPointerElementType();
-    m_propPtrType   = m_frst.front()->getType();
+    m_propType      = cast<llvm::PointerType>(m_propPtrType)->getPointerElementType();
     m_confType      = cast<llvm::PointerType>(m_conf->getType())->getPointerElementType();
     m_confPtrType   = m_conf->getType();
     m_boolType      = m_builder->getInt1Ty();
 
-    m_curr.push_back(getNext(m_frst.front()));
+    m_body  = &m_function->getEntryBlock();
 }
 
 void    CompileExprImpl::visit(ExprAdd*          expr)
@@ -475,6 +879,33 @@ void    CompileExprImpl::visit(ExprData*         expr)
 
         m_value = m_builder->CreateLoad(propType, propPtr, false, "__time__");
     }
+    else if(m_cols)
+    {
+        auto    colsType        = cast<llvm::PointerType>(m_cols->getType())->getPointerElementType();
+        auto    colPtr          = m_builder->CreateStructGEP(colsType, m_cols, dynamic_cast<TypeContext*>(expr->ctxt->type())->index(expr->name));
+        auto    colType         = cast<llvm::PointerType>(cast<llvm::PointerType>(colPtr->getType())->getPointerElementType());
+        auto    propType        = colType->getPointerElementType();
+        auto    indx            = m_builder->CreatePtrDiff(ctxtType, ctxtPtr, m_frst.front(), "row");
+
+        m_value = m_builder->CreateGEP(propType, m_builder->CreateLoad(colType, colPtr, false, "col_" + expr->name), indx, "ptr_" + expr->name);
+
+        if(dynamic_cast<TypePrimitive*>(expr->type()))
+        {
+            m_value = getProp(propType, m_value, "val_" + expr->name);
+        }
+    }
+    else if(!cast<llvm::StructType>(ctxtType)->getElementType(dynamic_cast<TypeContext*>(expr->ctxt->type())->index(expr->name) + 1)->isPointerTy())
+    {
+        //  scalar held by value in the row, see Layout::values
+        auto    propType        = cast<llvm::StructType>(ctxtType)->getElementType(dynamic_cast<TypeContext*>(expr->ctxt->type())->index(expr->name) + 1);
+
+        m_value = m_builder->CreateStructGEP(ctxtType, ctxtPtr, dynamic_cast<TypeContext*>(expr->ctxt->type())->index(expr->name) + 1, "ptr_" + expr->name); //  +1 to skip __time__
+
+        if(dynamic_cast<TypePrimitive*>(expr->type()))
+        {
+            m_value = getProp(propType, m_value, "val_" + expr->name);
+        }
+    }
     else
     {
         auto    propPtrPtr      = m_builder->CreateStructGEP(ctxtType, ctxtPtr, dynamic_cast<TypeContext*>(expr->ctxt->type())->index(expr->name) + 1); //  +1 to skip __time__
@@ -487,7 +918,7 @@ void    CompileExprImpl::visit(ExprData*         expr)
 
         if(dynamic_cast<TypePrimitive*>(expr->type()))
         {
-            m_value = m_builder->CreateLoad(propPtrType->getPointerElementType(), m_value, false, "val_" + expr->name);
+            m_value = getProp(propType, m_value, "val_" + expr->name);
         }
     }
 }
@@ -778,6 +1209,12 @@ uint64_t    integral(prop_t const* curr, prop_t const* frst, prop_t const* last)
     return  result;
 }
 */
+    if(sweepable(expr))
+    {
+        integral(expr, "I");
+        return;
+    }
+
     auto    bbHead  = llvm::BasicBlock::Create(*m_context, "I-head", m_function);
 
     auto    bbTime  = llvm::BasicBlock::Create(*m_context, "I-time", m_function);
@@ -1073,6 +1510,12 @@ void    CompileExprImpl::XY(ExprBinary*     expr,
                             llvm::Value*    endV,
                             std::string     name)
 {
+    if(m_state)
+    {
+        stepY(expr, endV, name);
+        return;
+    }
+
     auto    bbHeadHi= llvm::BasicBlock::Create(*m_context, name + "-head", m_function);
     auto    bbHeadLo= bbHeadHi;
     auto    bbBodyHi= llvm::BasicBlock::Create(*m_context, name + "-body", m_function);
@@ -1189,6 +1632,17 @@ uint64_t    UR(prop_t const* curr, prop_t const* frst, prop_t const* last, bool
     return  endV;
 }
 */
+    if(sweepable(expr))
+    {
+        if(expr->time && (expr->time->lo || expr->time->hi))
+            slideUR(expr, rhsV, lhsV, endV, name);
+        else if(m_options.bitset)
+            bits(expr, rhsV, lhsV, endV, false, name);
+        else
+            sweep(expr, rhsV, lhsV, endV, name);
+        return;
+    }
+
     auto    debug   = m_module->getFunction("debug");
 
     auto    bbWhile = llvm::BasicBlock::Create(*m_context, name + "-while", m_function);
@@ -1303,58 +1757,1433 @@ uint64_t    UR(prop_t const* curr, prop_t const* frst, prop_t const* last, bool
     next->addIncoming(next0, bbEntry);
     next->addIncoming(next1, bbNext);
 
+    if(m_witness && expr == m_root)
+    {
+        auto    which   = m_builder->CreatePHI(m_builder->getInt8Ty(), timeHi ? 4 : 3, "which");
+        which->addIncoming(m_builder->getInt8(2), bbLhsLo);
+        which->addIncoming(m_builder->getInt8(1), bbRhsLo);
+        which->addIncoming(m_builder->getInt8(0), bbWhile);
+        if(timeHi)
+            which->addIncoming(m_builder->getInt8(0), bbOuter);
+
+        witness(expr, result, curr, which, rhsV, lhsV, name);
+    }
+    else if(m_witnessing)
+    {
+        decider(curr);
+    }
+
     m_value = result;
 }
 
-void    CompileExprImpl::ST(Temporal<ExprBinary>*   expr,
+void    CompileExprImpl::sweep(
+                            Temporal<ExprBinary>*   expr,
                             llvm::Value*            rhsV,
                             llvm::Value*            lhsV,
                             llvm::Value*            endV,
                             std::string             name)
 {
 /*
-typedef long long uint64_t;
-typedef struct prop_t
+bool*   sweep(prop_t const* frst, prop_t const* last, bool lhsV, bool rhsV, bool endV)
 {
-    uint64_t    __time__;
-    uint64_t    a;
-} prop_t;
+    bool*           V       = malloc(last - frst + 1);
+    prop_t const*   curr    = last - 1;
 
-bool        boolean(prop_t const* curr);
-bool        integer(prop_t const* curr);
+    V[last - frst]  = endV;
 
-uint64_t    ST(uint64_t lo, uint64_t hi, prop_t const* curr, prop_t const* frst, prop_t const* last, bool lhsV, bool rhsV, bool endV)
-{
-    prop_t const*   prev    = curr - 1;
+    while(curr > frst)
+    {
+        if(eval(rhs) == rhsV)
+            V[curr - frst]  = rhsV;
+        else if(eval(lhs) == lhsV)
+            V[curr - frst]  = lhsV;
+        else
+            V[curr - frst]  = V[curr - frst + 1];
 
-    lo  = curr->__time__ - lo;
-    hi  = curr->__time__ - hi;
-    swap(lo, hi);
+        curr    = curr - 1;
+    }
 
-    while(frst <= prev)
+    return  V;
+}
+
+The sweep is emitted once per function ahead of its body, see chain(), and the
+buffer is released by release() before the function returns.  At the point
+of use the verdict is just V[curr - frst].
+*/
+    auto    frst        = m_frst.front();
+    auto    last        = m_last.front();
+    auto    boolPtrType = llvm::PointerType::get(m_boolType, 0);
+
+    if(m_sweeps.find(expr) == m_sweeps.end())
     {
-        ifcurr->__time__ < lo)
+        auto    malloc  = m_module->getOrInsertFunction("malloc", m_builder->getInt8PtrTy(), m_builder->getInt64Ty());
+        auto    save    = m_builder->saveIP();
+
+        auto    bbHead  = llvm::BasicBlock::Create(*m_context, name + "-sweep-head", m_function);
+        auto    bbWhile = llvm::BasicBlock::Create(*m_context, name + "-sweep-while", m_function);
+        auto    bbRhsHi = llvm::BasicBlock::Create(*m_context, name + "-sweep-rhs", m_function);
+        auto    bbRhsLo = bbRhsHi;
+        auto    bbLhsHi = llvm::BasicBlock::Create(*m_context, name + "-sweep-lhs", m_function);
+        auto    bbLhsLo = bbLhsHi;
+        auto    bbNext  = llvm::BasicBlock::Create(*m_context, name + "-sweep-next", m_function);
+        auto    bbTail  = llvm::BasicBlock::Create(*m_context, name + "-sweep-tail", m_function);
+
+        //  head
+        m_builder->SetInsertPoint(bbHead);
+        auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+        auto    buff    = m_builder->CreateBitCast(
+                            m_builder->CreateCall(malloc, {m_builder->CreateAdd(size, m_p1)}),
+                            boolPtrType,
+                            name);
+        auto    curr0   = getPrev(last);
+
+        //  in a chunk the rows from hi on belong to the next one, they all
+        //  take the value carried in from it
+        unsigned        ord     = 0;
+        llvm::Value*    edge    = nullptr;
+        if(m_lo)
         {
-            break;
+            ord     = seam(expr, false);
+            edge    = m_builder->CreateICmpSGE(m_hi, size, "hi >= size");
+            auto    carry   = carryIn(ord, false, endV, size);
+            m_builder->CreateMemSet(
+                m_builder->CreateGEP(m_boolType, buff, m_hi),
+                m_builder->CreateZExt(carry, m_builder->getInt8Ty()),
+                m_builder->CreateAdd(m_builder->CreateSub(size, m_hi), m_p1),
+                llvm::MaybeAlign(1));
+            curr0   = m_builder->CreateGEP(m_propType, frst, m_builder->CreateSub(m_hi, m_p1), "curr0");
+        }
+        else
+        {
+            m_builder->CreateStore(endV, m_builder->CreateGEP(m_boolType, buff, size));
+        }
+        m_builder->CreateBr(bbWhile);
+
+        //  while
+        m_builder->SetInsertPoint(bbWhile);
+        auto    curr    = m_builder->CreatePHI(m_propPtrType, 2, "curr");
+        auto    decided = m_lo ? m_builder->CreatePHI(m_boolType, 2, "decided") : nullptr;
+        auto    indx    = m_builder->CreatePtrDiff(m_propType, curr, frst, "curr - frst");
+        auto    currGTfrst  = m_builder->CreateICmpSGT(curr, frst, "curr > frst");
+        m_builder->CreateCondBr(currGTfrst, bbRhsHi, bbTail);
+
+        //  rhs
+        m_builder->SetInsertPoint(bbRhsHi);
+        m_curr.push_back(curr);
+        auto    rhs     = make(expr->rhs);
+        m_curr.pop_back();
+        auto    rhsCond = m_builder->CreateCmp(llvm::CmpInst::Predicate::ICMP_EQ, rhs, rhsV);
+        bbRhsLo = m_builder->GetInsertBlock();
+        m_builder->CreateCondBr(rhsCond, bbNext, bbLhsHi);
+
+        //  lhs
+        m_builder->SetInsertPoint(bbLhsHi);
+        m_curr.push_back(curr);
+        auto    lhs     = make(expr->lhs);
+        m_curr.pop_back();
+        auto    lhsCond = m_builder->CreateCmp(llvm::CmpInst::Predicate::ICMP_EQ, lhs, lhsV);
+        auto    later   = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, buff, m_builder->CreateAdd(indx, m_p1)));
+        auto    value   = m_builder->CreateSelect(lhsCond, lhsV, later);
+        bbLhsLo = m_builder->GetInsertBlock();
+        m_builder->CreateBr(bbNext);
+
+        //  next
+        m_builder->SetInsertPoint(bbNext);
+        auto    result  = m_builder->CreatePHI(m_boolType, 2, "result");
+        auto    hit     = m_lo ? m_builder->CreatePHI(m_boolType, 2, "hit") : nullptr;
+        m_builder->CreateStore(result, m_builder->CreateGEP(m_boolType, buff, indx));
+        auto    curr1   = getPrev(curr);
+        auto    decided1= m_lo ? m_builder->CreateOr(decided, m_builder->CreateAnd(hit, m_builder->CreateICmpSGE(indx, m_lo))) : nullptr;
+        m_builder->CreateBr(bbWhile);
+
+        //  tail
+        m_builder->SetInsertPoint(bbTail);
+        if(m_lo)
+        {
+            auto    value   = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, buff, m_lo));
+            summarize(ord, value, m_builder->CreateOr(decided, edge));
         }
+        chain(bbHead, bbTail);
 
-        uint64_t    _lo = lo > curr->__time__ ? lo : curr->__time__;
-        uint64_t    _hi = prev->__time__ < hi ? hi : prev->__time__;
+        //  link
+        curr->addIncoming(curr0, bbHead);
+        curr->addIncoming(curr1, bbNext);
 
-        if(_lo < _hi)
+        result->addIncoming(rhsV,  bbRhsLo);
+        result->addIncoming(value, bbLhsLo);
+
+        if(m_lo)
         {
-            if(eval(rhs) == rhsV)
-                return rshV;
+            decided->addIncoming(m_F, bbHead);
+            decided->addIncoming(decided1, bbNext);
 
-            if(eval(lhs) == lhsV)
-                return lshV;
+            hit->addIncoming(m_T, bbRhsLo);
+            hit->addIncoming(lhsCond, bbLhsLo);
         }
 
-        curr    = prev;
-        prev    = prev - 1;
+        m_builder->restoreIP(save);
+        m_sweeps[expr]  = buff;
     }
 
-    return  endV;
+    auto    indx    = m_builder->CreatePtrDiff(m_propType, m_curr.back(), frst, "curr - frst");
+
+    m_value = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, m_sweeps[expr], indx), name);
+}
+
+bool    CompileExprImpl::sweepable(Temporal<ExprBinary>* expr)
+{
+    auto    nested  = m_curr.size() > 1;
+    auto    global  = m_frst.size() == 1 && m_last.size() == 1 && m_name2value.empty();
+    auto    bounds  = !expr->time
+                   || (  (!expr->time->lo || isInvariant(expr->time->lo))
+                      && (!expr->time->hi || isInvariant(expr->time->hi)));
+
+    //  a witness re-evaluates the deciding operand at a single row, see witness()
+    return  m_options.sweep && nested && global && bounds && !m_witnessing;
+}
+
+void    CompileExprImpl::integral(
+                            ExprInt*                expr,
+                            std::string             name)
+{
+/*
+uint64_t*   integral(prop_t const* frst, prop_t const* last)
+{
+    uint64_t    size    = last - frst;
+    uint64_t*   S       = malloc(2 * (size + 1) * sizeof(uint64_t));    //  area before row k
+    uint64_t*   R       = S + size + 1;                                 //  rate of row k
+
+    S[1]    = 0;
+    R[size] = 0;
+
+    for(k = 1; k < size; k++)
+    {
+        R[k]        = boolean(frst + k) ? eval(frst + k) : 0;
+        S[k + 1]    = S[k] + R[k] * (frst[k + 1].__time__ - frst[k].__time__);
+    }
+
+    return  S;
+}
+
+uint64_t    area(uint64_t c, uint64_t T)
+{
+    T   = min(T, frst[size].__time__);
+    k   = last row in [c, size] such that frst[k].__time__ <= T;   //  binary search
+
+    return  S[k] + R[k] * (T - frst[k].__time__);
+}
+
+The table is filled once per function ahead of its body, see chain(), so the
+integral at row c is area(c, now + hi) - area(c, now + lo) with both bounds
+clamped to [now, ...), instead of a walk over every row inside the window.
+Floating point heights accumulate rounding in S, the difference of two large
+partial sums may differ from the direct sum in the last bits.
+*/
+    auto    frst    = m_frst.front();
+    auto    last    = m_last.front();
+    auto    type    = expr->rhs->type() == Factory<TypeInteger>::create()
+                    ? m_builder->getInt64Ty()
+                    : m_builder->getDoubleTy();
+    auto    zero    = expr->rhs->type() == Factory<TypeInteger>::create()
+                    ? llvm::ConstantInt::getSigned(m_builder->getInt64Ty(), 0)
+                    : llvm::ConstantFP::get(m_builder->getDoubleTy(), 0.0);
+
+    if(m_sweeps.find(expr) == m_sweeps.end())
+    {
+        auto    malloc  = m_module->getOrInsertFunction("malloc", m_builder->getInt8PtrTy(), m_builder->getInt64Ty());
+        auto    save    = m_builder->saveIP();
+
+        auto    bbHead  = llvm::BasicBlock::Create(*m_context, name + "-prefix-head", m_function);
+        auto    bbWhile = llvm::BasicBlock::Create(*m_context, name + "-prefix-while", m_function);
+        auto    bbCondHi= llvm::BasicBlock::Create(*m_context, name + "-prefix-cond", m_function);
+        auto    bbCondLo= bbCondHi;
+        auto    bbRateHi= llvm::BasicBlock::Create(*m_context, name + "-prefix-rate", m_function);
+        auto    bbRateLo= bbRateHi;
+        auto    bbNext  = llvm::BasicBlock::Create(*m_context, name + "-prefix-next", m_function);
+        auto    bbTail  = llvm::BasicBlock::Create(*m_context, name + "-prefix-tail", m_function);
+
+        //  head
+        m_builder->SetInsertPoint(bbHead);
+        auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+        auto    rows    = m_builder->CreateAdd(size, m_p1, "size + 1");
+        auto    bytes   = m_builder->CreateMul(rows, m_builder->getInt64(2 * 8), "bytes");
+        auto    buff    = m_builder->CreateBitCast(
+                            m_builder->CreateCall(malloc, {bytes}),
+                            llvm::PointerType::get(type, 0),
+                            name);
+        auto    rate    = m_builder->CreateGEP(type, buff, rows, "rate");
+        m_builder->CreateStore(zero, m_builder->CreateGEP(type, buff, m_p1));
+        m_builder->CreateStore(zero, m_builder->CreateGEP(type, rate, size));
+        m_builder->CreateBr(bbWhile);
+
+        //  while
+        m_builder->SetInsertPoint(bbWhile);
+        auto    indx    = m_builder->CreatePHI(m_builder->getInt64Ty(), 2, "k");
+        auto    curr    = m_builder->CreateInBoundsGEP(m_propType, frst, indx, "curr");
+        auto    cont    = m_builder->CreateICmpSLT(indx, size, "k < size");
+        m_builder->CreateCondBr(cont, bbCondHi, bbTail);
+
+        //  cond
+        m_builder->SetInsertPoint(bbCondHi);
+        m_curr.push_back(curr);
+        auto    cond    = make(expr->lhs);
+        m_curr.pop_back();
+        bbCondLo        = m_builder->GetInsertBlock();
+        m_builder->CreateCondBr(cond, bbRateHi, bbNext);
+
+        //  rate
+        m_builder->SetInsertPoint(bbRateHi);
+        m_curr.push_back(curr);
+        auto    height  = make(expr->rhs);
+        m_curr.pop_back();
+        bbRateLo        = m_builder->GetInsertBlock();
+        m_builder->CreateBr(bbNext);
+
+        //  next
+        m_builder->SetInsertPoint(bbNext);
+        auto    value   = m_builder->CreatePHI(type, 2, "rate");
+        auto    indx1   = m_builder->CreateAdd(indx, m_p1, "k + 1");
+        auto    length  = m_builder->CreateSub(getTime(frst, indx1, "next->__time__"), getTime(curr), "length");
+        auto    before  = m_builder->CreateLoad(type, m_builder->CreateGEP(type, buff, indx));
+        m_builder->CreateStore(value, m_builder->CreateGEP(type, rate, indx));
+        m_builder->CreateStore(add(before, mul(value, length, "volume"), "area"), m_builder->CreateGEP(type, buff, indx1));
+        m_builder->CreateBr(bbWhile);
+
+        //  tail
+        m_builder->SetInsertPoint(bbTail);
+        chain(bbHead, bbTail);
+
+        //  link
+        indx->addIncoming(m_p1,  bbHead);
+        indx->addIncoming(indx1, bbNext);
+
+        value->addIncoming(zero,   bbCondLo);
+        value->addIncoming(height, bbRateLo);
+
+        m_builder->restoreIP(save);
+        m_sweeps[expr]  = buff;
+    }
+
+    auto    buff    = m_sweeps[expr];
+    auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+    auto    rate    = m_builder->CreateGEP(type, buff, m_builder->CreateAdd(size, m_p1), "rate");
+    auto    indx    = m_builder->CreatePtrDiff(m_propType, m_curr.back(), frst, "curr - frst");
+    auto    now     = getTime(m_curr.back());
+    auto    end     = getTime(last);
+
+    auto    area    = [&](llvm::Value* time, std::string const& name)
+    {
+        time    = m_builder->CreateSelect(m_builder->CreateICmpSLT(time, end), time, end);
+
+        auto    k   = search(time, indx, m_builder->CreateAdd(size, m_p1), name);
+        auto    s   = m_builder->CreateLoad(type, m_builder->CreateGEP(type, buff, k));
+        auto    r   = m_builder->CreateLoad(type, m_builder->CreateGEP(type, rate, k));
+
+        return  add(s, mul(r, m_builder->CreateSub(time, getTime(frst, k, "row->__time__")), "volume"), name);
+    };
+
+    llvm::Value*    timeLo  = now;
+    if(expr->time && expr->time->lo)
+    {
+        timeLo  = m_builder->CreateAdd(now, make(expr->time->lo), "now + lo");
+        timeLo  = m_builder->CreateSelect(m_builder->CreateICmpSLT(now, timeLo), timeLo, now);
+    }
+
+    auto    areaLo  = area(timeLo, "area@lo");
+    llvm::Value*    areaHi  = m_builder->CreateLoad(type, m_builder->CreateGEP(type, buff, size), "area@end");
+    if(expr->time && expr->time->hi)
+    {
+        auto    timeHi  = m_builder->CreateAdd(now, make(expr->time->hi), "now + hi");
+        timeHi  = m_builder->CreateSelect(m_builder->CreateICmpSLT(timeLo, timeHi), timeHi, timeLo);
+        areaHi  = area(timeHi, "area@hi");
+    }
+
+    m_value = sub(areaHi, areaLo, name);
+}
+
+llvm::Value*    CompileExprImpl::search(
+                            llvm::Value*            time,
+                            llvm::Value*            lo,
+                            llvm::Value*            hi,
+                            std::string             name)
+{
+/*
+    //  frst[lo].__time__ <= time, the result is the last row k in [lo, hi) with frst[k].__time__ <= time
+    while(hi - lo > 1)
+    {
+        mid = lo + (hi - lo) / 2;
+        if(frst[mid].__time__ <= time)
+            lo  = mid;
+        else
+            hi  = mid;
+    }
+
+    return  lo;
+*/
+    auto    frst    = m_frst.front();
+    auto    bbEntry = m_builder->GetInsertBlock();
+    auto    bbWhile = llvm::BasicBlock::Create(*m_context, name + "-search-while", m_function);
+    auto    bbBody  = llvm::BasicBlock::Create(*m_context, name + "-search-body", m_function);
+    auto    bbTail  = llvm::BasicBlock::Create(*m_context, name + "-search-tail", m_function);
+
+    m_builder->CreateBr(bbWhile);
+
+    //  while
+    m_builder->SetInsertPoint(bbWhile);
+    auto    loHead  = m_builder->CreatePHI(lo->getType(), 2, "lo");
+    auto    hiHead  = m_builder->CreatePHI(hi->getType(), 2, "hi");
+    auto    span    = m_builder->CreateSub(hiHead, loHead, "hi - lo");
+    m_builder->CreateCondBr(m_builder->CreateICmpSGT(span, m_p1, "hi - lo > 1"), bbBody, bbTail);
+
+    //  body
+    m_builder->SetInsertPoint(bbBody);
+    auto    mid     = m_builder->CreateAdd(loHead, m_builder->CreateLShr(span, 1), "mid");
+    auto    midLE   = m_builder->CreateICmpSLE(getTime(frst, mid, "mid->__time__"), time, "mid->__time__ <= time");
+    auto    loBody  = m_builder->CreateSelect(midLE, mid, loHead);
+    auto    hiBody  = m_builder->CreateSelect(midLE, hiHead, mid);
+    m_builder->CreateBr(bbWhile);
+
+    //  tail
+    m_builder->SetInsertPoint(bbTail);
+
+    //  link
+    loHead->addIncoming(lo,     bbEntry);
+    loHead->addIncoming(loBody, bbBody);
+    hiHead->addIncoming(hi,     bbEntry);
+    hiHead->addIncoming(hiBody, bbBody);
+
+    return  loHead;
+}
+
+void    CompileExprImpl::bits(
+                            Temporal<ExprBinary>*   expr,
+                            llvm::Value*            rhsV,
+                            llvm::Value*            lhsV,
+                            llvm::Value*            endV,
+                            bool                    past,
+                            std::string             name)
+{
+    auto    frst    = m_frst.front();
+    auto    words   = carry(expr, rhsV, lhsV, endV, past, name);
+    auto    indx    = m_builder->CreatePtrDiff(m_propType, m_curr.back(), frst, "curr - frst");
+    auto    packed  = m_builder->CreateLoad(m_builder->getInt64Ty(), m_builder->CreateGEP(m_builder->getInt64Ty(), words, m_builder->CreateLShr(indx, 6)));
+    auto    shifted = m_builder->CreateLShr(packed, m_builder->CreateAnd(indx, 63));
+
+    m_value = m_builder->CreateTrunc(shifted, m_boolType, name);
+}
+
+llvm::Value*    CompileExprImpl::carry(
+                            Temporal<ExprBinary>*   expr,
+                            llvm::Value*            rhsV,
+                            llvm::Value*            lhsV,
+                            llvm::Value*            endV,
+                            bool                    past,
+                            std::string             name)
+{
+/*
+uint64_t*   carry(prop_t const* frst, prop_t const* last, bool lhsV, bool rhsV, bool endV)
+{
+    uint64_t    size    = last - frst;
+    uint64_t    count   = (size >> 6) + 1;
+    uint64_t*   W       = malloc(count * sizeof(uint64_t));    //  bit k of W[k >> 6] is the verdict at row k
+    uint64_t    c       = 0;
+
+    //  Q[k] = (V[k] == rhsV) follows Q[k] = G[k] | (P[k] & Q[k + 1]) with
+    //  G = (rhs == rhsV) and P = (lhs != lhsV), which is the carry chain of
+    //  G + (G | P), so 64 rows are resolved by one addition.  U/R run it on
+    //  bit reversed words from the last word down, S/T on plain words with
+    //  Q[k - 1] in place of Q[k + 1] from the first word up.
+
+    for(w = count - 1; w >= 0; w--)
+    {
+        R   = 0;
+        L   = 0;
+        for(k = max(w * 64, 1); k < min(w * 64 + 64, size); k++)
+        {
+            R   |= (uint64_t)eval(frst + k, rhs) << (k & 63);
+            L   |= (uint64_t)eval(frst + k, lhs) << (k & 63);
+        }
+
+        G   = rhsV ? R : ~R;
+        P   = lhsV ? ~L : L;
+
+        //  rows from size on hold endV, S/T use row 0 instead
+        B   = w == count - 1 ? ~0 << (size & 63) : 0;
+        G   = G & ~B | (endV == rhsV ? B : 0);
+        P   = P & ~B;
+
+        g   = reverse(G);
+        p   = reverse(P);
+        x   = (g + (g | p) + c) ^ g ^ (g | p);         //  carry into every bit
+        c   = g >> 63 | (p >> 63 & x >> 63);            //  carry out of the word
+        Q   = reverse(x >> 1 | c << 63);
+
+        W[w]    = rhsV ? Q : ~Q;
+    }
+
+    return  W;
+}
+
+The words are filled once per function ahead of its body, see chain(), and
+the verdict at row k is just W[k >> 6] >> (k & 63).  Constant operands are
+folded into R and L, operands that are untimed U/R/S/T themselves are read
+word by word from their own W, see pack().  With Layout::columns the words
+that lie fully inside [1, size) take R and L built from column atoms as one
+64 lane compare over the columns instead of the row loop, see lanes().
+*/
+    if(m_packs.find(expr) != m_packs.end())
+    {
+        return  m_packs[expr];
+    }
+
+    auto    frst    = m_frst.front();
+    auto    last    = m_last.front();
+    auto    wordType= m_builder->getInt64Ty();
+    auto    malloc  = m_module->getOrInsertFunction("malloc", m_builder->getInt8PtrTy(), wordType);
+    auto    isT     = [](llvm::Value* value) {return llvm::cast<llvm::ConstantInt>(value)->isOne();};
+    auto    zero    = m_builder->getInt64(0);
+    auto    ones    = m_builder->getInt64(~0ull);
+    llvm::Value*    qEnd    = isT(endV) == isT(rhsV) ? ones : zero;
+
+    auto    rhsC    = dynamic_cast<ExprConstT<bool>*>(expr->rhs);
+    auto    lhsC    = dynamic_cast<ExprConstT<bool>*>(expr->lhs);
+    auto    rhsW    = rhsC ? nullptr : pack(expr->rhs);
+    auto    lhsW    = lhsC ? nullptr : pack(expr->lhs);
+    auto    save    = m_builder->saveIP();
+
+    auto    bbHead  = llvm::BasicBlock::Create(*m_context, name + "-carry-head", m_function);
+    auto    bbWhile = llvm::BasicBlock::Create(*m_context, name + "-carry-while", m_function);
+    auto    bbFill  = llvm::BasicBlock::Create(*m_context, name + "-carry-fill", m_function);
+    auto    bbRowsHi= llvm::BasicBlock::Create(*m_context, name + "-carry-rows", m_function);
+    auto    bbRowHi = llvm::BasicBlock::Create(*m_context, name + "-carry-row", m_function);
+    auto    bbRowLo = bbRowHi;
+    auto    bbBody  = llvm::BasicBlock::Create(*m_context, name + "-carry-body", m_function);
+    auto    bbTail  = llvm::BasicBlock::Create(*m_context, name + "-carry-tail", m_function);
+
+    //  bitcast of <64 x i1> puts lane k at bit k only on little endian targets
+    auto    rhsL    = m_cols && !rhsC && !rhsW && m_module->getDataLayout().isLittleEndian() && columnar(expr->rhs);
+    auto    lhsL    = m_cols && !lhsC && !lhsW && m_module->getDataLayout().isLittleEndian() && columnar(expr->lhs);
+    auto    bbWide  = (rhsL || lhsL) && (rhsL || rhsC || rhsW) && (lhsL || lhsC || lhsW)
+                    ? llvm::BasicBlock::Create(*m_context, name + "-carry-wide", m_function)
+                    : nullptr;
+
+    //  head
+    m_builder->SetInsertPoint(bbHead);
+    auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+    auto    count   = m_builder->CreateAdd(m_builder->CreateLShr(size, 6), m_p1, "count");
+    auto    buff    = m_builder->CreateBitCast(
+                        m_builder->CreateCall(malloc, {m_builder->CreateMul(count, m_builder->getInt64(8))}),
+                        llvm::PointerType::get(wordType, 0),
+                        name);
+    auto    indx0   = past ? m_0 : m_builder->CreateSub(count, m_p1);
+    auto    edge    = past ? m_0 : m_builder->CreateSub(count, m_p1);
+    auto    mask    = past ? m_p1 : m_builder->CreateShl(ones, m_builder->CreateAnd(size, 63));
+
+    //  in a chunk the rows before lo (S/T) or from hi on (U/R) belong to
+    //  the neighbour and hold the value carried in from it
+    unsigned        ord     = 0;
+    llvm::Value*    outer   = nullptr;
+    if(m_lo)
+    {
+        ord     = seam(expr, past);
+        outer   = past
+                ? m_builder->CreateICmpSLE(m_lo, m_p1, "lo <= 1")
+                : m_builder->CreateICmpSGE(m_hi, size, "hi >= size");
+        auto    carry   = carryIn(ord, past, endV, size);
+        qEnd    = m_builder->CreateSExt(isT(rhsV) ? carry : m_builder->CreateNot(carry), wordType);
+    }
+    m_builder->CreateBr(bbWhile);
+
+    //  while
+    m_builder->SetInsertPoint(bbWhile);
+    auto    indx    = m_builder->CreatePHI(wordType, 2, "w");
+    auto    cin     = m_builder->CreatePHI(wordType, 2, "c");
+    auto    decided = m_lo ? m_builder->CreatePHI(wordType, 2, "decided") : nullptr;
+    auto    cont    = past
+                    ? m_builder->CreateICmpSLT(indx, count, "w < count")
+                    : m_builder->CreateICmpSGE(indx, m_0, "w >= 0");
+    m_builder->CreateCondBr(cont, bbFill, bbTail);
+
+    //  fill
+    m_builder->SetInsertPoint(bbFill);
+    auto    base    = m_builder->CreateShl(indx, 6, "w * 64");
+    auto    rowLo   = m_builder->CreateSelect(m_builder->CreateICmpSLT(base, m_p1), m_p1, base);
+    auto    rowHi   = m_builder->CreateAdd(base, m_builder->getInt64(64));
+    rowHi   = m_builder->CreateSelect(m_builder->CreateICmpSLT(rowHi, size), rowHi, size);
+    if(bbWide)
+    {
+        auto    full    = m_builder->CreateAnd(
+                            m_builder->CreateICmpEQ(rowLo, base),
+                            m_builder->CreateICmpEQ(rowHi, m_builder->CreateAdd(base, m_builder->getInt64(64))),
+                            "full");
+        m_builder->CreateCondBr(full, bbWide, bbRowsHi);
+    }
+    else
+    {
+        m_builder->CreateBr(bbRowsHi);
+    }
+
+    //  wide
+    llvm::Value*    rhsWide = zero;
+    llvm::Value*    lhsWide = zero;
+    if(bbWide)
+    {
+        m_builder->SetInsertPoint(bbWide);
+        if(rhsL)
+        {
+            rhsWide = m_builder->CreateBitCast(lanes(expr->rhs, base), wordType, "R");
+        }
+        if(lhsL)
+        {
+            lhsWide = m_builder->CreateBitCast(lanes(expr->lhs, base), wordType, "L");
+        }
+        m_builder->CreateBr(bbBody);
+    }
+
+    //  rows
+    m_builder->SetInsertPoint(bbRowsHi);
+    auto    row     = m_builder->CreatePHI(wordType, 2, "k");
+    auto    rhsRows = m_builder->CreatePHI(wordType, 2, "R");
+    auto    lhsRows = m_builder->CreatePHI(wordType, 2, "L");
+    m_builder->CreateCondBr(m_builder->CreateICmpSLT(row, rowHi, "k < hi"), bbRowHi, bbBody);
+
+    //  row
+    m_builder->SetInsertPoint(bbRowHi);
+    auto    shift   = m_builder->CreateAnd(row, 63);
+    llvm::Value*    rhsRow  = rhsRows;
+    llvm::Value*    lhsRow  = lhsRows;
+    m_curr.push_back(m_builder->CreateInBoundsGEP(m_propType, frst, row, "curr"));
+    if(!rhsC && !rhsW)
+    {
+        rhsRow  = m_builder->CreateOr(rhsRows, m_builder->CreateShl(m_builder->CreateZExt(make(expr->rhs), wordType), shift));
+    }
+    if(!lhsC && !lhsW)
+    {
+        lhsRow  = m_builder->CreateOr(lhsRows, m_builder->CreateShl(m_builder->CreateZExt(make(expr->lhs), wordType), shift));
+    }
+    m_curr.pop_back();
+    auto    row1    = m_builder->CreateAdd(row, m_p1, "k + 1");
+    bbRowLo = m_builder->GetInsertBlock();
+    m_builder->CreateBr(bbRowsHi);
+
+    //  body
+    m_builder->SetInsertPoint(bbBody);
+    //  R and L come from the row loop or from the wide block
+    auto    merge   = [&](llvm::Value* rows, llvm::Value* wide) -> llvm::Value*
+    {
+        if(!bbWide)
+            return  rows;
+
+        auto    either  = m_builder->CreatePHI(wordType, 2, rows->getName());
+
+        either->addIncoming(rows, bbRowsHi);
+        either->addIncoming(wide, bbWide);
+
+        return  either;
+    };
+    auto    rhsBoth = merge(rhsRows, rhsWide);
+    auto    lhsBoth = merge(lhsRows, lhsWide);
+    auto    operand = [&](ExprConstT<bool>* constant, llvm::Value* words, llvm::Value* rows) -> llvm::Value*
+    {
+        if(constant)
+            return  constant->value ? ones : zero;
+
+        if(words)
+            return  m_builder->CreateLoad(wordType, m_builder->CreateGEP(wordType, words, indx));
+
+        return  rows;
+    };
+    auto    rhs     = operand(rhsC, rhsW, rhsBoth);
+    auto    lhs     = operand(lhsC, lhsW, lhsBoth);
+    auto    gen     = isT(rhsV) ? rhs : m_builder->CreateNot(rhs);
+    auto    prop    = isT(lhsV) ? m_builder->CreateNot(lhs) : lhs;
+    auto    bound   = m_builder->CreateSelect(m_builder->CreateICmpEQ(indx, edge), mask, zero, "B");
+    llvm::Value*    decided1= decided;
+    if(m_lo)
+    {
+        //  bits of the rows of w below limit
+        auto    below   = [&](llvm::Value* limit)
+        {
+            auto    word    = m_builder->CreateAShr(limit, 6);
+            auto    part    = m_builder->CreateNot(m_builder->CreateShl(ones, m_builder->CreateAnd(limit, 63)));
+
+            return  m_builder->CreateSelect(
+                        m_builder->CreateICmpSLT(indx, word),
+                        ones,
+                        m_builder->CreateSelect(m_builder->CreateICmpEQ(indx, word), part, zero));
+        };
+        auto    range   = m_builder->CreateAnd(m_builder->CreateNot(below(m_lo)), below(m_hi), "lo <= k < hi");
+
+        bound       = past ? below(m_lo) : m_builder->CreateNot(below(m_hi), "B");
+        decided1    = m_builder->CreateOr(decided, m_builder->CreateAnd(m_builder->CreateOr(gen, m_builder->CreateNot(prop)), range));
+    }
+    gen     = m_builder->CreateOr(m_builder->CreateAnd(gen, m_builder->CreateNot(bound)), m_builder->CreateAnd(bound, qEnd), "G");
+    prop    = m_builder->CreateAnd(prop, m_builder->CreateNot(bound), "P");
+    if(!past)
+    {
+        gen     = m_builder->CreateUnaryIntrinsic(llvm::Intrinsic::bitreverse, gen);
+        prop    = m_builder->CreateUnaryIntrinsic(llvm::Intrinsic::bitreverse, prop);
+    }
+    auto    either  = m_builder->CreateOr(gen, prop);
+    auto    sum     = m_builder->CreateAdd(m_builder->CreateAdd(gen, either), cin, "g + (g | p) + c");
+    auto    into    = m_builder->CreateXor(m_builder->CreateXor(sum, gen), either, "carry in");
+    auto    top     = m_builder->CreateOr(
+                        m_builder->CreateLShr(gen, 63),
+                        m_builder->CreateAnd(m_builder->CreateLShr(prop, 63), m_builder->CreateLShr(into, 63)),
+                        "carry out");
+    llvm::Value*    value   = m_builder->CreateOr(m_builder->CreateLShr(into, 1), m_builder->CreateShl(top, 63), "Q");
+    if(!past)
+    {
+        value   = m_builder->CreateUnaryIntrinsic(llvm::Intrinsic::bitreverse, value);
+    }
+    if(!isT(rhsV))
+    {
+        value   = m_builder->CreateNot(value);
+    }
+    m_builder->CreateStore(value, m_builder->CreateGEP(wordType, buff, indx));
+    auto    indx1   = past
+                    ? m_builder->CreateAdd(indx, m_p1, "w + 1")
+                    : m_builder->CreateSub(indx, m_p1, "w - 1");
+    m_builder->CreateBr(bbWhile);
+
+    //  tail
+    m_builder->SetInsertPoint(bbTail);
+    if(m_lo)
+    {
+        auto    at      = past ? m_builder->CreateSub(m_hi, m_p1) : m_lo;
+        auto    word    = m_builder->CreateLoad(wordType, m_builder->CreateGEP(wordType, buff, m_builder->CreateAShr(at, 6)));
+        auto    value   = m_builder->CreateTrunc(m_builder->CreateLShr(word, m_builder->CreateAnd(at, 63)), m_boolType);
+        summarize(ord, value, m_builder->CreateOr(m_builder->CreateICmpNE(decided, zero), outer));
+    }
+    chain(bbHead, bbTail);
+
+    //  link
+    indx->addIncoming(indx0, bbHead);
+    indx->addIncoming(indx1, bbBody);
+
+    cin->addIncoming(zero, bbHead);
+    cin->addIncoming(top,  bbBody);
+
+    if(m_lo)
+    {
+        decided->addIncoming(zero, bbHead);
+        decided->addIncoming(decided1, bbBody);
+    }
+
+    row->addIncoming(rowLo, bbFill);
+    row->addIncoming(row1,  bbRowLo);
+
+    rhsRows->addIncoming(zero,   bbFill);
+    rhsRows->addIncoming(rhsRow, bbRowLo);
+
+    lhsRows->addIncoming(zero,   bbFill);
+    lhsRows->addIncoming(lhsRow, bbRowLo);
+
+    m_builder->restoreIP(save);
+    m_packs[expr]   = buff;
+
+    return  buff;
+}
+
+llvm::Value*    CompileExprImpl::pack(Expr* expr)
+{
+    auto    temporal    = dynamic_cast<Temporal<ExprBinary>*>(expr);
+
+    //  a shared operand is read row by row from its buffer
+    if(!temporal || (temporal->time && (temporal->time->lo || temporal->time->hi)) || shares(expr))
+    {
+        return  nullptr;
+    }
+
+    if(dynamic_cast<ExprUs*>(expr)) return  carry(temporal, m_T, m_F, m_F, false, "Us");
+    if(dynamic_cast<ExprUw*>(expr)) return  carry(temporal, m_T, m_F, m_T, false, "Uw");
+    if(dynamic_cast<ExprRs*>(expr)) return  carry(temporal, m_F, m_T, m_F, false, "Rs");
+    if(dynamic_cast<ExprRw*>(expr)) return  carry(temporal, m_F, m_T, m_T, false, "Rw");
+    if(dynamic_cast<ExprSs*>(expr)) return  carry(temporal, m_T, m_F, m_F, true,  "Ss");
+    if(dynamic_cast<ExprSw*>(expr)) return  carry(temporal, m_T, m_F, m_T, true,  "Sw");
+    if(dynamic_cast<ExprTs*>(expr)) return  carry(temporal, m_F, m_T, m_F, true,  "Ts");
+    if(dynamic_cast<ExprTw*>(expr)) return  carry(temporal, m_F, m_T, m_T, true,  "Tw");
+
+    return  nullptr;
+}
+
+bool    CompileExprImpl::columnar(Expr* expr)
+{
+    auto    scalar  = [](Type* type)
+    {
+        return  type == Factory<TypeBoolean>::create()
+            ||  type == Factory<TypeInteger>::create()
+            ||  type == Factory<TypeNumber>::create();
+    };
+
+    if(auto paren = dynamic_cast<ExprParen*>(expr))
+    {
+        return  columnar(paren->arg);
+    }
+
+    if(auto data = dynamic_cast<ExprData*>(expr))
+    {
+        auto    ctxt    = dynamic_cast<ExprContext*>(data->ctxt);
+
+        return  ctxt && ctxt->name == "__curr__" && data->name != "__time__" && scalar(data->type());
+    }
+
+    if(auto unary = dynamic_cast<ExprNot*>(expr))
+    {
+        return  columnar(unary->arg);
+    }
+
+    if(dynamic_cast<ExprAnd*>(expr) || dynamic_cast<ExprOr*>(expr)
+    || dynamic_cast<ExprEq*>(expr)  || dynamic_cast<ExprNe*>(expr)
+    || dynamic_cast<ExprLt*>(expr)  || dynamic_cast<ExprLe*>(expr)
+    || dynamic_cast<ExprGt*>(expr)  || dynamic_cast<ExprGe*>(expr))
+    {
+        auto    binary  = dynamic_cast<ExprBinary*>(expr);
+
+        return  scalar(binary->lhs->type()) && scalar(binary->rhs->type()) && columnar(binary->lhs) && columnar(binary->rhs);
+    }
+
+    return  dynamic_cast<ExprConstBoolean*>(expr)
+        ||  dynamic_cast<ExprConstInteger*>(expr)
+        ||  dynamic_cast<ExprConstNumber*>(expr);
+}
+
+llvm::Value*    CompileExprImpl::lanes(Expr* expr, llvm::Value* base)
+{
+/*
+    the 64 rows from base of an expression accepted by columnar(), lane k
+    holds the value at row base + k, so a boolean becomes <64 x i1>
+*/
+    const unsigned  width   = 64;
+
+    if(auto paren = dynamic_cast<ExprParen*>(expr))
+    {
+        return  lanes(paren->arg, base);
+    }
+
+    if(auto data = dynamic_cast<ExprData*>(expr))
+    {
+        auto    colsType    = cast<llvm::PointerType>(m_cols->getType())->getPointerElementType();
+        auto    colPtr      = m_builder->CreateStructGEP(colsType, m_cols, dynamic_cast<TypeContext*>(data->ctxt->type())->index(data->name));
+        auto    colType     = cast<llvm::PointerType>(cast<llvm::PointerType>(colPtr->getType())->getPointerElementType());
+        auto    propType    = colType->getPointerElementType();
+        auto    ptr         = m_builder->CreateGEP(propType, m_builder->CreateLoad(colType, colPtr, false, "col_" + data->name), base, "ptr_" + data->name);
+
+        if(propType != m_boolType)
+        {
+            auto    vecType     = llvm::FixedVectorType::get(propType, width);
+
+            return  m_builder->CreateAlignedLoad(
+                        vecType,
+                        m_builder->CreateBitCast(ptr, llvm::PointerType::get(vecType, 0)),
+                        m_module->getDataLayout().getABITypeAlign(propType),
+                        "vec_" + data->name);
+        }
+
+        //  booleans are held as bytes, see getProp()
+        auto    byteType    = llvm::FixedVectorType::get(m_builder->getInt8Ty(), width);
+        auto    bytes       = m_builder->CreateAlignedLoad(
+                                byteType,
+                                m_builder->CreateBitCast(ptr, llvm::PointerType::get(byteType, 0)),
+                                llvm::Align(1),
+                                "vec_" + data->name + ".byte");
+
+        return  m_builder->CreateICmpNE(bytes, llvm::Constant::getNullValue(byteType), "vec_" + data->name);
+    }
+
+    if(auto unary = dynamic_cast<ExprNot*>(expr))
+    {
+        return  m_builder->CreateNot(lanes(unary->arg, base));
+    }
+
+    if(dynamic_cast<ExprAnd*>(expr) || dynamic_cast<ExprOr*>(expr))
+    {
+        auto    binary  = dynamic_cast<ExprBinary*>(expr);
+        auto    lhs     = lanes(binary->lhs, base);
+        auto    rhs     = lanes(binary->rhs, base);
+
+        //  both sides are plain loads, nothing to short circuit
+        return  dynamic_cast<ExprAnd*>(expr)
+                ? m_builder->CreateAnd(lhs, rhs)
+                : m_builder->CreateOr(lhs, rhs);
+    }
+
+    if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        auto    ipred   = llvm::CmpInst::Predicate::ICMP_EQ;
+        auto    fpred   = llvm::CmpInst::Predicate::FCMP_OEQ;
+
+        if(dynamic_cast<ExprNe*>(expr)) {ipred = llvm::CmpInst::Predicate::ICMP_NE;  fpred = llvm::CmpInst::Predicate::FCMP_ONE;}
+        if(dynamic_cast<ExprLt*>(expr)) {ipred = llvm::CmpInst::Predicate::ICMP_SLT; fpred = llvm::CmpInst::Predicate::FCMP_OLT;}
+        if(dynamic_cast<ExprLe*>(expr)) {ipred = llvm::CmpInst::Predicate::ICMP_SLE; fpred = llvm::CmpInst::Predicate::FCMP_OLE;}
+        if(dynamic_cast<ExprGt*>(expr)) {ipred = llvm::CmpInst::Predicate::ICMP_SGT; fpred = llvm::CmpInst::Predicate::FCMP_OGT;}
+        if(dynamic_cast<ExprGe*>(expr)) {ipred = llvm::CmpInst::Predicate::ICMP_SGE; fpred = llvm::CmpInst::Predicate::FCMP_OGE;}
+
+        auto    lhs     = lanes(binary->lhs, base);
+        auto    rhs     = lanes(binary->rhs, base);
+        auto    number  = Factory<TypeNumber>::create();
+
+        //  the same promotions as compare()
+        if(binary->lhs->type() != number && binary->rhs->type() != number)
+        {
+            return  m_builder->CreateICmp(ipred, lhs, rhs);
+        }
+        if(binary->lhs->type() != number)
+        {
+            lhs = m_builder->CreateSIToFP(lhs, rhs->getType());
+        }
+        if(binary->rhs->type() != number)
+        {
+            rhs = m_builder->CreateSIToFP(rhs, lhs->getType());
+        }
+
+        return  m_builder->CreateFCmp(fpred, lhs, rhs);
+    }
+
+    //  constants
+    return  m_builder->CreateVectorSplat(width, make(expr));
+}
+
+void    CompileExprImpl::slideUR(
+                            Temporal<ExprBinary>*   expr,
+                            llvm::Value*            rhsV,
+                            llvm::Value*            lhsV,
+                            llvm::Value*            endV,
+                            std::string             name)
+{
+/*
+bool*   slideUR(prop_t const* frst, prop_t const* last, uint64_t lo, uint64_t hi, bool lhsV, bool rhsV, bool endV)
+{
+    uint64_t    size    = last - frst;
+    bool*       V       = malloc(size + 1);
+    uint64_t*   N       = malloc(size + 1);     //  first decisive row at or after k
+
+    N[size] = size;
+
+    for(k = size - 1; k > 0; k--)
+    {
+        if(frst[k].__time__ < frst[k + 1].__time__ && eval(frst + k, rhs) == rhsV)
+            V[k] = rhsV, N[k] = k;
+        else if(frst[k].__time__ < frst[k + 1].__time__ && eval(frst + k, lhs) == lhsV)
+            V[k] = lhsV, N[k] = k;
+        else
+            N[k] = N[k + 1];
+    }
+
+    for(c = 1, p = 1; c < size; c++)
+    {
+        //  p is the first row whose interval ends after now + lo, it never moves back
+        p   = max(p, c);
+        while(p < size && frst[p + 1].__time__ <= frst[c].__time__ + lo)
+            p++;
+
+        n   = N[p];
+
+        //  V[n] is read before V[c] is overwritten, n >= c
+        V[c]    = n < size && max(frst[n].__time__, now + lo) < min(now + hi, frst[n + 1].__time__)
+                ? V[n]
+                : endV;
+    }
+
+    free(N);
+
+    return  V;
+}
+*/
+    auto    frst        = m_frst.front();
+    auto    last        = m_last.front();
+    auto    indxType    = m_builder->getInt64Ty();
+    auto    indxPtrType = llvm::PointerType::get(indxType, 0);
+    auto    boolPtrType = llvm::PointerType::get(m_boolType, 0);
+
+    if(m_sweeps.find(expr) == m_sweeps.end())
+    {
+        auto    malloc  = m_module->getOrInsertFunction("malloc", m_builder->getInt8PtrTy(), indxType);
+        auto    free    = m_module->getOrInsertFunction("free", m_builder->getVoidTy(), m_builder->getInt8PtrTy());
+        auto    save    = m_builder->saveIP();
+
+        auto    bbHead      = llvm::BasicBlock::Create(*m_context, name + "-slide-head", m_function);
+        auto    bbFill      = llvm::BasicBlock::Create(*m_context, name + "-slide-fill", m_function);
+        auto    bbFillLen   = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-len", m_function);
+        auto    bbFillRhsHi = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-rhs", m_function);
+        auto    bbFillRhsLo = bbFillRhsHi;
+        auto    bbFillLhsHi = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-lhs", m_function);
+        auto    bbFillLhsLo = bbFillLhsHi;
+        auto    bbFillNext  = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-next", m_function);
+        auto    bbScan      = llvm::BasicBlock::Create(*m_context, name + "-slide-scan", m_function);
+        auto    bbScanBody  = llvm::BasicBlock::Create(*m_context, name + "-slide-scan-body", m_function);
+        auto    bbSkip      = expr->time->lo ? llvm::BasicBlock::Create(*m_context, name + "-slide-skip", m_function) : nullptr;
+        auto    bbSkipTest  = expr->time->lo ? llvm::BasicBlock::Create(*m_context, name + "-slide-skip-test", m_function) : nullptr;
+        auto    bbSkipNext  = expr->time->lo ? llvm::BasicBlock::Create(*m_context, name + "-slide-skip-next", m_function) : nullptr;
+        auto    bbFind      = llvm::BasicBlock::Create(*m_context, name + "-slide-find", m_function);
+        auto    bbFound     = llvm::BasicBlock::Create(*m_context, name + "-slide-found", m_function);
+        auto    bbScanNext  = llvm::BasicBlock::Create(*m_context, name + "-slide-scan-next", m_function);
+        auto    bbTail      = llvm::BasicBlock::Create(*m_context, name + "-slide-tail", m_function);
+
+        //  head
+        m_builder->SetInsertPoint(bbHead);
+        auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+        auto    count   = m_builder->CreateAdd(size, m_p1);
+        auto    bytes   = m_builder->CreateMul(count, llvm::ConstantInt::get(indxType, 8));
+        auto    buff    = m_builder->CreateBitCast(m_builder->CreateCall(malloc, {count}), boolPtrType, name);
+        auto    next    = m_builder->CreateBitCast(m_builder->CreateCall(malloc, {bytes}), indxPtrType, "next");
+        auto    lo      = expr->time->lo ? make(expr->time->lo) : nullptr;
+        auto    hi      = expr->time->hi ? make(expr->time->hi) : nullptr;
+        m_builder->CreateStore(size, m_builder->CreateGEP(indxType, next, size));
+        auto    fill0   = m_builder->CreateSub(size, m_p1);
+        m_builder->CreateBr(bbFill);
+
+        //  fill
+        m_builder->SetInsertPoint(bbFill);
+        auto    fill    = m_builder->CreatePHI(indxType, 2, "k");
+        auto    fillGT0 = m_builder->CreateICmpSGT(fill, m_0, "k > 0");
+        m_builder->CreateCondBr(fillGT0, bbFillLen, bbScan);
+
+        //  fill len
+        m_builder->SetInsertPoint(bbFillLen);
+        auto    fill1   = m_builder->CreateAdd(fill, m_p1, "k + 1");
+        auto    fillT0  = getTime(frst, fill,  "frst[k].__time__");
+        auto    fillT1  = getTime(frst, fill1, "frst[k + 1].__time__");
+        m_builder->CreateCondBr(m_builder->CreateICmpSLT(fillT0, fillT1), bbFillRhsHi, bbFillNext);
+
+        //  fill rhs
+        m_builder->SetInsertPoint(bbFillRhsHi);
+        m_curr.push_back(m_builder->CreateInBoundsGEP(m_propType, frst, fill, "curr"));
+        auto    rhs     = make(expr->rhs);
+        auto    rhsCond = m_builder->CreateCmp(llvm::CmpInst::Predicate::ICMP_EQ, rhs, rhsV);
+        bbFillRhsLo = m_builder->GetInsertBlock();
+        m_builder->CreateCondBr(rhsCond, bbFillNext, bbFillLhsHi);
+
+        //  fill lhs
+        m_builder->SetInsertPoint(bbFillLhsHi);
+        auto    lhs     = make(expr->lhs);
+        m_curr.pop_back();
+        auto    lhsCond = m_builder->CreateCmp(llvm::CmpInst::Predicate::ICMP_EQ, lhs, lhsV);
+        bbFillLhsLo = m_builder->GetInsertBlock();
+        m_builder->CreateBr(bbFillNext);
+
+        //  fill next
+        m_builder->SetInsertPoint(bbFillNext);
+        auto    hit     = m_builder->CreatePHI(m_boolType, 3, "hit");
+        auto    value   = m_builder->CreatePHI(m_boolType, 3, "value");
+        auto    later   = m_builder->CreateLoad(indxType, m_builder->CreateGEP(indxType, next, fill1), "N[k + 1]");
+        m_builder->CreateStore(value, m_builder->CreateGEP(m_boolType, buff, fill));
+        m_builder->CreateStore(m_builder->CreateSelect(hit, fill, later), m_builder->CreateGEP(indxType, next, fill));
+        auto    fillN   = m_builder->CreateSub(fill, m_p1, "k - 1");
+        m_builder->CreateBr(bbFill);
+
+        //  scan
+        m_builder->SetInsertPoint(bbScan);
+        auto    scan    = m_builder->CreatePHI(indxType, 2, "c");
+        auto    skip    = m_builder->CreatePHI(indxType, 2, "p");
+        auto    scanLTsize  = m_builder->CreateICmpSLT(scan, size, "c < size");
+        m_builder->CreateCondBr(scanLTsize, bbScanBody, bbTail);
+
+        //  scan body
+        m_builder->SetInsertPoint(bbScanBody);
+        auto    now     = getTime(frst, scan, "now");
+        auto    timeLo  = lo ? m_builder->CreateAdd(now, lo, "now + lo") : nullptr;
+        auto    timeHi  = hi ? m_builder->CreateAdd(now, hi, "now + hi") : nullptr;
+        auto    skip0   = m_builder->CreateSelect(m_builder->CreateICmpSLT(skip, scan), scan, skip, "max(p, c)");
+        m_builder->CreateBr(timeLo ? bbSkip : bbFind);
+
+        llvm::PHINode*  skipP   = nullptr;
+        llvm::Value*    skipN   = nullptr;
+        if(timeLo)
+        {
+            //  skip
+            m_builder->SetInsertPoint(bbSkip);
+            skipP   = m_builder->CreatePHI(indxType, 2, "p");
+            m_builder->CreateCondBr(m_builder->CreateICmpSLT(skipP, size, "p < size"), bbSkipTest, bbFind);
+
+            //  skip test
+            m_builder->SetInsertPoint(bbSkipTest);
+            auto    skipT   = getTime(frst, m_builder->CreateAdd(skipP, m_p1), "frst[p + 1].__time__");
+            m_builder->CreateCondBr(m_builder->CreateICmpSLE(skipT, timeLo), bbSkipNext, bbFind);
+
+            //  skip next
+            m_builder->SetInsertPoint(bbSkipNext);
+            skipN   = m_builder->CreateAdd(skipP, m_p1, "p + 1");
+            m_builder->CreateBr(bbSkip);
+
+            skipP->addIncoming(skip0, bbScanBody);
+            skipP->addIncoming(skipN, bbSkipNext);
+        }
+
+        //  find
+        m_builder->SetInsertPoint(bbFind);
+        auto    skip1   = timeLo ? skipP : scan;
+        auto    found   = m_builder->CreateLoad(indxType, m_builder->CreateGEP(indxType, next, skip1), "n");
+        m_builder->CreateCondBr(m_builder->CreateICmpSLT(found, size, "n < size"), bbFound, bbScanNext);
+
+        //  found
+        m_builder->SetInsertPoint(bbFound);
+        auto    foundT0 = getTime(frst, found, "frst[n].__time__");
+        auto    foundT1 = getTime(frst, m_builder->CreateAdd(found, m_p1), "frst[n + 1].__time__");
+        auto    loT     = timeLo
+                        ? m_builder->CreateSelect(m_builder->CreateICmpSLT(foundT0, timeLo), timeLo, foundT0)
+                        : foundT0;
+        auto    hiT     = timeHi
+                        ? m_builder->CreateSelect(m_builder->CreateICmpSLT(timeHi, foundT1), timeHi, foundT1)
+                        : foundT1;
+        auto    verdict = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, buff, found), "V[n]");
+        auto    inside  = m_builder->CreateSelect(m_builder->CreateICmpSLT(loT, hiT), verdict, endV);
+        m_builder->CreateBr(bbScanNext);
+
+        //  scan next
+        m_builder->SetInsertPoint(bbScanNext);
+        auto    result  = m_builder->CreatePHI(m_boolType, 2, "result");
+        m_builder->CreateStore(result, m_builder->CreateGEP(m_boolType, buff, scan));
+        auto    scanN   = m_builder->CreateAdd(scan, m_p1, "c + 1");
+        m_builder->CreateBr(bbScan);
+
+        //  tail
+        m_builder->SetInsertPoint(bbTail);
+        m_builder->CreateCall(free, {m_builder->CreateBitCast(next, m_builder->getInt8PtrTy())});
+        chain(bbHead, bbTail);
+
+        //  link
+        fill->addIncoming(fill0, bbHead);
+        fill->addIncoming(fillN, bbFillNext);
+
+        hit->addIncoming(m_F,       bbFillLen);
+        hit->addIncoming(m_T,       bbFillRhsLo);
+        hit->addIncoming(lhsCond,   bbFillLhsLo);
+
+        value->addIncoming(endV,    bbFillLen);
+        value->addIncoming(rhsV,    bbFillRhsLo);
+        value->addIncoming(lhsV,    bbFillLhsLo);
+
+        scan->addIncoming(m_p1,     bbFill);
+        scan->addIncoming(scanN,    bbScanNext);
+
+        skip->addIncoming(m_p1,     bbFill);
+        skip->addIncoming(skip1,    bbScanNext);
+
+        result->addIncoming(endV,   bbFind);
+        result->addIncoming(inside, bbFound);
+
+        m_builder->restoreIP(save);
+        m_sweeps[expr]  = buff;
+    }
+
+    auto    indx    = m_builder->CreatePtrDiff(m_propType, m_curr.back(), frst, "curr - frst");
+
+    m_value = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, m_sweeps[expr], indx), name);
+}
+
+void    CompileExprImpl::slideST(
+                            Temporal<ExprBinary>*   expr,
+                            llvm::Value*            rhsV,
+                            llvm::Value*            lhsV,
+                            llvm::Value*            endV,
+                            std::string             name)
+{
+/*
+bool*   slideST(prop_t const* frst, prop_t const* last, uint64_t lo, uint64_t hi, bool lhsV, bool rhsV, bool endV)
+{
+    uint64_t    size    = last - frst;
+    bool*       V       = malloc(size + 1);
+    uint64_t*   P       = malloc(size + 1);     //  last decisive row at or before k
+
+    P[0]    = 0;
+
+    for(k = 1; k < size; k++)
+    {
+        if(frst[k - 1].__time__ < frst[k].__time__ && eval(frst + k, rhs) == rhsV)
+            V[k] = rhsV, P[k] = k;
+        else if(frst[k - 1].__time__ < frst[k].__time__ && eval(frst + k, lhs) == lhsV)
+            V[k] = lhsV, P[k] = k;
+        else
+            P[k] = P[k - 1];
+    }
+
+    for(c = size - 1, p = size - 1; c > 0; c--)
+    {
+        //  p is the last row whose interval starts before now - lo, it never moves forward
+        p   = min(p, c);
+        while(p > 1 && frst[p - 1].__time__ >= frst[c].__time__ - lo)
+            p--;
+
+        n   = P[p];
+
+        //  V[n] is read before V[c] is overwritten, n <= c
+        V[c]    = n > 0 && max(frst[n - 1].__time__, now - hi) < min(now - lo, frst[n].__time__)
+                ? V[n]
+                : endV;
+    }
+
+    free(P);
+
+    return  V;
+}
+
+untimed operators skip both the length and the window checks and p is just c.
+*/
+    auto    frst        = m_frst.front();
+    auto    last        = m_last.front();
+    auto    timed       = expr->time && (expr->time->lo || expr->time->hi);
+    auto    indxType    = m_builder->getInt64Ty();
+    auto    indxPtrType = llvm::PointerType::get(indxType, 0);
+    auto    boolPtrType = llvm::PointerType::get(m_boolType, 0);
+
+    if(m_sweeps.find(expr) == m_sweeps.end())
+    {
+        auto    malloc  = m_module->getOrInsertFunction("malloc", m_builder->getInt8PtrTy(), indxType);
+        auto    free    = m_module->getOrInsertFunction("free", m_builder->getVoidTy(), m_builder->getInt8PtrTy());
+        auto    save    = m_builder->saveIP();
+
+        auto    bbHead      = llvm::BasicBlock::Create(*m_context, name + "-slide-head", m_function);
+        auto    bbFill      = llvm::BasicBlock::Create(*m_context, name + "-slide-fill", m_function);
+        auto    bbFillLen   = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-len", m_function);
+        auto    bbFillRhsHi = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-rhs", m_function);
+        auto    bbFillRhsLo = bbFillRhsHi;
+        auto    bbFillLhsHi = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-lhs", m_function);
+        auto    bbFillLhsLo = bbFillLhsHi;
+        auto    bbFillNext  = llvm::BasicBlock::Create(*m_context, name + "-slide-fill-next", m_function);
+        auto    bbScan      = llvm::BasicBlock::Create(*m_context, name + "-slide-scan", m_function);
+        auto    bbScanBody  = llvm::BasicBlock::Create(*m_context, name + "-slide-scan-body", m_function);
+        auto    bbSkip      = timed && expr->time->lo ? llvm::BasicBlock::Create(*m_context, name + "-slide-skip", m_function) : nullptr;
+        auto    bbSkipTest  = timed && expr->time->lo ? llvm::BasicBlock::Create(*m_context, name + "-slide-skip-test", m_function) : nullptr;
+        auto    bbSkipNext  = timed && expr->time->lo ? llvm::BasicBlock::Create(*m_context, name + "-slide-skip-next", m_function) : nullptr;
+        auto    bbFind      = llvm::BasicBlock::Create(*m_context, name + "-slide-find", m_function);
+        auto    bbFound     = llvm::BasicBlock::Create(*m_context, name + "-slide-found", m_function);
+        auto    bbScanNext  = llvm::BasicBlock::Create(*m_context, name + "-slide-scan-next", m_function);
+        auto    bbTail      = llvm::BasicBlock::Create(*m_context, name + "-slide-tail", m_function);
+
+        //  head
+        m_builder->SetInsertPoint(bbHead);
+        auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+        auto    count   = m_builder->CreateAdd(size, m_p1);
+        auto    bytes   = m_builder->CreateMul(count, llvm::ConstantInt::get(indxType, 8));
+        auto    buff    = m_builder->CreateBitCast(m_builder->CreateCall(malloc, {count}), boolPtrType, name);
+        auto    prev    = m_builder->CreateBitCast(m_builder->CreateCall(malloc, {bytes}), indxPtrType, "prev");
+        auto    lo      = timed && expr->time->lo ? make(expr->time->lo) : nullptr;
+        auto    hi      = timed && expr->time->hi ? make(expr->time->hi) : nullptr;
+        m_builder->CreateStore(m_0, m_builder->CreateGEP(indxType, prev, m_0));
+        auto    scan0   = m_builder->CreateSub(size, m_p1);
+
+        //  in a chunk the rows before lo belong to the previous one, none of
+        //  them is decisive and the verdict without one is carried in from it
+        auto    seamed  = m_lo && !timed;
+        auto    ord     = seamed ? seam(expr, true) : 0;
+        auto    carry   = seamed ? carryIn(ord, true, endV, size) : endV;
+        m_builder->CreateBr(bbFill);
+
+        //  fill
+        m_builder->SetInsertPoint(bbFill);
+        auto    fill    = m_builder->CreatePHI(indxType, 2, "k");
+        auto    fillLTsize  = m_builder->CreateICmpSLT(fill, size, "k < size");
+        m_builder->CreateCondBr(fillLTsize, bbFillLen, bbScan);
+
+        //  fill len
+        m_builder->SetInsertPoint(bbFillLen);
+        auto    fill1   = m_builder->CreateSub(fill, m_p1, "k - 1");
+        if(timed)
+        {
+            auto    fillT0  = getTime(frst, fill1, "frst[k - 1].__time__");
+            auto    fillT1  = getTime(frst, fill,  "frst[k].__time__");
+            m_builder->CreateCondBr(m_builder->CreateICmpSLT(fillT0, fillT1), bbFillRhsHi, bbFillNext);
+        }
+        else if(seamed)
+        {
+            m_builder->CreateCondBr(m_builder->CreateICmpSLT(fill, m_lo, "k < lo"), bbFillNext, bbFillRhsHi);
+        }
+        else
+        {
+            m_builder->CreateBr(bbFillRhsHi);
+        }
+
+        //  fill rhs
+        m_builder->SetInsertPoint(bbFillRhsHi);
+        m_curr.push_back(m_builder->CreateInBoundsGEP(m_propType, frst, fill, "curr"));
+        auto    rhs     = make(expr->rhs);
+        auto    rhsCond = m_builder->CreateCmp(llvm::CmpInst::Predicate::ICMP_EQ, rhs, rhsV);
+        bbFillRhsLo = m_builder->GetInsertBlock();
+        m_builder->CreateCondBr(rhsCond, bbFillNext, bbFillLhsHi);
+
+        //  fill lhs
+        m_builder->SetInsertPoint(bbFillLhsHi);
+        auto    lhs     = make(expr->lhs);
+        m_curr.pop_back();
+        auto    lhsCond = m_builder->CreateCmp(llvm::CmpInst::Predicate::ICMP_EQ, lhs, lhsV);
+        bbFillLhsLo = m_builder->GetInsertBlock();
+        m_builder->CreateBr(bbFillNext);
+
+        //  fill next
+        m_builder->SetInsertPoint(bbFillNext);
+        auto    hit     = m_builder->CreatePHI(m_boolType, 3, "hit");
+        auto    value   = m_builder->CreatePHI(m_boolType, 3, "value");
+        auto    earlier = m_builder->CreateLoad(indxType, m_builder->CreateGEP(indxType, prev, fill1), "P[k - 1]");
+        m_builder->CreateStore(value, m_builder->CreateGEP(m_boolType, buff, fill));
+        m_builder->CreateStore(m_builder->CreateSelect(hit, fill, earlier), m_builder->CreateGEP(indxType, prev, fill));
+        auto    fillN   = m_builder->CreateAdd(fill, m_p1, "k + 1");
+        m_builder->CreateBr(bbFill);
+
+        //  scan
+        m_builder->SetInsertPoint(bbScan);
+        auto    scan    = m_builder->CreatePHI(indxType, 2, "c");
+        auto    skip    = m_builder->CreatePHI(indxType, 2, "p");
+        auto    scanGT0 = m_builder->CreateICmpSGT(scan, m_0, "c > 0");
+        m_builder->CreateCondBr(scanGT0, bbScanBody, bbTail);
+
+        //  scan body
+        m_builder->SetInsertPoint(bbScanBody);
+        auto    now     = getTime(frst, scan, "now");
+        auto    timeHi  = lo ? m_builder->CreateSub(now, lo, "now - lo") : nullptr;
+        auto    timeLo  = hi ? m_builder->CreateSub(now, hi, "now - hi") : nullptr;
+        auto    skip0   = m_builder->CreateSelect(m_builder->CreateICmpSLT(scan, skip), scan, skip, "min(p, c)");
+        m_builder->CreateBr(timeHi ? bbSkip : bbFind);
+
+        llvm::PHINode*  skipP   = nullptr;
+        llvm::Value*    skipN   = nullptr;
+        if(timeHi)
+        {
+            //  skip
+            m_builder->SetInsertPoint(bbSkip);
+            skipP   = m_builder->CreatePHI(indxType, 2, "p");
+            m_builder->CreateCondBr(m_builder->CreateICmpSGT(skipP, m_p1, "p > 1"), bbSkipTest, bbFind);
+
+            //  skip test
+            m_builder->SetInsertPoint(bbSkipTest);
+            auto    skipT   = getTime(frst, m_builder->CreateSub(skipP, m_p1), "frst[p - 1].__time__");
+            m_builder->CreateCondBr(m_builder->CreateICmpSGE(skipT, timeHi), bbSkipNext, bbFind);
+
+            //  skip next
+            m_builder->SetInsertPoint(bbSkipNext);
+            skipN   = m_builder->CreateSub(skipP, m_p1, "p - 1");
+            m_builder->CreateBr(bbSkip);
+
+            skipP->addIncoming(skip0, bbScanBody);
+            skipP->addIncoming(skipN, bbSkipNext);
+        }
+
+        //  find
+        m_builder->SetInsertPoint(bbFind);
+        auto    skip1   = timeHi ? skipP : scan;
+        auto    found   = m_builder->CreateLoad(indxType, m_builder->CreateGEP(indxType, prev, skip1), "n");
+        m_builder->CreateCondBr(m_builder->CreateICmpSGT(found, m_0, "n > 0"), bbFound, bbScanNext);
+
+        //  found
+        m_builder->SetInsertPoint(bbFound);
+        auto    verdict = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, buff, found), "V[n]");
+        llvm::Value*    inside  = verdict;
+        if(timed)
+        {
+            auto    foundT0 = getTime(frst, m_builder->CreateSub(found, m_p1), "frst[n - 1].__time__");
+            auto    foundT1 = getTime(frst, found, "frst[n].__time__");
+            auto    loT     = timeLo
+                            ? m_builder->CreateSelect(m_builder->CreateICmpSLT(foundT0, timeLo), timeLo, foundT0)
+                            : foundT0;
+            auto    hiT     = timeHi
+                            ? m_builder->CreateSelect(m_builder->CreateICmpSLT(timeHi, foundT1), timeHi, foundT1)
+                            : foundT1;
+            inside  = m_builder->CreateSelect(m_builder->CreateICmpSLT(loT, hiT), verdict, endV);
+        }
+        m_builder->CreateBr(bbScanNext);
+
+        //  scan next
+        m_builder->SetInsertPoint(bbScanNext);
+        auto    result  = m_builder->CreatePHI(m_boolType, 2, "result");
+        m_builder->CreateStore(result, m_builder->CreateGEP(m_boolType, buff, scan));
+        auto    scanN   = m_builder->CreateSub(scan, m_p1, "c - 1");
+        m_builder->CreateBr(bbScan);
+
+        //  tail
+        m_builder->SetInsertPoint(bbTail);
+        if(seamed)
+        {
+            auto    at      = m_builder->CreateSub(m_hi, m_p1, "hi - 1");
+            auto    value   = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, buff, at));
+            auto    decided = m_builder->CreateICmpSGT(m_builder->CreateLoad(indxType, m_builder->CreateGEP(indxType, prev, at)), m_0);
+            summarize(ord, value, m_builder->CreateOr(decided, m_builder->CreateICmpSLE(m_lo, m_p1, "lo <= 1")));
+        }
+        m_builder->CreateCall(free, {m_builder->CreateBitCast(prev, m_builder->getInt8PtrTy())});
+        chain(bbHead, bbTail);
+
+        //  link
+        fill->addIncoming(m_p1,     bbHead);
+        fill->addIncoming(fillN,    bbFillNext);
+
+        if(timed || seamed)
+        {
+            hit->addIncoming(m_F,   bbFillLen);
+            value->addIncoming(carry,bbFillLen);
+        }
+
+        hit->addIncoming(m_T,       bbFillRhsLo);
+        hit->addIncoming(lhsCond,   bbFillLhsLo);
+
+        value->addIncoming(rhsV,    bbFillRhsLo);
+        value->addIncoming(lhsV,    bbFillLhsLo);
+
+        scan->addIncoming(scan0,    bbFill);
+        scan->addIncoming(scanN,    bbScanNext);
+
+        skip->addIncoming(scan0,    bbFill);
+        skip->addIncoming(skip1,    bbScanNext);
+
+        result->addIncoming(carry,  bbFind);
+        result->addIncoming(inside, bbFound);
+
+        m_builder->restoreIP(save);
+        m_sweeps[expr]  = buff;
+    }
+
+    auto    indx    = m_builder->CreatePtrDiff(m_propType, m_curr.back(), frst, "curr - frst");
+
+    m_value = m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, m_sweeps[expr], indx), name);
+}
+
+void    CompileExprImpl::ST(Temporal<ExprBinary>*   expr,
+                            llvm::Value*            rhsV,
+                            llvm::Value*            lhsV,
+                            llvm::Value*            endV,
+                            std::string             name)
+{
+/*
+typedef long long uint64_t;
+typedef struct prop_t
+{
+    uint64_t    __time__;
+    uint64_t    a;
+} prop_t;
+
+bool        boolean(prop_t const* curr);
+bool        integer(prop_t const* curr);
+
+uint64_t    ST(uint64_t lo, uint64_t hi, prop_t const* curr, prop_t const* frst, prop_t const* last, bool lhsV, bool rhsV, bool endV)
+{
+    prop_t const*   prev    = curr - 1;
+
+    lo  = curr->__time__ - lo;
+    hi  = curr->__time__ - hi;
+    swap(lo, hi);
+
+    while(frst <= prev)
+    {
+        ifcurr->__time__ < lo)
+        {
+            break;
+        }
+
+        uint64_t    _lo = lo > curr->__time__ ? lo : curr->__time__;
+        uint64_t    _hi = prev->__time__ < hi ? hi : prev->__time__;
+
+        if(_lo < _hi)
+        {
+            if(eval(rhs) == rhsV)
+                return rshV;
+
+            if(eval(lhs) == lhsV)
+                return lshV;
+        }
+
+        curr    = prev;
+        prev    = prev - 1;
+    }
+
+    return  endV;
 }
 
 uint64_t    ST(prop_t const* curr, prop_t const* frst, prop_t const* last, bool lhsV, bool rhsV, bool endV)
@@ -1383,6 +3212,21 @@ uint64_t    ST(prop_t const* curr, prop_t const* frst, prop_t const* last, bool
     return  endV;
 }
 */
+    if(m_state)
+    {
+        stepST(expr, rhsV, lhsV, endV, name);
+        return;
+    }
+
+    if(sweepable(expr))
+    {
+        if(m_options.bitset && !(expr->time && (expr->time->lo || expr->time->hi)))
+            bits(expr, rhsV, lhsV, endV, true, name);
+        else
+            slideST(expr, rhsV, lhsV, endV, name);
+        return;
+    }
+
     auto    debug   = m_module->getFunction("debug");
 
     auto    bbWhile = llvm::BasicBlock::Create(*m_context, name + "-while", m_function);
@@ -1498,9 +3342,208 @@ uint64_t    ST(prop_t const* curr, prop_t const* frst, prop_t const* last, bool
     prev->addIncoming(prev0, bbEntry);
     prev->addIncoming(prev1, bbPrev);
 
+    if(m_witness && expr == m_root)
+    {
+        auto    which   = m_builder->CreatePHI(m_builder->getInt8Ty(), timeHi ? 4 : 3, "which");
+        which->addIncoming(m_builder->getInt8(2), bbLhsLo);
+        which->addIncoming(m_builder->getInt8(1), bbRhsLo);
+        which->addIncoming(m_builder->getInt8(0), bbWhile);
+        if(timeHi)
+            which->addIncoming(m_builder->getInt8(0), bbOuter);
+
+        witness(expr, result, curr, which, rhsV, lhsV, name);
+    }
+    else if(m_witnessing)
+    {
+        decider(curr);
+    }
+
     m_value = result;
 }
 
+void    CompileExprImpl::stepY( ExprBinary*             expr,
+                                llvm::Value*            endV,
+                                std::string             name)
+{
+/*
+bool    stepY(state_t* state, prop_t const* curr, uint64_t n, bool endV)
+{
+    bool    value   = eval(curr, rhs);
+    bool    result  = state->count >= n ? state->ring[state->count % n] : endV;
+
+    state->ring[state->count % n]   = value;
+    state->count++;
+
+    return  result;
+}
+
+n == 0 is just eval(curr, rhs) and needs no state.
+*/
+    if(m_steps.find(expr) != m_steps.end())
+    {
+        m_value = m_steps[expr];
+        return;
+    }
+
+    auto    count   = dynamic_cast<ExprConstInteger*>(expr->lhs)->value;
+    auto    value   = make(expr->rhs);
+    auto    result  = value;
+
+    if(count > 0)
+    {
+        auto    indxType    = m_builder->getInt64Ty();
+        auto    slot        = m_slots[expr];
+        auto    slotType    = m_stateType->getElementType(slot);
+        auto    slotPtr     = m_builder->CreateStructGEP(m_stateType, m_state, slot, name + "-state");
+        auto    ringType    = cast<llvm::StructType>(slotType)->getElementType(1);
+        auto    countPtr    = m_builder->CreateStructGEP(slotType, slotPtr, 0);
+        auto    ringPtr     = m_builder->CreateStructGEP(slotType, slotPtr, 1);
+        auto    size        = llvm::ConstantInt::get(indxType, count);
+
+        auto    seen        = m_builder->CreateLoad(indxType, countPtr, "count");
+        auto    cellPtr     = m_builder->CreateGEP(ringType, ringPtr, {m_0, m_builder->CreateURem(seen, size)});
+        auto    cell        = m_builder->CreateLoad(m_boolType, cellPtr, "ring[count % n]");
+
+        result  = m_builder->CreateSelect(m_builder->CreateICmpUGE(seen, size, "count >= n"), cell, endV, name);
+
+        m_builder->CreateStore(value, cellPtr);
+        m_builder->CreateStore(m_builder->CreateAdd(seen, m_p1), countPtr);
+    }
+
+    m_steps[expr]   = result;
+    m_value         = result;
+}
+
+void    CompileExprImpl::stepST(Temporal<ExprBinary>*   expr,
+                                llvm::Value*            rhsV,
+                                llvm::Value*            lhsV,
+                                llvm::Value*            endV,
+                                std::string             name)
+{
+/*
+bool    stepST(state_t* state, prop_t const* curr, uint64_t lo, uint64_t hi, bool lhsV, bool rhsV, bool endV)
+{
+    uint64_t    now     = curr->__time__;
+    uint64_t    t0      = state->seen ? state->prev : now - 1;
+    bool        rhs     = eval(curr, rhs) == rhsV;
+    bool        lhs     = eval(curr, lhs) == lhsV;
+
+    state->seen = true;
+    state->prev = now;
+
+    //  the decisive row this sample is the latest of, is eligible once it
+    //  starts before now - lo; rows still younger than that wait in the window
+    if(t0 < now && (rhs || lhs))
+        window_push(&state->window, t0, now, rhs ? rhsV : lhsV);
+
+    window_pop(&state->window, now - lo, &state->t0, &state->t1, &state->value, &state->valid);
+
+    return  state->valid && max(state->t0, now - hi) < min(now - lo, state->t1)
+        ?   state->value
+        :   endV;
+}
+
+without lo a decisive row is eligible at once and the window is not needed,
+untimed operators keep only the latest decisive value.
+*/
+    if(m_steps.find(expr) != m_steps.end())
+    {
+        m_value = m_steps[expr];
+        return;
+    }
+
+    auto    rhs     = make(expr->rhs);
+    auto    lhs     = make(expr->lhs);
+    auto    rhsHit  = m_builder->CreateICmpEQ(rhs, rhsV, "rhs == rhsV");
+    auto    lhsHit  = m_builder->CreateICmpEQ(lhs, lhsV, "lhs == lhsV");
+    auto    hit     = m_builder->CreateOr(rhsHit, lhsHit, "hit");
+    auto    value   = m_builder->CreateSelect(rhsHit, rhsV, lhsV, "value");
+    auto    timed   = expr->time && (expr->time->lo || expr->time->hi);
+    auto    slot    = m_slots[expr];
+    auto    slotType= m_stateType->getElementType(slot);
+    auto    slotPtr = m_builder->CreateStructGEP(m_stateType, m_state, slot, name + "-state");
+    auto    field   = [&](unsigned indx) {return m_builder->CreateStructGEP(slotType, slotPtr, indx);};
+
+    if(!timed)
+    {
+        auto    validPtr= field(0);
+        auto    valuePtr= field(1);
+        auto    valid   = m_builder->CreateOr(hit, m_builder->CreateLoad(m_boolType, validPtr), "valid");
+        auto    latest  = m_builder->CreateSelect(hit, value, m_builder->CreateLoad(m_boolType, valuePtr), "latest");
+
+        m_builder->CreateStore(valid,  validPtr);
+        m_builder->CreateStore(latest, valuePtr);
+
+        m_value = m_builder->CreateSelect(valid, latest, endV, name);
+        m_steps[expr]   = m_value;
+        return;
+    }
+
+    auto    indxType= m_builder->getInt64Ty();
+    auto    seenPtr = field(0);
+    auto    prevPtr = field(1);
+    auto    validPtr= field(2);
+    auto    t0Ptr   = field(3);
+    auto    t1Ptr   = field(4);
+    auto    valuePtr= field(5);
+
+    auto    now     = getTime(m_curr.back(), "now");
+    auto    seen    = m_builder->CreateLoad(m_boolType, seenPtr, "seen");
+    auto    prev    = m_builder->CreateLoad(indxType, prevPtr, "prev");
+    auto    t0      = m_builder->CreateSelect(seen, prev, m_builder->CreateSub(now, m_p1), "t0");
+    auto    decisive= m_builder->CreateAnd(m_builder->CreateICmpSLT(t0, now, "t0 < now"), hit, "decisive");
+    auto    lo      = expr->time->lo ? make(expr->time->lo) : nullptr;
+    auto    hi      = expr->time->hi ? make(expr->time->hi) : nullptr;
+    auto    timeHi  = lo ? m_builder->CreateSub(now, lo, "now - lo") : nullptr;
+    auto    timeLo  = hi ? m_builder->CreateSub(now, hi, "now - hi") : nullptr;
+
+    m_builder->CreateStore(m_T, seenPtr);
+    m_builder->CreateStore(now, prevPtr);
+
+    if(timeHi)
+    {
+        auto    windowPtr   = field(6);
+        auto    windowType  = windowPtr->getType();
+        auto    push        = m_module->getOrInsertFunction("referee_window_push", m_builder->getVoidTy(), windowType, indxType, indxType, m_builder->getInt32Ty());
+        auto    pop         = m_module->getOrInsertFunction("referee_window_pop",  m_builder->getVoidTy(), windowType, indxType, t0Ptr->getType(), t1Ptr->getType(), valuePtr->getType(), validPtr->getType());
+        auto    bbPush      = llvm::BasicBlock::Create(*m_context, name + "-step-push", m_function);
+        auto    bbPop       = llvm::BasicBlock::Create(*m_context, name + "-step-pop", m_function);
+
+        m_builder->CreateCondBr(decisive, bbPush, bbPop);
+
+        //  push
+        m_builder->SetInsertPoint(bbPush);
+        m_builder->CreateCall(push, {windowPtr, t0, now, m_builder->CreateZExt(value, m_builder->getInt32Ty())});
+        m_builder->CreateBr(bbPop);
+
+        //  pop
+        m_builder->SetInsertPoint(bbPop);
+        m_builder->CreateCall(pop, {windowPtr, timeHi, t0Ptr, t1Ptr, valuePtr, validPtr});
+    }
+    else
+    {
+        m_builder->CreateStore(m_builder->CreateSelect(decisive, t0,    m_builder->CreateLoad(indxType,   t0Ptr)),    t0Ptr);
+        m_builder->CreateStore(m_builder->CreateSelect(decisive, now,   m_builder->CreateLoad(indxType,   t1Ptr)),    t1Ptr);
+        m_builder->CreateStore(m_builder->CreateSelect(decisive, value, m_builder->CreateLoad(m_boolType, valuePtr)), valuePtr);
+        m_builder->CreateStore(m_builder->CreateOr(decisive, m_builder->CreateLoad(m_boolType, validPtr)), validPtr);
+    }
+
+    auto    valid   = m_builder->CreateLoad(m_boolType, validPtr, "valid");
+    auto    foundT0 = m_builder->CreateLoad(indxType,   t0Ptr,    "t0");
+    auto    foundT1 = m_builder->CreateLoad(indxType,   t1Ptr,    "t1");
+    auto    verdict = m_builder->CreateLoad(m_boolType, valuePtr, "verdict");
+    auto    loT     = timeLo
+                    ? m_builder->CreateSelect(m_builder->CreateICmpSLT(foundT0, timeLo), timeLo, foundT0)
+                    : foundT0;
+    auto    hiT     = timeHi
+                    ? m_builder->CreateSelect(m_builder->CreateICmpSLT(timeHi, foundT1), timeHi, foundT1)
+                    : foundT1;
+    auto    inside  = m_builder->CreateAnd(valid, m_builder->CreateICmpSLT(loT, hiT));
+
+    m_value = m_builder->CreateSelect(inside, verdict, endV, name);
+    m_steps[expr]   = m_value;
+}
+
 void    CompileExprImpl::visit( ExprXs*         expr)
 {
     XY(expr, m_p1, m_F, "Xs");
@@ -1518,7 +3561,35 @@ void    CompileExprImpl::visit(ExprYs*           expr)
 
 void    CompileExprImpl::visit(ExprYw*           expr)
 {
-    XY(expr, m_m1, m_T, "Yw");
+    XY(expr, m_m1, m_T, "Yw");
+}
+
+//  distinct nodes of expr, hash-consing makes a repeated subformula one node
+static size_t   count(Expr* expr, std::set<Expr*>& seen)
+{
+    if(!seen.insert(expr).second)
+        return  0;
+
+    if(auto at = dynamic_cast<ExprAt*>(expr))
+        return  1 + count(at->arg, seen);
+
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+        return  1 + count(unary->arg, seen);
+
+    if(auto binary = dynamic_cast<ExprBinary*>(expr))
+        return  1 + count(binary->lhs, seen) + count(binary->rhs, seen);
+
+    if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+        return  1 + count(ternary->lhs, seen) + count(ternary->mhs, seen) + count(ternary->rhs, seen);
+
+    return  1;
+}
+
+static size_t   count(Expr* expr)
+{
+    std::set<Expr*> seen;
+
+    return  count(expr, seen);
 }
 
 void    CompileExprImpl::visit(Spec*             spec)
@@ -1526,7 +3597,10 @@ void    CompileExprImpl::visit(Spec*             spec)
     auto    expr    = Rewrite::make(spec);
     TypeCalc::make(m_refmod, expr);
 
-    m_value = make(expr);
+    if(Report::enabled())
+        m_nodes += count(expr);
+
+    m_value = m_frst.size() == 1 && m_last.size() == 1 ? verdict(expr) : make(expr);
 }
 
 void    CompileExprImpl::visit(SpecGlobally*     spec)
@@ -1892,92 +3966,847 @@ void    CompileExprImpl::visit(SpecAfterUntil*   spec)
     auto    result      = m_builder->CreatePHI(m_boolType, 2, "result");
     m_value = result;
 
-    //  link
-    result->addIncoming(m_F, bbEvalBodyLo);
-    result->addIncoming(m_T, bbWhile);
+    //  link
+    result->addIncoming(m_F, bbEvalBodyLo);
+    result->addIncoming(m_T, bbWhile);
+
+    curr->addIncoming(curr0, bbHead);
+    curr->addIncoming(curr1, bbNext);
+
+    innerFrst->addIncoming(innerFrst0, bbHead);
+    innerFrst->addIncoming(innerFrst1, bbNext);
+
+    inside->addIncoming(m_F, bbHead);
+    inside->addIncoming(inside1, bbNext);
+}
+
+llvm::Value*    CompileExprImpl::getNext(llvm::Value* curr)
+{
+    return  m_builder->CreateGEP(m_propType, curr, m_p1, "next");
+}
+
+llvm::Value*    CompileExprImpl::getPrev(llvm::Value* curr)
+{
+    return  m_builder->CreateGEP(m_propType, curr, m_m1, "prev");
+}
+
+llvm::Value*    CompileExprImpl::getTime(llvm::Value* curr, std::string name)
+{
+    return  m_builder->CreateLoad(m_builder->getInt64Ty(), m_builder->CreateStructGEP(m_propType, curr, 0), false, name);
+}
+
+llvm::Value*    CompileExprImpl::getTime(llvm::Value* frst, llvm::Value* indx, std::string name)
+{
+    return  getTime(m_builder->CreateGEP(m_propType, frst, indx), name);
+}
+
+//  a boolean prop is read as the byte it is stored in, i1 loads packed into a
+//  word by carry() are otherwise selected into AVX-512 mask registers one by one
+llvm::Value*    CompileExprImpl::getProp(llvm::Type* type, llvm::Value* ptr, std::string name)
+{
+    if(type != m_boolType)
+    {
+        return  m_builder->CreateLoad(type, ptr, false, name);
+    }
+
+    auto    byte    = m_builder->CreateLoad(m_builder->getInt8Ty(), m_builder->CreateBitCast(ptr, m_builder->getInt8PtrTy()), false, name + ".byte");
+
+    return  m_builder->CreateTrunc(byte, m_boolType, name);
+}
+
+llvm::Value*    CompileExprImpl::getPropPtr(llvm::Value* var)
+{
+    return m_builder->CreateLoad(m_propPtrType, var);
+}
+
+llvm::Value*    CompileExprImpl::setPropPtr(llvm::Value* var, llvm::Value* val)
+{
+    return m_builder->CreateStore(val, var);
+}
+
+llvm::Value*    CompileExprImpl::getBool(llvm::Value* var)
+{
+    return m_builder->CreateLoad(m_boolType, var);
+}
+
+llvm::Value*    CompileExprImpl::setBool(llvm::Value* var, llvm::Value* val)
+{
+    return m_builder->CreateStore(val, var);
+}
+
+llvm::Value*    CompileExprImpl::make(Expr* expr)
+{
+    if(m_curr.size() > 1 && shares(expr))
+    {
+        auto    indx    = m_builder->CreatePtrDiff(m_propType, m_curr.back(), m_frst.front(), "curr - frst");
+
+        return  m_builder->CreateLoad(m_boolType, m_builder->CreateGEP(m_boolType, shared(expr), indx), m_shared->at(expr));
+    }
+
+    auto    save    = m_value;
+
+    expr->accept(*this);
+
+    auto    result  = m_value;
+    m_value = save;
+
+    return  result;
+}
+
+llvm::Value*    CompileExprImpl::make(Spec* spec)
+{
+    auto    save    = m_value;
+
+    spec->accept(*this);
+
+    auto    result  = m_value;
+    m_value = save;
+
+    return  result;
+}
+
+//  the expr whose value the function returns, with Options::witness its
+//  top-level U/R/S/T records the sample it failed at
+llvm::Value*    CompileExprImpl::verdict(Expr* expr)
+{
+    m_root  = expr;
+
+    return  make(expr);
+}
+
+void    CompileExprImpl::chain(llvm::BasicBlock* head, llvm::BasicBlock* tail)
+{
+    //  sweeps run in the order they are completed, so every buffer a sweep
+    //  reads, nested or reused from the cache, is filled before it
+    if(m_chain)
+    {
+        m_chain->getTerminator()->setSuccessor(0, head);
+    }
+    else
+    {
+        head->moveBefore(&m_function->getEntryBlock());
+    }
+
+    m_builder->SetInsertPoint(tail);
+    m_builder->CreateBr(m_body);
+
+    m_chain = tail;
+}
+
+//  true if expr is read from the buffer of a shared subformula, whole-trace
+//  evaluation only: not in a chunk, a step, a scope or under @, and not for
+//  the subformula a filler tabulates or the operand a witness re-evaluates
+bool    CompileExprImpl::shares(Expr* expr)
+{
+    auto    global  = m_frst.size() == 1 && m_last.size() == 1 && m_name2value.empty();
+
+    return  m_shared && m_shared->count(expr) && expr != m_tabulated && expr != m_root
+        &&  global && !m_lo && !m_state && !m_witnessing;
+}
+
+llvm::Value*    CompileExprImpl::shared(Expr* expr)
+{
+/*
+    bool*   V       = shared_buffer;
+    bool    owned   = V == NULL;
+
+    if(owned)
+        V   = shared(frst, last, conf);
+
+Check fills the buffers of a module once, ahead of its specs, functions called
+on their own compute the ones they read.  The load is emitted ahead of the
+body, see chain(), and release() frees the buffers the function computed.
+*/
+    if(m_buffers.find(expr) == m_buffers.end())
+    {
+        auto    name    = m_shared->at(expr);
+        auto    bytePtr = m_builder->getInt8PtrTy();
+        auto    save    = m_builder->saveIP();
+
+        std::vector<llvm::Type*>    argTypes    = {m_propPtrType, m_propPtrType, m_confPtrType};
+        std::vector<llvm::Value*>   args        = {m_frst.front(), m_last.front(), m_conf};
+        if(m_cols)
+        {
+            argTypes.push_back(m_cols->getType());
+            args.push_back(m_cols);
+        }
+
+        auto    fill    = m_module->getOrInsertFunction(name, llvm::FunctionType::get(bytePtr, argTypes, false));
+        auto    global  = m_module->getOrInsertGlobal(name + ".buffer", bytePtr);
+
+        auto    bbHead  = llvm::BasicBlock::Create(*m_context, name + "-head", m_function);
+        auto    bbFill  = llvm::BasicBlock::Create(*m_context, name + "-fill", m_function);
+        auto    bbTail  = llvm::BasicBlock::Create(*m_context, name + "-tail", m_function);
+
+        //  head
+        m_builder->SetInsertPoint(bbHead);
+        auto    filled  = m_builder->CreateLoad(bytePtr, global, name + ".buffer");
+        m_builder->CreateCondBr(m_builder->CreateIsNull(filled), bbFill, bbTail);
+
+        //  fill
+        m_builder->SetInsertPoint(bbFill);
+        auto    owned   = m_builder->CreateCall(fill, args);
+        m_builder->CreateBr(bbTail);
+
+        //  tail
+        m_builder->SetInsertPoint(bbTail);
+        auto    buff    = m_builder->CreatePHI(bytePtr, 2, name);
+        auto    own     = m_builder->CreatePHI(m_boolType, 2, "owned");
+        buff->addIncoming(filled, bbHead);
+        buff->addIncoming(owned, bbFill);
+        own->addIncoming(m_F, bbHead);
+        own->addIncoming(m_T, bbFill);
+        auto    bools   = m_builder->CreateBitCast(buff, llvm::PointerType::get(m_boolType, 0));
+        chain(bbHead, bbTail);
+
+        m_builder->restoreIP(save);
+        m_buffers[expr] = {bools, own};
+    }
+
+    return  m_buffers[expr].first;
+}
+
+llvm::Value*    CompileExprImpl::tabulate(Expr* expr)
+{
+/*
+bool*   shared(prop_t const* frst, prop_t const* last, conf_t const* conf)
+{
+    bool*   V   = calloc(last - frst + 1, 1);
+
+    for(curr = frst + 1; curr < last; curr++)
+        V[curr - frst]  = eval(curr, expr);
+
+    return  V;
+}
+
+expr is nested under the loop, so its own U/R/S/T sweep the trace ahead of it
+and the subformulas shared inside it are read from their buffers.
+*/
+    auto    frst    = m_frst.front();
+    auto    last    = m_last.front();
+    auto    calloc  = m_module->getOrInsertFunction("calloc", m_builder->getInt8PtrTy(), m_builder->getInt64Ty(), m_builder->getInt64Ty());
+
+    auto    bbWhile = llvm::BasicBlock::Create(*m_context, "shared-while", m_function);
+    auto    bbBodyHi= llvm::BasicBlock::Create(*m_context, "shared-body", m_function);
+    auto    bbBodyLo= bbBodyHi;
+    auto    bbTail  = llvm::BasicBlock::Create(*m_context, "shared-tail", m_function);
+
+    auto    size    = m_builder->CreatePtrDiff(m_propType, last, frst, "last - frst");
+    auto    buff    = m_builder->CreateCall(calloc, {m_builder->CreateAdd(size, m_p1), m_p1}, "V");
+    auto    bools   = m_builder->CreateBitCast(buff, llvm::PointerType::get(m_boolType, 0));
+    auto    curr0   = getNext(frst);
+    auto    bbEntry = m_builder->GetInsertBlock();
+    m_builder->CreateBr(bbWhile);
+
+    //  while
+    m_builder->SetInsertPoint(bbWhile);
+    auto    curr    = m_builder->CreatePHI(m_propPtrType, 2, "curr");
+    m_builder->CreateCondBr(m_builder->CreateICmpSLT(curr, last, "curr < last"), bbBodyHi, bbTail);
+
+    //  body
+    m_builder->SetInsertPoint(bbBodyHi);
+    m_curr.push_back(curr);
+    m_tabulated = expr;
+    auto    value   = make(expr);
+    m_tabulated = nullptr;
+    m_curr.pop_back();
+    m_builder->CreateStore(value, m_builder->CreateGEP(m_boolType, bools, m_builder->CreatePtrDiff(m_propType, curr, frst)));
+    auto    curr1   = getNext(curr);
+    bbBodyLo    = m_builder->GetInsertBlock();
+    m_builder->CreateBr(bbWhile);
+
+    //  tail
+    m_builder->SetInsertPoint(bbTail);
+
+    //  link
+    curr->addIncoming(curr0, bbEntry);
+    curr->addIncoming(curr1, bbBodyLo);
+
+    return  buff;
+}
+
+void    CompileExprImpl::release()
+{
+    auto    free    = m_module->getOrInsertFunction("free", m_builder->getVoidTy(), m_builder->getInt8PtrTy());
+
+    for(auto [expr, buff]: m_sweeps)
+    {
+        m_builder->CreateCall(free, {m_builder->CreateBitCast(buff, m_builder->getInt8PtrTy())});
+    }
+
+    for(auto [expr, buff]: m_packs)
+    {
+        m_builder->CreateCall(free, {m_builder->CreateBitCast(buff, m_builder->getInt8PtrTy())});
+    }
+
+    for(auto [expr, buff]: m_buffers)
+    {
+        auto    bytes   = m_builder->CreateBitCast(buff.first, m_builder->getInt8PtrTy());
+        auto    null    = llvm::ConstantPointerNull::get(m_builder->getInt8PtrTy());
+        m_builder->CreateCall(free, {m_builder->CreateSelect(buff.second, bytes, null)});
+    }
+
+    m_sweeps.clear();
+    m_packs.clear();
+    m_buffers.clear();
+}
+
+unsigned    CompileExprImpl::seam(Temporal<ExprBinary>* expr, bool past)
+{
+    m_seams.push_back(uint8_t((depth(expr) - 1) << 1 | past));
+
+    return  m_seams.size() - 1;
+}
+
+//  the verdict past the chunk edge, endV at the edge of the trace
+llvm::Value*    CompileExprImpl::carryIn(unsigned seam, bool past, llvm::Value* endV, llvm::Value* size)
+{
+    auto    edge    = past
+                    ? m_builder->CreateICmpSLE(m_lo, m_p1, "lo <= 1")
+                    : m_builder->CreateICmpSGE(m_hi, size, "hi >= size");
+    auto    carried = m_builder->CreateLoad(m_builder->getInt8Ty(), m_builder->CreateConstGEP1_64(m_builder->getInt8Ty(), m_carry, seam));
+
+    return  m_builder->CreateSelect(edge, endV, m_builder->CreateICmpNE(carried, m_builder->getInt8(0)), "carry");
+}
+
+//  the verdict at the chunk row next to the neighbour it is carried to and
+//  whether it is decided inside the chunk rather than carried through it
+void    CompileExprImpl::summarize(unsigned seam, llvm::Value* value, llvm::Value* decided)
+{
+    auto    byteType    = m_builder->getInt8Ty();
+
+    m_builder->CreateStore(m_builder->CreateZExt(value,   byteType), m_builder->CreateConstGEP1_64(byteType, m_summary, 2 * seam + 0));
+    m_builder->CreateStore(m_builder->CreateZExt(decided, byteType), m_builder->CreateConstGEP1_64(byteType, m_summary, 2 * seam + 1));
+}
+
+void    CompileExprImpl::witness(
+                            Temporal<ExprBinary>*   expr,
+                            llvm::Value*            result,
+                            llvm::Value*            curr,
+                            llvm::Value*            which,
+                            llvm::Value*            rhsV,
+                            llvm::Value*            lhsV,
+                            std::string             name)
+{
+/*
+    if(!result)
+    {
+        witness[0]  = curr - frst;
+        witness[1]  = curr->__time__;
+        witness[2]  = -1;
+        witness[3]  = 0;
+
+        switch(which)
+        {
+            case 1: eval(rhs, curr);    break;      //  every U/R/S/T in it records where it decided
+            case 2: eval(lhs, curr);    break;
+        }
+    }
+
+the operator scan stopped at curr, the verdict of the function is known there,
+and only an operand that decided the value false is worth re-evaluating
+*/
+    auto    indxType    = m_builder->getInt64Ty();
+    auto    bbWitness   = llvm::BasicBlock::Create(*m_context, name + "-witness", m_function);
+    auto    bbDone      = llvm::BasicBlock::Create(*m_context, name + "-witnessed", m_function);
+
+    m_builder->CreateCondBr(result, bbDone, bbWitness);
+
+    m_builder->SetInsertPoint(bbWitness);
+    m_builder->CreateStore(m_builder->CreatePtrDiff(m_propType, curr, m_frst.front(), "curr - frst"), m_builder->CreateConstGEP1_64(indxType, m_witness, 0));
+    m_builder->CreateStore(getTime(curr),   m_builder->CreateConstGEP1_64(indxType, m_witness, 1));
+    m_builder->CreateStore(m_m1,            m_builder->CreateConstGEP1_64(indxType, m_witness, 2));
+    m_builder->CreateStore(m_0,             m_builder->CreateConstGEP1_64(indxType, m_witness, 3));
+    auto    cases       = m_builder->CreateSwitch(which, bbDone, 2);
+
+    for(auto [code, operand, value]: {std::tuple(1, expr->rhs, rhsV), std::tuple(2, expr->lhs, lhsV)})
+    {
+        if(!cast<llvm::ConstantInt>(value)->isZero())
+            continue;
+
+        auto    bbOperand   = llvm::BasicBlock::Create(*m_context, name + (code == 1 ? "-witness-rhs" : "-witness-lhs"), m_function);
+        cases->addCase(m_builder->getInt8(code), bbOperand);
+
+        m_builder->SetInsertPoint(bbOperand);
+        m_witnessing    = true;
+        m_curr.push_back(curr);
+        make(operand);
+        m_curr.pop_back();
+        m_witnessing    = false;
+        m_builder->CreateBr(bbDone);
+    }
+
+    m_builder->SetInsertPoint(bbDone);
+}
+
+void    CompileExprImpl::decider(llvm::Value* curr)
+{
+    //  the innermost operator wins, the last one evaluated among equals
+    auto    indxType    = m_builder->getInt64Ty();
+    auto    rowPtr      = m_builder->CreateConstGEP1_64(indxType, m_witness, 2);
+    auto    depthPtr    = m_builder->CreateConstGEP1_64(indxType, m_witness, 3);
+    auto    depth       = m_builder->getInt64(m_curr.size() - 1);
+    auto    row         = m_builder->CreatePtrDiff(m_propType, curr, m_frst.front(), "curr - frst");
+    auto    deeper      = m_builder->CreateICmpSLE(m_builder->CreateLoad(indxType, depthPtr), depth);
+
+    m_builder->CreateStore(m_builder->CreateSelect(deeper, row, m_builder->CreateLoad(indxType, rowPtr)), rowPtr);
+    m_builder->CreateStore(m_builder->CreateSelect(deeper, depth, m_builder->CreateLoad(indxType, depthPtr)), depthPtr);
+}
+
+llvm::Value*    CompileExprImpl::chunk(ExprRw* globally)
+{
+/*
+bool    chunk(prop_t const* frst, prop_t const* last, conf_t const* conf, uint64_t lo, uint64_t hi, uint8_t const* carry, uint8_t* summary)
+{
+    bool    result  = true;
+
+    for(k = lo; k < hi && result; k++)
+        result  = eval(frst + k);
+
+    return  result;
+}
+
+[frst, last] is a window of the trace wide enough for every row of the chunk
+[lo, hi), see Chunks.  Untimed U/R/S/T are swept up to the chunk edge only,
+carry holds their verdict past it and summary gets what the neighbours need.
+*/
+    auto    frst    = m_frst.front();
+
+    auto    bbEntry = m_builder->GetInsertBlock();
+    auto    bbHead  = llvm::BasicBlock::Create(*m_context, "chunk-head", m_function);
+    auto    bbBodyHi= llvm::BasicBlock::Create(*m_context, "chunk-body", m_function);
+    auto    bbBodyLo= bbBodyHi;
+    auto    bbNext  = llvm::BasicBlock::Create(*m_context, "chunk-next", m_function);
+    auto    bbTail  = llvm::BasicBlock::Create(*m_context, "chunk-tail", m_function);
+    m_builder->CreateBr(bbHead);
+
+    //  head
+    m_builder->SetInsertPoint(bbHead);
+    auto    indx    = m_builder->CreatePHI(m_builder->getInt64Ty(), 2, "k");
+    m_builder->CreateCondBr(m_builder->CreateICmpSLT(indx, m_hi, "k < hi"), bbBodyHi, bbTail);
+
+    //  body
+    m_builder->SetInsertPoint(bbBodyHi);
+    m_curr.push_back(m_builder->CreateInBoundsGEP(m_propType, frst, indx, "curr"));
+    auto    value   = make(globally->rhs);
+    m_curr.pop_back();
+    bbBodyLo = m_builder->GetInsertBlock();
+    m_builder->CreateCondBr(value, bbNext, bbTail);
+
+    //  next
+    m_builder->SetInsertPoint(bbNext);
+    auto    indx1   = m_builder->CreateAdd(indx, m_p1, "k + 1");
+    m_builder->CreateBr(bbHead);
+
+    //  tail
+    m_builder->SetInsertPoint(bbTail);
+    auto    result  = m_builder->CreatePHI(m_boolType, 2, "result");
+
+    //  link
+    indx->addIncoming(m_lo,  bbEntry);
+    indx->addIncoming(indx1, bbNext);
+
+    result->addIncoming(m_T, bbHead);
+    result->addIncoming(m_F, bbBodyLo);
+
+    return  result;
+}
+
+llvm::Value*    CompileExprImpl::step(Expr* expr)
+{
+    std::vector<llvm::Type*>    fields;
+
+    layout(expr, fields);
+    m_stateType->setBody(fields);
+
+    return  make(expr);
+}
+
+void    CompileExprImpl::layout(Expr* expr, std::vector<llvm::Type*>& fields)
+{
+    if(m_slots.find(expr) != m_slots.end())
+        return;
+
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+    {
+        layout(unary->arg, fields);
+    }
+    else if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        layout(binary->lhs, fields);
+        layout(binary->rhs, fields);
+    }
+    else if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+    {
+        layout(ternary->lhs, fields);
+        layout(ternary->mhs, fields);
+        layout(ternary->rhs, fields);
+    }
+
+    auto    indxType    = m_builder->getInt64Ty();
 
-    curr->addIncoming(curr0, bbHead);
-    curr->addIncoming(curr1, bbNext);
+    if(dynamic_cast<ExprYs*>(expr) || dynamic_cast<ExprYw*>(expr))
+    {
+        auto    count   = dynamic_cast<ExprConstInteger*>(dynamic_cast<ExprBinary*>(expr)->lhs)->value;
 
-    innerFrst->addIncoming(innerFrst0, bbHead);
-    innerFrst->addIncoming(innerFrst1, bbNext);
+        if(count > 0)
+        {
+            m_slots[expr]   = fields.size();
+            fields.push_back(llvm::StructType::get(*m_context, {indxType, llvm::ArrayType::get(m_boolType, count)}));
+        }
+    }
+    else if(auto temporal = dynamic_cast<Temporal<ExprBinary>*>(expr))
+    {
+        auto    time    = temporal->time;
 
-    inside->addIncoming(m_F, bbHead);
-    inside->addIncoming(inside1, bbNext);
-}
+        m_slots[expr]   = fields.size();
 
-llvm::Value*    CompileExprImpl::getNext(llvm::Value* curr)
-{
-    return  m_builder->CreateGEP(m_propType, curr, m_p1, "next");
+        if(!time || (!time->lo && !time->hi))
+        {
+            //  valid, value
+            fields.push_back(llvm::StructType::get(*m_context, {m_boolType, m_boolType}));
+        }
+        else if(!time->lo)
+        {
+            //  seen, prev, valid, t0, t1, value
+            fields.push_back(llvm::StructType::get(*m_context, {m_boolType, indxType, m_boolType, indxType, indxType, m_boolType}));
+        }
+        else
+        {
+            //  seen, prev, valid, t0, t1, value, window
+            m_windows.push_back(fields.size());
+            fields.push_back(llvm::StructType::get(*m_context, {m_boolType, indxType, m_boolType, indxType, indxType, m_boolType, m_builder->getInt8PtrTy()}));
+        }
+    }
 }
 
-llvm::Value*    CompileExprImpl::getPrev(llvm::Value* curr)
+void    CompileExprImpl::done(llvm::Value* state)
 {
-    return  m_builder->CreateGEP(m_propType, curr, m_m1, "prev");
+    auto    free    = m_module->getOrInsertFunction("referee_window_free", m_builder->getVoidTy(), llvm::PointerType::get(m_builder->getInt8PtrTy(), 0));
+
+    for(auto slot: m_windows)
+    {
+        auto    slotType= m_stateType->getElementType(slot);
+        auto    slotPtr = m_builder->CreateStructGEP(m_stateType, state, slot);
+
+        m_builder->CreateCall(free, {m_builder->CreateStructGEP(slotType, slotPtr, 6)});
+    }
 }
 
-llvm::Value*    CompileExprImpl::getTime(llvm::Value* curr, std::string name)
+llvm::Type* Compile::make(llvm::LLVMContext* context, llvm::Module* module, Type* type, std::string name)
 {
-    return  m_builder->CreateLoad(m_builder->getInt64Ty(), m_builder->CreateStructGEP(m_propType, curr, 0), false, name);
+    CompileTypeImpl impl(context, module);
+
+    return impl.make(type, name);
 }
 
-llvm::Value*    CompileExprImpl::getPropPtr(llvm::Value* var)
+llvm::Value*Compile::make(llvm::LLVMContext* context, llvm::Module* module, Expr* expr)
 {
-    return m_builder->CreateLoad(m_propPtrType, var);
+    return nullptr;
 }
 
-llvm::Value*    CompileExprImpl::setPropPtr(llvm::Value* var, llvm::Value* val)
+//  G(expr) over a past-time expr can be checked one sample at a time:
+//
+//      "<name>.size"                       bytes of the state
+//      "<name>.init"(state)                zeroes the state
+//      "<name>.step"(state, curr, conf)    value of expr at curr, samples in time order
+//      "<name>.done"(state)                releases what the state holds on to
+//
+//  the spec holds as long as every step returns true
+static void monitor(
+                llvm::LLVMContext*  context,
+                llvm::Module*       module,
+                llvm::IRBuilder<>*  builder,
+                Module*             refmod,
+                Expr*               expr,
+                std::string         name,
+                llvm::Type*         propPtrType,
+                llvm::Type*         confPtrType)
 {
-    return m_builder->CreateStore(val, var);
+    auto    globally    = dynamic_cast<ExprRw*>(expr);
+    if(!globally)
+        return;
+
+    auto    never       = dynamic_cast<ExprConstBoolean*>(globally->lhs);
+    auto    timed       = globally->time && (globally->time->lo || globally->time->hi);
+    if(!never || never->value || timed || !isPastTime(globally->rhs))
+        return;
+
+    auto    stateType   = llvm::StructType::create(*context, name + ".state");
+    auto    statePtrType= llvm::PointerType::get(stateType, 0);
+
+    auto    stepType    = llvm::FunctionType::get(builder->getInt1Ty(), {statePtrType, propPtrType, confPtrType}, false);
+    auto    stepBody    = llvm::Function::Create(stepType, llvm::Function::ExternalLinkage, name + ".step", module);
+    auto    stepArgs    = stepBody->args().begin();
+
+    stepArgs->setName("state"); stepArgs++;
+    stepArgs->setName("curr");  stepArgs++;
+    stepArgs->setName("conf");
+
+    builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", stepBody));
+
+    CompileExprImpl compStep(context, module, builder, stepBody, refmod, stateType);
+
+    builder->CreateRet(compStep.step(globally->rhs));
+
+    auto    size        = llvm::ConstantExpr::getSizeOf(stateType);
+    new llvm::GlobalVariable(*module, size->getType(), true, llvm::GlobalValue::ExternalLinkage, size, name + ".size");
+
+    auto    initType    = llvm::FunctionType::get(builder->getVoidTy(), {statePtrType}, false);
+    auto    initBody    = llvm::Function::Create(initType, llvm::Function::ExternalLinkage, name + ".init", module);
+    auto    initArg     = initBody->args().begin();
+
+    initArg->setName("state");
+    builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", initBody));
+    builder->CreateMemSet(initArg, builder->getInt8(0), size, llvm::MaybeAlign());
+    builder->CreateRetVoid();
+
+    auto    doneBody    = llvm::Function::Create(initType, llvm::Function::ExternalLinkage, name + ".done", module);
+    auto    doneArg     = doneBody->args().begin();
+
+    doneArg->setName("state");
+    builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", doneBody));
+    compStep.done(doneArg);
+    builder->CreateRetVoid();
 }
 
-llvm::Value*    CompileExprImpl::getBool(llvm::Value* var)
+//  G(expr) over an expr whose reach is bounded can be checked one chunk of
+//  rows at a time, on a window of the trace around it:
+//
+//      "<name>.chunk"(frst, last, conf, lo, hi, carry, summary)
+//                                          value of G(expr) over rows [lo, hi) of the window
+//      "<name>.horizon"                    ahead, next, back, prev, count of seams
+//      "<name>.seams"                      per seam: depth - 1 << 1 | past
+//
+//  the window is found from the horizon and the seams are stitched from the
+//  summaries by Chunks
+static void chunk(
+                llvm::LLVMContext*  context,
+                llvm::Module*       module,
+                llvm::IRBuilder<>*  builder,
+                Module*             refmod,
+                Expr*               expr,
+                std::string         name,
+                llvm::Type*         propPtrType,
+                llvm::Type*         confPtrType,
+                Options const&      options)
 {
-    return m_builder->CreateLoad(m_boolType, var);
+    auto    globally    = dynamic_cast<ExprRw*>(expr);
+    if(!globally || !options.sweep)
+        return;
+
+    Reach   most;
+    auto    never       = dynamic_cast<ExprConstBoolean*>(globally->lhs);
+    auto    timed       = globally->time && (globally->time->lo || globally->time->hi);
+    if(!never || never->value || timed || !reach(globally->rhs, Reach(), most))
+        return;
+
+    auto    bytePtrType = builder->getInt8PtrTy();
+    auto    indxType    = builder->getInt64Ty();
+    auto    funcType    = llvm::FunctionType::get(builder->getInt1Ty(), {propPtrType, propPtrType, confPtrType, indxType, indxType, bytePtrType, bytePtrType}, false);
+    auto    funcBody    = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, name + ".chunk", module);
+    auto    funcArgs    = funcBody->args().begin();
+
+    funcArgs->setName("frst");      funcArgs++;
+    funcArgs->setName("last");      funcArgs++;
+    funcArgs->setName("conf");      funcArgs++;
+    funcArgs->setName("lo");        funcArgs++;
+    funcArgs->setName("hi");        funcArgs++;
+    funcArgs->setName("carry");     funcArgs++;
+    funcArgs->setName("summary");
+
+    builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", funcBody));
+
+    auto    plain       = options;
+    plain.witness       = false;
+
+    CompileExprImpl compChunk(context, module, builder, funcBody, refmod, plain);
+
+    auto    result      = compChunk.chunk(globally);
+    compChunk.release();
+    builder->CreateRet(result);
+
+    auto    seams       = compChunk.seams();
+    auto    horizon     = llvm::ConstantDataArray::get(*context, llvm::ArrayRef<uint64_t>({
+                            uint64_t(most.ahead), uint64_t(most.next), uint64_t(most.back), uint64_t(most.prev), uint64_t(seams.size())}));
+    new llvm::GlobalVariable(*module, horizon->getType(), true, llvm::GlobalValue::ExternalLinkage, horizon, name + ".horizon");
+
+    auto    codes       = llvm::ConstantDataArray::get(*context, llvm::ArrayRef<uint8_t>(seams));
+    new llvm::GlobalVariable(*module, codes->getType(), true, llvm::GlobalValue::ExternalLinkage, codes, name + ".seams");
 }
 
-llvm::Value*    CompileExprImpl::setBool(llvm::Value* var, llvm::Value* val)
+//  the expr a spec checks at every sample, or nullptr for scopes other than globally
+static Expr*    monitored(Spec* spec)
 {
-    return m_builder->CreateStore(val, var);
+    if(auto globally = dynamic_cast<SpecGlobally*>(spec))
+        return  monitored(globally->spec);
+
+    if(dynamic_cast<SpecScoped*>(spec))
+        return  nullptr;
+
+    return  Rewrite::make(spec);
 }
 
-llvm::Value*    CompileExprImpl::make(Expr* expr)
+//  true if every sample expr reads is the current one, the conf or bound by an @ inside it
+static bool isClosed(Expr* expr, std::vector<std::string>& bound)
 {
-    auto    save    = m_value;
+    ExprContext*    ctxt    = dynamic_cast<ExprContext*>(expr);
 
-    expr->accept(*this);
+    if(auto data = dynamic_cast<ExprData*>(expr))
+        ctxt    = data->ctxt;
+    if(auto conf = dynamic_cast<ExprConf*>(expr))
+        ctxt    = conf->ctxt;
 
-    auto    result  = m_value;
-    m_value = save;
+    if(ctxt)
+    {
+        return  ctxt->name == "__curr__" || ctxt->name == "__conf__"
+            ||  std::find(bound.begin(), bound.end(), ctxt->name) != bound.end();
+    }
 
-    return  result;
-}
+    if(auto at = dynamic_cast<ExprAt*>(expr))
+    {
+        bound.push_back(at->name);
+        auto    closed  = isClosed(at->arg, bound);
+        bound.pop_back();
 
-llvm::Value*    CompileExprImpl::make(Spec* spec)
-{
-    auto    save    = m_value;
+        return  closed;
+    }
 
-    spec->accept(*this);
+    if(auto unary = dynamic_cast<ExprUnary*>(expr))
+    {
+        return  isClosed(unary->arg, bound);
+    }
 
-    auto    result  = m_value;
-    m_value = save;
+    if(auto binary = dynamic_cast<ExprBinary*>(expr))
+    {
+        return  isClosed(binary->lhs, bound) && isClosed(binary->rhs, bound);
+    }
 
-    return  result;
+    if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+    {
+        return  isClosed(ternary->lhs, bound) && isClosed(ternary->mhs, bound) && isClosed(ternary->rhs, bound);
+    }
+
+    return  true;
 }
 
-llvm::Type* Compile::make(llvm::LLVMContext* context, llvm::Module* module, Type* type, std::string name)
+//  the U/R/S/T nested under a temporal operator in more than one function of
+//  refmod, inner ones first, each named "shared.<level>.<n>" where a level 0
+//  one reads no other and a level k + 1 one reads one of level k; hash-consing
+//  makes equal subformulas one node, so they are counted by pointer
+static std::vector<std::pair<Expr*, std::string>>   shareable(Module* refmod)
 {
-    CompileTypeImpl impl(context, module);
+    Report::Scope                       scope("share");
 
-    return impl.make(type, name);
+    std::vector<Expr*>                  order;
+    std::map<Expr*, std::set<size_t>>   users;
+    size_t                              func    = 0;
+
+    std::function<void(Expr*, bool)>    walk    = [&](Expr* expr, bool nested)
+    {
+        if(dynamic_cast<ExprAt*>(expr))
+            return;     //  read with names bound, never from a buffer
+
+        auto    temporal    = dynamic_cast<Temporal<ExprBinary>*>(expr);
+        auto    stepping    = dynamic_cast<ExprXs*>(expr) || dynamic_cast<ExprXw*>(expr)
+                           || dynamic_cast<ExprYs*>(expr) || dynamic_cast<ExprYw*>(expr);
+        auto    inner       = nested || temporal || stepping;
+
+        if(auto unary = dynamic_cast<ExprUnary*>(expr))
+        {
+            walk(unary->arg, inner);
+        }
+        else if(auto binary = dynamic_cast<ExprBinary*>(expr))
+        {
+            walk(binary->lhs, inner);
+            walk(binary->rhs, inner);
+        }
+        else if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+        {
+            walk(ternary->lhs, inner);
+            walk(ternary->mhs, inner);
+            walk(ternary->rhs, inner);
+        }
+
+        std::vector<std::string>    bound;
+        auto    bounds  = temporal
+                       && (!temporal->time
+                       || (  (!temporal->time->lo || isInvariant(temporal->time->lo))
+                          && (!temporal->time->hi || isInvariant(temporal->time->hi))));
+
+        if(nested && bounds && !dynamic_cast<ExprInt*>(expr) && isClosed(expr, bound))
+        {
+            if(users[expr].empty())
+                order.push_back(expr);
+            users[expr].insert(func);
+        }
+    };
+
+    for(auto expr: refmod->getExprs())
+    {
+        auto    temp    = Rewrite::make(expr);
+        TypeCalc::make(refmod, temp);
+        walk(temp, false);
+        func++;
+    }
+
+    for(auto spec: refmod->getSpecs())
+    {
+        if(auto temp = monitored(spec))
+        {
+            TypeCalc::make(refmod, temp);
+            walk(temp, false);
+        }
+        func++;
+    }
+
+    std::map<Expr*, int>        levels;
+    std::function<int(Expr*)>   level;
+    std::function<int(Expr*)>   below   = [&](Expr* expr)
+    {
+        auto    most    = -1;
+
+        if(auto unary = dynamic_cast<ExprUnary*>(expr))
+        {
+            most    = level(unary->arg);
+        }
+        else if(auto binary = dynamic_cast<ExprBinary*>(expr))
+        {
+            most    = std::max(level(binary->lhs), level(binary->rhs));
+        }
+        else if(auto ternary = dynamic_cast<ExprTernary*>(expr))
+        {
+            most    = std::max({level(ternary->lhs), level(ternary->mhs), level(ternary->rhs)});
+        }
+
+        return  most;
+    };
+    level   = [&](Expr* expr)
+    {
+        return  levels.count(expr) ? levels[expr] : below(expr);
+    };
+
+    std::vector<std::pair<Expr*, std::string>>  result;
+    for(auto expr: order)
+    {
+        if(users[expr].size() < 2)
+            continue;
+
+        //  inner subformulas come first, their levels are known
+        levels[expr]    = below(expr) + 1;
+
+        result.emplace_back(expr, "shared." + std::to_string(levels[expr]) + "." + std::to_string(result.size()));
+    }
+
+    return  result;
 }
 
-llvm::Value*Compile::make(llvm::LLVMContext* context, llvm::Module* module, Expr* expr)
+std::string Compile::name(Position const& pos)
 {
-    return nullptr;
+    return  std::to_string(pos.beg.row) + ":" + std::to_string(pos.beg.col) + " .. " + std::to_string(pos.end.row) + ":" + std::to_string(pos.end.col);
 }
 
-void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* refmod)
+void Compile::declare(llvm::LLVMContext* context, llvm::Module* module, Module* refmod, Options const& options)
 {
     auto    builder = std::make_unique<llvm::IRBuilder<>>(*context);
 
@@ -1990,12 +4819,15 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
         confTypes.push_back(make(context, module, type, name));
     }
     auto    confType    = llvm::StructType::create(*context, confTypes, "__conf_t");
-    auto    confPtrType = llvm::PointerType::get(confType, 0);
     module->getOrInsertGlobal("__conf__", confType);
 
-    //  create __prop__
+    //  create __prop__, with Layout::columns the props go to __cols_t and
+    //  every function takes the column arrays as a trailing argument, with
+    //  Layout::values the scalar props are stored in the row itself
     auto    propNames   = refmod->getPropNames();
+    auto    columns     = options.layout == Layout::columns;
     std::vector<llvm::Type*>    propTypes;
+    std::vector<llvm::Type*>    colsTypes;
     propTypes.push_back(builder->getInt64Ty()); //  __time__
     for(auto name: propNames)
     {
@@ -2003,33 +4835,151 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
             continue;
 
         auto    type    = refmod->getProp(name);
-        propTypes.push_back(llvm::PointerType::get(make(context, module, type, name), 0));
+        auto    llvmType= make(context, module, type, name);
+
+        if(columns)
+            colsTypes.push_back(llvm::PointerType::get(llvmType, 0));
+        else if(options.layout == Layout::values && (llvmType->isIntegerTy() || llvmType->isFloatingPointTy()))
+            propTypes.push_back(llvmType);
+        else
+            propTypes.push_back(llvm::PointerType::get(llvmType, 0));
     }
     auto    propType    = llvm::StructType::create(*context, propTypes, "__prop_t");
     auto    propPtrType = llvm::PointerType::get(propType, 0);
     module->getOrInsertGlobal("__prop__", propPtrType);
 
+    if(columns)
+    {
+        llvm::StructType::create(*context, colsTypes, "__cols_t");
+    }
+}
+
+void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* refmod, Options const& options)
+{
+    make(context, module, refmod, options, 0, 1);
+}
+
+void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* refmod, Options const& options, size_t part, size_t parts)
+{
+    //  equal exprs are one node with one position, deal them by function name
+    std::map<std::string, size_t>   dealt;
+    auto    skip    = [&](std::string const& funcName)
+    {
+        auto    it  = dealt.emplace(funcName, dealt.size()).first;
+        return  it->second % parts != part;
+    };
+
+    make(context, module, refmod, options, skip);
+}
+
+void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* refmod, Options const& options, std::set<std::string> const& names)
+{
+    make(context, module, refmod, options, [&](std::string const& funcName) {return !names.count(funcName);});
+}
+
+void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* refmod, Options const& options, std::function<bool(std::string const&)> const& skip)
+{
+    auto    builder = std::make_unique<llvm::IRBuilder<>>(*context);
+
+    declare(context, module, refmod, options);
+
+    auto    propPtrType = llvm::PointerType::get(llvm::StructType::getTypeByName(*context, "__prop_t"), 0);
+    auto    confPtrType = llvm::PointerType::get(llvm::StructType::getTypeByName(*context, "__conf_t"), 0);
+    auto    columns     = options.layout == Layout::columns;
+
+    std::vector<llvm::Type*>    argTypes    = {propPtrType, propPtrType, confPtrType};
+    if(columns)
+    {
+        auto    colsType    = llvm::StructType::getTypeByName(*context, "__cols_t");
+        argTypes.push_back(llvm::PointerType::get(colsType, 0));
+    }
+
+    //  with Options::witness every function takes an i64[4] it fills when it
+    //  fails: row, __time__, deciding row and depth of the deciding operator
+    if(options.witness)
+    {
+        argTypes.push_back(llvm::PointerType::get(builder->getInt64Ty(), 0));
+    }
+
+    //  subformulas nested in several functions are tabulated over the trace by a
+    //  function of their own, into "<name>.buffer" when Referee::check fills it
+    //  ahead of the specs, see CompileExprImpl::shared()
+    auto    fillables   = options.share ? shareable(refmod) : std::vector<std::pair<Expr*, std::string>>();
+    auto    shared      = std::map<Expr*, std::string>(fillables.begin(), fillables.end());
+    auto    plain       = options;
+    auto    fillTypes   = argTypes;
+
+    plain.witness   = false;
+    if(options.witness)
+        fillTypes.pop_back();
+
+    for(auto [expr, fillName]: fillables)
+    {
+        if(skip(fillName))
+            continue;
+
+        auto    global      = llvm::cast<llvm::GlobalVariable>(module->getOrInsertGlobal(fillName + ".buffer", builder->getInt8PtrTy()));
+        global->setInitializer(llvm::ConstantPointerNull::get(builder->getInt8PtrTy()));
+
+        auto    funcType    = llvm::FunctionType::get(builder->getInt8PtrTy(), fillTypes, false);
+        auto    funcBody    = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, fillName, module);
+        auto    funcArgs    = funcBody->args().begin();
+
+        funcArgs->setName("frst");  funcArgs++;
+        funcArgs->setName("last");  funcArgs++;
+        funcArgs->setName("conf");  funcArgs++;
+        if(columns)
+            funcArgs->setName("cols");
+
+        Report::Scope   scope("function", fillName);
+
+        builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", funcBody));
+
+        CompileExprImpl compFill(context, module, builder.get(), funcBody, refmod, plain);
+
+        compFill.share(&shared);
+        auto    result      = compFill.tabulate(expr);
+        compFill.release();
+        builder->CreateRet(result);
+
+        if(Report::enabled())
+            Report::emitted(fillName, count(expr), funcBody->size(), funcBody->getInstructionCount());
+    }
+
     auto    exprs   = refmod->getExprs();
     for(auto expr: exprs)
     {
-        auto    pos         = expr->where();
-        auto    funcName    = std::to_string(pos.beg.row) + ":" + std::to_string(pos.beg.col) + " .. " + std::to_string(pos.end.row) + ":" + std::to_string(pos.end.col);
-        auto    funcType    = llvm::FunctionType::get(builder->getInt1Ty(), {propPtrType, propPtrType, confPtrType}, false);
+        if(skip(name(expr->where())))
+            continue;
+
+        auto    funcName    = name(expr->where());
+        Report::Scope   scope("function", funcName);
+
+        auto    funcType    = llvm::FunctionType::get(builder->getInt1Ty(), argTypes, false);
         auto    funcBody    = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, funcName, module);
         auto    funcArgs    = funcBody->args().begin();
 
+        funcBody->addRetAttr(llvm::Attribute::ZExt);    //  a C bool, callers may read the whole register
+
         funcArgs->setName("frst");  funcArgs++;
         funcArgs->setName("last");  funcArgs++;
-        funcArgs->setName("conf");
+        funcArgs->setName("conf");  funcArgs++;
+        if(columns)
+            funcArgs++->setName("cols");
+        if(options.witness)
+            funcArgs->setName("witness");
 
         auto    bb          = llvm::BasicBlock::Create(*context, "entry", funcBody);
         builder->SetInsertPoint(bb);
 
-        CompileExprImpl compExpr(context, module, builder.get(), funcBody, refmod);
+        CompileExprImpl compExpr(context, module, builder.get(), funcBody, refmod, options);
+        compExpr.share(&shared);
 
         auto    temp        = Rewrite::make(expr);
         TypeCalc::make(refmod, temp);
-        builder->CreateRet(compExpr.make(temp));
+        auto    result      = compExpr.verdict(temp);
+        compExpr.release();
+        builder->CreateRet(result);
         if(!llvm::verifyFunction(*funcBody, &llvm::outs()))
         {
 //  LCOV_EXCL_START 
@@ -2038,27 +4988,53 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
 //  GCOV_EXCL_STOP
 //  LCOV_EXCL_STOP
         }
+
+        if(Report::enabled())
+            Report::emitted(funcName, count(temp), funcBody->size(), funcBody->getInstructionCount());
+
+        if(options.monitor && !columns)
+        {
+            monitor(context, module, builder.get(), refmod, temp, funcBody->getName().str(), propPtrType, confPtrType);
+        }
+
+        if(options.chunk && !columns)
+        {
+            chunk(context, module, builder.get(), refmod, temp, funcBody->getName().str(), propPtrType, confPtrType, options);
+        }
     }
 
     auto    specs   = refmod->getSpecs();
     for(auto spec: specs)
     {
-        auto    pos         = spec->where();
-        auto    funcName    = std::to_string(pos.beg.row) + ":" + std::to_string(pos.beg.col) + " .. " + std::to_string(pos.end.row) + ":" + std::to_string(pos.end.col);
-        auto    funcType    = llvm::FunctionType::get(builder->getInt1Ty(), {propPtrType, propPtrType, confPtrType}, false);
+        if(skip(name(spec->where())))
+            continue;
+
+        auto    funcName    = name(spec->where());
+        Report::Scope   scope("function", funcName);
+
+        auto    funcType    = llvm::FunctionType::get(builder->getInt1Ty(), argTypes, false);
         auto    funcBody    = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, funcName, module);
         auto    funcArgs    = funcBody->args().begin();
 
+        funcBody->addRetAttr(llvm::Attribute::ZExt);    //  a C bool, callers may read the whole register
+
         funcArgs->setName("frst");  funcArgs++;
         funcArgs->setName("last");  funcArgs++;
-        funcArgs->setName("conf");
+        funcArgs->setName("conf");  funcArgs++;
+        if(columns)
+            funcArgs++->setName("cols");
+        if(options.witness)
+            funcArgs->setName("witness");
 
         auto    bb          = llvm::BasicBlock::Create(*context, "entry", funcBody);
         builder->SetInsertPoint(bb);
 
-        CompileExprImpl compExpr(context, module, builder.get(), funcBody, refmod);
+        CompileExprImpl compExpr(context, module, builder.get(), funcBody, refmod, options);
+        compExpr.share(&shared);
 
-        builder->CreateRet(compExpr.make(spec));
+        auto    result      = compExpr.make(spec);
+        compExpr.release();
+        builder->CreateRet(result);
 
         if(!llvm::verifyFunction(*funcBody, &llvm::outs()))
         {
@@ -2068,5 +5044,130 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
 //  GCOV_EXCL_STOP
 //  LCOV_EXCL_STOP
         }
+
+        if(Report::enabled())
+            Report::emitted(funcName, compExpr.nodes(), funcBody->size(), funcBody->getInstructionCount());
+
+        if(options.monitor && !columns)
+        {
+            if(auto temp = monitored(spec))
+            {
+                TypeCalc::make(refmod, temp);
+                monitor(context, module, builder.get(), refmod, temp, funcBody->getName().str(), propPtrType, confPtrType);
+            }
+        }
+
+        if(options.chunk && !columns)
+        {
+            if(auto temp = monitored(spec))
+            {
+                TypeCalc::make(refmod, temp);
+                chunk(context, module, builder.get(), refmod, temp, funcBody->getName().str(), propPtrType, confPtrType, options);
+            }
+        }
+    }
+}
+
+//  the constant of `type` stored at `data`, pointers keep the address they hold
+static llvm::Constant*  constant(llvm::DataLayout const& layout, llvm::Type* type, char const* data)
+{
+    if(auto structType = llvm::dyn_cast<llvm::StructType>(type))
+    {
+        auto    structLayout    = layout.getStructLayout(structType);
+
+        std::vector<llvm::Constant*>    fields;
+        for(unsigned i = 0; i < structType->getNumElements(); i++)
+        {
+            fields.push_back(constant(layout, structType->getElementType(i), data + structLayout->getElementOffset(i)));
+        }
+
+        return  llvm::ConstantStruct::get(structType, fields);
+    }
+
+    if(auto arrayType = llvm::dyn_cast<llvm::ArrayType>(type))
+    {
+        auto    size    = layout.getTypeAllocSize(arrayType->getElementType());
+
+        std::vector<llvm::Constant*>    items;
+        for(uint64_t i = 0; i < arrayType->getNumElements(); i++)
+        {
+            items.push_back(constant(layout, arrayType->getElementType(), data + i * size));
+        }
+
+        return  llvm::ConstantArray::get(arrayType, items);
+    }
+
+    uint64_t    bits    = 0;
+    std::memcpy(&bits, data, std::min<size_t>(layout.getTypeStoreSize(type), sizeof(bits)));
+
+    if(type->isIntegerTy())
+    {
+        return  llvm::ConstantInt::get(type, type->isIntegerTy(1) ? bits & 1 : bits);
+    }
+
+    if(type->isDoubleTy())
+    {
+        return  llvm::ConstantFP::get(type, llvm::APFloat(llvm::APFloat::IEEEdouble(), llvm::APInt(64, bits)));
+    }
+
+    if(type->isPointerTy())
+    {
+        return  llvm::ConstantExpr::getIntToPtr(llvm::ConstantInt::get(llvm::Type::getInt64Ty(type->getContext()), bits), type);
+    }
+
+//  LCOV_EXCL_START 
+//  GCOV_EXCL_START 
+    throw std::runtime_error(__PRETTY_FUNCTION__);
+//  GCOV_EXCL_STOP
+//  LCOV_EXCL_STOP
+}
+
+void Compile::specialize(llvm::Module* module, void const* conf)
+{
+    auto    confType    = llvm::StructType::getTypeByName(module->getContext(), "__conf_t");
+    auto    global      = module->getNamedGlobal("__conf__");
+    auto&   layout      = module->getDataLayout();
+
+    if(!confType || !global)
+    {
+        return;
+    }
+
+    global->setInitializer(constant(layout, confType, static_cast<char const*>(conf)));
+    global->setConstant(true);
+    global->setLinkage(llvm::GlobalValue::InternalLinkage);
+
+    for(auto& func: module->functions())
+    {
+        if(func.isDeclaration())
+            continue;
+
+        //  conf is the third argument of every function that takes it, the
+        //  others (.init, .done) take the state only; matching by type would
+        //  catch frst and last as well once pointers are opaque
+        if(func.arg_size() > 2)
+        {
+            func.getArg(2)->replaceAllUsesWith(global);
+        }
+
+        //  the conf reads fold here rather than in the optimizer, a lazily
+        //  compiled function only sees a declaration of __conf__
+        for(auto folded = true; folded; )
+        {
+            folded  = false;
+            for(auto& block: func)
+            {
+                for(auto iter = block.begin(); iter != block.end(); )
+                {
+                    auto&   inst    = *iter++;
+                    if(auto value = llvm::ConstantFoldInstruction(&inst, layout))
+                    {
+                        inst.replaceAllUsesWith(value);
+                        inst.eraseFromParent();
+                        folded  = true;
+                    }
+                }
+            }
+        }
     }
 }
@@ -26,6 +26,7 @@
 
 #include "../syntax.hpp"
 #include "../module.hpp"
+#include "../options.hpp"
 
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/STLExtras.h"
@@ -39,12 +40,34 @@
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
 
+#include <functional>
 #include <iostream>
+#include <set>
 
 class Compile
 {
 public:
     static llvm::Type*  make(llvm::LLVMContext* context, llvm::Module* module, Type* type, std::string name);
     static llvm::Value* make(llvm::LLVMContext* context, llvm::Module* module, Expr* expr);
-    static void         make(llvm::LLVMContext* context, llvm::Module* module, Module* mod);
+    static void         make(llvm::LLVMContext* context, llvm::Module* module, Module* mod, Options const& options = Options());
+
+    //  only the k-th distinct functions with k % parts == part (exprs counted first), so that
+    //  each of `parts` modules on its own context can be optimized and compiled concurrently
+    static void         make(llvm::LLVMContext* context, llvm::Module* module, Module* mod, Options const& options, size_t part, size_t parts);
+
+    //  only the functions named in `names`, see name()
+    static void         make(llvm::LLVMContext* context, llvm::Module* module, Module* mod, Options const& options, std::set<std::string> const& names);
+
+    //  __conf_t, __prop_t and __cols_t of `mod` without any function, as make() lays them out
+    static void         declare(llvm::LLVMContext* context, llvm::Module* module, Module* mod, Options const& options = Options());
+
+    //  defines __conf__ as the constant of the __conf_t at `conf` and folds the conf
+    //  reads of every function into it; pointers in it stay valid as long as `conf`
+    static void         specialize(llvm::Module* module, void const* conf);
+
+    //  the function make() compiles the spec or expr at `pos` to
+    static std::string  name(Position const& pos);
+
+private:
+    static void         make(llvm::LLVMContext* context, llvm::Module* module, Module* mod, Options const& options, std::function<bool(std::string const&)> const& skip);
 };
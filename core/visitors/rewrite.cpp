@@ -27,6 +27,7 @@
 #include "canonic.hpp"
 #include "../factory.hpp"
 #include "../builder.hpp"
+#include "../report.hpp"
 
 #include <exception>
 #include <assert.h>
@@ -825,6 +826,8 @@ Expr*   RewriteImpl::negated(Expr* expr)
 
 Expr*   Rewrite::make(Expr* expr)
 {
+    Report::Scope   scope("rewrite");
+
     RewriteImpl impl;
 
     return  impl.make(expr);
@@ -839,6 +842,8 @@ Time*   Rewrite::make(Time* time)
 
 Expr*   Rewrite::make(Spec* spec)
 {
+    Report::Scope   scope("rewrite");
+
     RewriteImpl impl;
 
     return  impl.make(spec);
@@ -24,6 +24,7 @@
 
 #include "typecalc.hpp"
 #include "../factory.hpp"
+#include "../report.hpp"
 
 #include <exception>
 
@@ -958,6 +959,8 @@ Type*   TypeCalcImpl::safe(Time*          time)
 
 Type*   TypeCalc::make(Module* module, Expr* expr)
 {
+    Report::Scope   scope("typecalc");
+
     TypeCalcImpl impl(module);
 
     return  impl.make(expr);
@@ -965,6 +968,8 @@ Type*   TypeCalc::make(Module* module, Expr* expr)
 
 Type*   TypeCalc::make(Module* module, Spec* spec)
 {
+    Report::Scope   scope("typecalc");
+
     TypeCalcImpl impl(module);
 
     return  impl.make(spec);
@@ -22,6 +22,7 @@
  *  SOFTWARE.
  */
 #include "referee.hpp"
+#include "report.hpp"
 
 #include <spdlog/spdlog.h>
 #include "spdlog/fmt/fmt.h"
@@ -36,11 +37,87 @@ int main(int argc, char * argv[])
     CLI::App    app("referee");
     
     std::string refFilename = "default";
+    std::string trcFilename;
+    std::string cnfFilename;
     bool        flDebug     = false;
+    bool        flPassed    = true;
+    bool        flNoSweep   = false;
+    bool        flNoBitset  = false;
+    bool        flNoShare   = false;
+    bool        flMonitor   = false;
+    bool        flEager     = false;
+    bool        flWatch     = false;
+    std::string layout      = "pointers";
+    size_t      cacheSize   = 256;
+    std::string emit        = "ll";
+    std::string outFilename;
+    std::string timeReport;
+    Options     options;
 
     auto        compile = app.add_subcommand("compile", "Compile REF file");
     compile->add_option( "reffile", refFilename, "REF file to parse")
         ->check(CLI::ExistingFile);
+    compile->add_flag(   "--no-sweep",  flNoSweep,  "Rescan nested temporal operators from every position");
+    compile->add_flag(   "--no-bitset", flNoBitset, "Sweep nested untimed operators one row at a time instead of 64 rows per word");
+    compile->add_flag(   "--no-share",  flNoShare,  "Evaluate subformulas shared by several specs in each of them");
+    compile->add_flag(   "--monitor",   flMonitor,  "Also emit init/step/done functions for past-time specs");
+    compile->add_option( "-O,--opt-level", options.optLevel, "Optimization level of the generated code, 0..3")
+        ->check(CLI::Range(0, 3));
+    compile->add_option( "--cpu",       options.cpu,      "CPU to generate code for, the host by default");
+    compile->add_option( "--features",  options.features, "Target features to add or remove, e.g. +avx2,-avx512f");
+    compile->add_option( "--layout",    layout,     "Sample layout: pointers, columns or values")
+        ->check(CLI::IsMember(std::vector<std::string>{"pointers", "columns", "values"}));
+    compile->add_option( "--emit",      emit,       "Output: ll, bc, obj or so, all but ll need -o and come with a C header")
+        ->check(CLI::IsMember(std::vector<std::string>{"ll", "bc", "obj", "so"}));
+    compile->add_option( "-o,--output", outFilename,"File to write, the C header goes next to it with a .h extension");
+    compile->add_flag(   "--time-report{text}", timeReport, "Print the time, allocations and IR size of each phase and function to stderr, =json for JSON")
+        ->check(CLI::IsMember(std::vector<std::string>{"text", "json"}));
+
+    auto        check   = app.add_subcommand("check", "Check REF file against a trace");
+    check->add_option(   "reffile", refFilename, "REF file to parse")
+        ->check(CLI::ExistingFile)
+        ->required();
+    check->add_option(   "trace",   trcFilename, "Trace file to check (.rdb or .csv)")
+        ->check(CLI::ExistingFile)
+        ->required();
+    check->add_option(   "--conf",  cnfFilename, "CSV file with conf values")
+        ->check(CLI::ExistingFile);
+    check->add_flag(     "--no-sweep",  flNoSweep,  "Rescan nested temporal operators from every position");
+    check->add_flag(     "--no-bitset", flNoBitset, "Sweep nested untimed operators one row at a time instead of 64 rows per word");
+    check->add_flag(     "--no-share",  flNoShare,  "Evaluate subformulas shared by several specs in each of them");
+    check->add_option(   "-O,--opt-level", options.optLevel, "Optimization level of the generated code, 0..3")
+        ->check(CLI::Range(0, 3));
+    check->add_option(   "--cpu",       options.cpu,      "CPU to generate code for, the host by default");
+    check->add_option(   "--features",  options.features, "Target features to add or remove, e.g. +avx2,-avx512f");
+    check->add_option(   "--layout",    layout,     "Sample layout: pointers, columns or values")
+        ->check(CLI::IsMember(std::vector<std::string>{"pointers", "columns", "values"}));
+    check->add_option(   "-j,--jobs",   options.jobs,   "Threads to evaluate specs on, 0 for one per hardware thread");
+    check->add_option(   "--chunk",     options.chunk,  "Rows per chunk to split a G(...) spec into, 0 to check it whole");
+    check->add_flag(     "--witness",   options.witness,"Report the sample each failing spec fails at");
+    check->add_option(   "--cache",     options.cache,  "Directory to keep compiled specs in between runs");
+    check->add_option(   "--cache-size",cacheSize,      "Megabytes the cache directory is trimmed to");
+    check->add_flag(     "--eager",     flEager,        "Compile every function up front instead of when first called");
+    check->add_option(   "--line",      options.lines,  "Only check the exprs and specs starting on these lines");
+    check->add_flag(     "--specialize",options.specialize, "Compile the specs for the conf values of this run, bypasses --cache");
+    check->add_flag(     "--time-report{text}", timeReport, "Print the time, allocations and IR size of each phase and function to stderr, =json for JSON")
+        ->check(CLI::IsMember(std::vector<std::string>{"text", "json"}));
+
+    auto        monitor = app.add_subcommand("monitor", "Check past-time REF specs sample by sample");
+    monitor->add_option( "reffile", refFilename, "REF file to parse")
+        ->check(CLI::ExistingFile)
+        ->required();
+    monitor->add_option( "trace",   trcFilename, "Trace file to stream (.rdb or .csv)")
+        ->check(CLI::ExistingFile)
+        ->required();
+    monitor->add_option( "--conf",  cnfFilename, "CSV file with conf values")
+        ->check(CLI::ExistingFile);
+    monitor->add_option( "-O,--opt-level", options.optLevel, "Optimization level of the generated code, 0..3")
+        ->check(CLI::Range(0, 3));
+    monitor->add_option( "--cpu",       options.cpu,      "CPU to generate code for, the host by default");
+    monitor->add_option( "--features",  options.features, "Target features to add or remove, e.g. +avx2,-avx512f");
+    monitor->add_flag(   "--watch",     flWatch,        "Recompile the specs that change in the REF file while the trace streams");
+    monitor->add_flag(   "--time-report{text}", timeReport, "Print the time, allocations and IR size of each phase and function to stderr, =json for JSON")
+        ->check(CLI::IsMember(std::vector<std::string>{"text", "json"}));
     
     try {
         app.parse(argc, argv);
@@ -50,12 +127,52 @@ int main(int argc, char * argv[])
             spdlog::set_level(spdlog::level::debug);
         }
 
+        options.sweep   = !flNoSweep;
+        options.bitset  = !flNoBitset;
+        options.share   = !flNoShare;
+        options.monitor = flMonitor;
+        options.lazy    = !flEager;
+        options.watch   = flWatch ? refFilename : "";
+        options.cacheSize   = cacheSize << 20;
+        options.layout  = layout == "columns" ? Layout::columns
+                        : layout == "values"  ? Layout::values
+                        : Layout::pointers;
+
+        Report::enable(!timeReport.empty());
+
         if(app.got_subcommand("compile"))
         {
             std::ifstream   is(refFilename, std::ios_base::in);
 
-            Referee::compile(is, refFilename);
+            if(outFilename.empty() && emit != "ll")
+                throw std::runtime_error("--emit=" + emit + " needs -o");
+
+            if(outFilename.empty())
+                Referee::compile(is, refFilename, std::cout, options);
+            else
+                flPassed    = Referee::emit(is, refFilename, outFilename,
+                                    emit == "bc"  ? Emit::bc
+                                  : emit == "obj" ? Emit::obj
+                                  : emit == "so"  ? Emit::so
+                                  :                 Emit::ll, options);
+        }
+
+        if(app.got_subcommand("check"))
+        {
+            std::ifstream   is(refFilename, std::ios_base::in);
+
+            flPassed    = Referee::check(is, refFilename, trcFilename, cnfFilename, std::cout, options);
         }
+
+        if(app.got_subcommand("monitor"))
+        {
+            std::ifstream   is(refFilename, std::ios_base::in);
+
+            flPassed    = Referee::monitor(is, refFilename, trcFilename, cnfFilename, std::cout, options);
+        }
+
+        if(Report::enabled())
+            Report::print(std::cerr, timeReport == "json");
     }
     catch (const CLI::ParseError &e)
     {
@@ -67,5 +184,5 @@ int main(int argc, char * argv[])
         return 1;
     }
 
-    return 0;
+    return flPassed ? 0 : 2;
 }
@@ -30,8 +30,18 @@
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <cstring>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <queue>
+#include <tuple>
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "rapidcsv.h"
 #include "utils.hpp"
@@ -129,6 +139,7 @@ public:
     virtual void        number(     double&             data) = 0;
     virtual void        boolean(    bool&               data) = 0;
     virtual void        string(     std::string&        data) = 0;
+    virtual void        string(     std::string_view&   data) = 0;
     virtual void        size(       unsigned&           size) = 0;
     virtual void        done() = 0;
 };
@@ -137,29 +148,31 @@ class DataReaderPlain
     : public DataReader::Impl
 {
 public:
-    DataReaderPlain(std::string const& data);
+    DataReaderPlain(std::string_view data);
 
     void        integer(    int64_t&            data) override;
     void        number(     double&             data) override;
     void        boolean(    bool&               data) override;
     void        string(     std::string&        data) override;
+    void        string(     std::string_view&   data) override;
     void        size(       unsigned&           size) override;
     void        done() override;
 
 private:
-    std::istringstream  m_is;
+    std::string_view    m_data;
 };
 
 class DataReaderTyped
     : public DataReader::Impl
 {
 public:
-    DataReaderTyped(std::string const& data, Type* type);
+    DataReaderTyped(std::string_view data, Type* type);
 
     void        integer(    int64_t&            data) override;
     void        number(     double&             data) override;
     void        boolean(    bool&               data) override;
     void        string(     std::string&        data) override;
+    void        string(     std::string_view&   data) override;
     void        size(       unsigned&           size) override;
     void        done() override;
 
@@ -340,12 +353,88 @@ std::string     DataWriter::build()
     return  m_impl->build();
 }
 
-DataReader::DataReader( std::string const&  data)
-    : m_impl(new DataReaderPlain(data))
+//  plain decoding straight off the front of data, shared by DataReader and
+//  DataReaderPlain so that untyped reads need no Impl
+static char const*  take(   std::string_view&   data,
+                            size_t              size)
+{
+    if(data.size() < size)
+        throw   std::runtime_error("truncated data");
+
+    auto    head    = data.data();
+    data.remove_prefix(size);
+
+    return  head;
+}
+
+static uint32_t get32(      std::string_view&   data)
+{
+    uint32_t    value;
+    std::memcpy(&value, take(data, sizeof(value)), sizeof(value));
+    return  ntohl(value);
+}
+
+static uint64_t get64(      std::string_view&   data)
+{
+    uint64_t    value;
+    std::memcpy(&value, take(data, sizeof(value)), sizeof(value));
+    return  ntohll(value);
+}
+
+static void decode(         std::string_view&   data,
+                            int64_t&            value)
+{
+    int64_t buff;
+    std::memcpy(&buff, take(data, sizeof(buff)), sizeof(buff));
+    value   = ntohll(buff);
+}
+
+static void decode(         std::string_view&   data,
+                            double&             value)
+{
+    uint64_t    buff;
+    std::memcpy(&buff, take(data, sizeof(buff)), sizeof(buff));
+    buff    = ntohll(buff);
+    std::memcpy(&value, &buff, sizeof(value));
+}
+
+static void decode(         std::string_view&   data,
+                            bool&               value)
+{
+    value   = *take(data, sizeof(value)) != 0;
+}
+
+static void decode(         std::string_view&   data,
+                            std::string_view&   value)
+{
+    uint32_t    size;
+    std::memcpy(&size, take(data, sizeof(size)), sizeof(size));
+    size    = ntohl(size);
+    value   = std::string_view(take(data, size), size);
+}
+
+static void decode(         std::string_view&   data,
+                            std::string&        value)
+{
+    std::string_view    view;
+    decode(data, view);
+    value.assign(view);
+}
+
+static void decode(         std::string_view&   data,
+                            unsigned&           value)
+{
+    uint32_t    buff;
+    std::memcpy(&buff, take(data, sizeof(buff)), sizeof(buff));
+    value   = ntohl(buff);
+}
+
+DataReader::DataReader( std::string_view    data)
+    : m_data(data)
 {
 }
 
-DataReader::DataReader( std::string const&  data,
+DataReader::DataReader( std::string_view    data,
                         Type*               type)
     : m_impl(new DataReaderTyped(data, type))
 {
@@ -355,43 +444,68 @@ DataReader::~DataReader() = default;
 
 DataReader& DataReader::integer(    int64_t&            data)
 {
-    m_impl->integer(data);
+    if(m_impl)
+        m_impl->integer(data);
+    else
+        decode(m_data, data);
 
     return *this;
 }
 
 DataReader& DataReader::number(     double&             data)
 {
-    m_impl->number(data);
+    if(m_impl)
+        m_impl->number(data);
+    else
+        decode(m_data, data);
 
     return *this;
 }
 DataReader& DataReader::boolean(    bool&               data)
 {
-    m_impl->boolean(data);
+    if(m_impl)
+        m_impl->boolean(data);
+    else
+        decode(m_data, data);
 
     return *this;
 }
 DataReader& DataReader::string(     std::string&        data)
 {
-    m_impl->string(data);
+    if(m_impl)
+        m_impl->string(data);
+    else
+        decode(m_data, data);
+
+    return *this;
+}
+DataReader& DataReader::string(     std::string_view&   data)
+{
+    if(m_impl)
+        m_impl->string(data);
+    else
+        decode(m_data, data);
 
     return *this;
 }
 DataReader& DataReader::size(       unsigned&           size)
 {
-    m_impl->size(size);
+    if(m_impl)
+        m_impl->size(size);
+    else
+        decode(m_data, size);
 
     return *this;
 }
 
 void        DataReader::done()
 {
-    m_impl->done();
+    if(m_impl)
+        m_impl->done();
 }
 
 
-DataReaderTyped::DataReaderTyped(std::string const& data, Type* type)
+DataReaderTyped::DataReaderTyped(std::string_view data, Type* type)
     : m_reader(data)
 {
     m_type.push_back(type);
@@ -454,6 +568,13 @@ void    DataReaderTyped::string(    std::string&        data)
     m_reader.string(data);
 }
 
+void    DataReaderTyped::string(    std::string_view&   data)
+{
+    pop_type<TypeString>();
+
+    m_reader.string(data);
+}
+
 void    DataReaderTyped::size(      unsigned&           size)
 {
     auto*   type    = pop_type<TypeArray>();
@@ -474,44 +595,39 @@ void    DataReaderTyped::done()
     m_reader.done();
 }
 
-DataReaderPlain::DataReaderPlain(std::string const& data)
-    : m_is(data)
+DataReaderPlain::DataReaderPlain(std::string_view data)
+    : m_data(data)
 {
 }
 
 void    DataReaderPlain::integer(   int64_t&            data)
 {
-    int64_t buff;
-    m_is.read(reinterpret_cast<char*>(&buff), sizeof(buff));
-    data    = ntohll(buff);
+    decode(m_data, data);
 }
 
 void    DataReaderPlain::number(    double&             data)
 {
-    auto    buff    = htonll(*reinterpret_cast<uint64_t*>(&data));
-    m_is.read(reinterpret_cast<char*>(&buff), sizeof(buff));
-    *reinterpret_cast<uint64_t*>(&data) = ntohll(buff);
+    decode(m_data, data);
 }
 
 void    DataReaderPlain::boolean(   bool&               data)
 {
-    m_is.read(reinterpret_cast<char*>(&data), sizeof(data));
+    decode(m_data, data);
 }
 
 void    DataReaderPlain::string(    std::string&        data)
 {
-    uint32_t    size;
-    m_is.read(reinterpret_cast<char*>(&size), sizeof(size));
-    size    = ntohl(size);
-    data.resize(size);
-    m_is.read(reinterpret_cast<char*>(data.data()), data.size());
+    decode(m_data, data);
+}
+
+void    DataReaderPlain::string(    std::string_view&   data)
+{
+    decode(m_data, data);
 }
 
 void    DataReaderPlain::size(      unsigned&           size)
 {
-    unsigned    buff;
-    m_is.read(reinterpret_cast<char*>(&buff), sizeof(buff));
-    size    = ntohl(buff);
+    decode(m_data, size);
 }
 
 void    DataReaderPlain::done()
@@ -830,7 +946,7 @@ void printHelper(Type* const type, std::string prefix = "")
     }
 }
 
-std::ostream&   printHex(std::string const& data)
+std::ostream&   printHex(std::string_view data)
 {
     std::cout << std::endl;
     char    text[17]    = "                ";
@@ -1106,16 +1222,346 @@ void readCsv(Type* type, std::string name, std::string data)
 
 }
 
-void    Writer::open(std::string filename)
+#define     INFO(type, ID)  (((type) << 16) | (ID))
+
+//  big-endian fields of records, block headers and the index
+static void put32(std::string& data, uint32_t value)
+{
+    value   = htonl(value);
+    data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+static void put64(std::string& data, uint64_t value)
+{
+    value   = htonll(value);
+    data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+//  v3 columns. The type of a prop is flattened into ops, one per leaf in
+//  member order: 'i'nteger, 'n'umber, 'b'oolean, 's'tring, and '[' ... ']'
+//  around the element of an array. Every op but ']' owns a column; that of
+//  '[' holds the sizes, the elements of all the arrays share the columns of
+//  their ops. Integers are stored as the zigzag varint of their difference
+//  to the previous one in the column, times as that of their delta of delta
+class Shape
+{
+public:
+    Shape() = default;
+    Shape(std::string ops);
+
+    std::string         ops;
+    std::vector<size_t> column;         //  per op
+    std::vector<size_t> close;          //  per '[', its ']'
+    size_t              columns = 0;
+};
+
+Shape::Shape(std::string ops)
+    : ops(ops)
+    , column(ops.size())
+    , close(ops.size())
+{
+    std::vector<size_t> open;
+
+    for(size_t op = 0; op < ops.size(); op++)
+    {
+        switch(ops[op])
+        {
+            case 'i':
+            case 'n':
+            case 'b':
+            case 's':
+                column[op]  = columns++;
+                break;
+            case '[':
+                column[op]  = columns++;
+                open.push_back(op);
+                break;
+            case ']':
+                if(open.empty())
+                    throw std::runtime_error("invalid segment shape");
+
+                close[open.back()]  = op;
+                open.pop_back();
+                break;
+            default:
+                throw std::runtime_error("invalid segment shape");
+        }
+    }
+
+    if(!open.empty())
+        throw std::runtime_error("invalid segment shape");
+}
+
+static void flatten(Type* type, std::string& ops)
+{
+    if(nullptr != dynamic_cast<TypeInteger*>(type))
+        ops    += 'i';
+    else if(nullptr != dynamic_cast<TypeNumber*>(type))
+        ops    += 'n';
+    else if(nullptr != dynamic_cast<TypeBoolean*>(type))
+        ops    += 'b';
+    else if(nullptr != dynamic_cast<TypeString*>(type))
+        ops    += 's';
+    else if(auto array = dynamic_cast<TypeArray*>(type))
+    {
+        ops    += '[';
+        flatten(array->base, ops);
+        ops    += ']';
+    }
+    else if(auto record = dynamic_cast<TypeRecord*>(type))
+    {
+        for(auto& item: record->body())
+        {
+            flatten(item.type, ops);
+        }
+    }
+    else
+        throw std::runtime_error("unknown type");
+}
+
+static void putVarint(std::string& data, uint64_t value)
+{
+    while(value >= 0x80)
+    {
+        data   += char(value | 0x80);
+        value >>= 7;
+    }
+    data   += char(value);
+}
+
+static uint64_t getVarint(std::string_view& data)
+{
+    uint64_t    value   = 0;
+
+    for(unsigned shift = 0; shift < 64; shift += 7)
+    {
+        auto    byte    = uint8_t(*take(data, 1));
+
+        value  |= uint64_t(byte & 0x7f) << shift;
+        if((byte & 0x80) == 0)
+            return  value;
+    }
+
+    throw std::runtime_error("invalid varint");
+}
+
+//  differences wrap around rather than overflow
+static uint64_t zigzag(int64_t lhs, int64_t rhs)
+{
+    auto    value   = int64_t(uint64_t(lhs) - uint64_t(rhs));
+
+    return  (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+static int64_t  unzigzag(int64_t base, uint64_t value)
+{
+    auto    delta   = int64_t(value >> 1) ^ -int64_t(value & 1);
+
+    return  int64_t(uint64_t(base) + uint64_t(delta));
+}
+
+//  the samples of one prop since its last SEGMENT
+class Segment
+{
+public:
+    Segment(Type* type);
+
+    void        push(uint64_t time, std::string_view data);
+    std::string build(uint64_t horizon);
+    uint64_t    tmin() const {return m_tmin;}
+
+    uint32_t                    count   = 0;
+    size_t                      size    = 0;    //  of times and cols
+
+private:
+    void        split(size_t begin, size_t end, std::string_view& data);
+
+private:
+    Shape                       m_shape;
+    std::string                 m_times;
+    std::vector<std::string>    m_cols;
+    std::vector<int64_t>        m_last;         //  integer columns only
+    int64_t                     m_time  = 0;
+    int64_t                     m_delta = 0;
+    uint64_t                    m_tmin  = UINT64_MAX;
+    uint64_t                    m_tmax  = 0;
+};
+
+class Writer::Columns
+{
+public:
+    std::vector<Segment>        props;          //  prop 1 first
+    uint64_t                    time    = 0;    //  of the last sample pushed
+};
+
+Segment::Segment(Type* type)
+{
+    std::string ops;
+    flatten(type, ops);
+
+    m_shape = Shape(ops);
+    m_cols.resize(m_shape.columns);
+    m_last.resize(m_shape.columns);
+}
+
+void    Segment::push(uint64_t time, std::string_view data)
+{
+    auto    delta   = int64_t(time - uint64_t(m_time));
+
+    putVarint(m_times, zigzag(delta, m_delta));
+    m_time  = time;
+    m_delta = delta;
+
+    split(0, m_shape.ops.size(), data);
+    if(!data.empty())
+        throw std::runtime_error("data does not match its type");
+
+    m_tmin  = std::min(m_tmin, time);
+    m_tmax  = std::max(m_tmax, time);
+    count++;
+
+    size    = m_times.size();
+    for(auto& col: m_cols)
+    {
+        size   += col.size();
+    }
+}
+
+void    Segment::split(size_t begin, size_t end, std::string_view& data)
+{
+    for(auto op = begin; op < end; op++)
+    {
+        auto    column  = m_shape.column[op];
+
+        switch(m_shape.ops[op])
+        {
+            case 'i':
+            {
+                auto    value   = int64_t(get64(data));
+
+                putVarint(m_cols[column], zigzag(value, m_last[column]));
+                m_last[column]  = value;
+                break;
+            }
+            case 'n':
+                m_cols[column].append(take(data, sizeof(uint64_t)), sizeof(uint64_t));
+                break;
+            case 'b':
+                m_cols[column].append(take(data, sizeof(bool)), sizeof(bool));
+                break;
+            case 's':
+            {
+                auto    size    = get32(data);
+
+                putVarint(m_cols[column], size);
+                m_cols[column].append(take(data, size), size);
+                break;
+            }
+            case '[':
+            {
+                auto    size    = get32(data);
+
+                putVarint(m_cols[column], size);
+                for(uint32_t i = 0; i < size; i++)
+                {
+                    split(op + 1, m_shape.close[op], data);
+                }
+                op  = m_shape.close[op];
+                break;
+            }
+        }
+    }
+}
+
+//  SEGMENT: sample count, tmin, tmax, horizon, the ops, column count, the size
+//  of each column, then the times followed by the columns of the ops.  Samples
+//  of any prop in later segments are timed from horizon on
+std::string Segment::build(uint64_t horizon)
+{
+    std::string data;
+
+    put32(data, count);
+    put64(data, m_tmin);
+    put64(data, m_tmax);
+    put64(data, horizon);
+    put32(data, m_shape.ops.size());
+    data   += m_shape.ops;
+
+    put32(data, m_cols.size() + 1);
+    put32(data, m_times.size());
+    for(auto& col: m_cols)
+    {
+        put32(data, col.size());
+    }
+
+    data   += m_times;
+    for(auto& col: m_cols)
+    {
+        data   += col;
+    }
+
+    m_times.clear();
+    for(auto& col: m_cols)
+    {
+        col.clear();
+    }
+    std::fill(m_last.begin(), m_last.end(), 0);
+
+    m_time  = 0;
+    m_delta = 0;
+    m_tmin  = UINT64_MAX;
+    m_tmax  = 0;
+    count   = 0;
+    size    = 0;
+
+    return  data;
+}
+
+Writer::Writer()    = default;
+Writer::~Writer()   = default;
+
+void    Writer::open(std::string filename, Format format, size_t block)
 {
     m_os.open(filename, std::ios_base::binary | std::ios_base::in | std::ios_base::trunc);
 
+    m_format    = format;
+    m_size      = block;
+    m_blocks    = 0;
+    m_meta.clear();
+    m_index.clear();
+    m_columns   = format == COLUMNS ? std::make_unique<Columns>() : nullptr;
+
     record(0x00010000, "referee");
-    record(0x00010001, "v1.0.0");
+    record(0x00010001, format == COLUMNS ? "v3.0.0" : format == BLOCKS ? "v2.0.0" : "v1.0.0");
 }
 
 void    Writer::close()
 {
+    if(m_columns)
+    {
+        for(size_t prop = 1; prop <= m_columns->props.size(); prop++)
+        {
+            flush(prop);
+        }
+    }
+
+    if(m_format == BLOCKS)
+    {
+        flush();
+
+        std::string index;
+        put32(index, m_meta.size());
+        index  += m_meta;
+        put32(index, m_blocks);
+        index  += m_index;
+
+        std::string tail;
+        put64(tail, m_os.tellp());
+
+        record(INFO(INDEX, 0), index);
+        record(INFO(TAIL, 0), tail);
+    }
+
     m_os.flush();
     m_os.close();
 }
@@ -1124,34 +1570,103 @@ void    Writer::close()
 void    Writer::record( uint32_t            info,
                         std::string const&  data)
 {
-    uint32_t    buff32;
+    std::string buff;
 
-    buff32  = htonl(info);
-    m_os.write(reinterpret_cast<char const*>(&buff32), sizeof(buff32));
+    put32(buff, info);
+    put32(buff, data.size());
+    buff   += data;
 
-    buff32  = htonl(data.size());
-    m_os.write(reinterpret_cast<char const*>(&buff32), sizeof(buff32));
-
-    m_os.write(reinterpret_cast<char const*>(data.data()), data.size());
+    emit(info >> 16, info & 0xff, 0, buff);
 }
 
 void    Writer::record( uint32_t            info,
                         uint64_t            time,
                         std::string const&  data)
 {
-    uint32_t    buff32;
-    uint64_t    buff64;
+    std::string buff;
 
-    buff32  = htonl(info);
-    m_os.write(reinterpret_cast<char const*>(&buff32), sizeof(buff32));
+    put32(buff, info);
+    put32(buff, data.size() + sizeof(time));
+    put64(buff, time);
+    buff   += data;
 
-    buff32  = htonl(data.size() + sizeof(time));
-    m_os.write(reinterpret_cast<char const*>(&buff32), sizeof(buff32));
+    emit(info >> 16, info & 0xff, time, buff);
+}
+
+//  v1 and the v2 framing go straight to the file, other v2 records into the
+//  open block, which is written out before it would outgrow m_size
+void    Writer::emit(   uint16_t            type,
+                        uint8_t             indx,
+                        uint64_t            time,
+                        std::string const&  data)
+{
+    if(m_format != BLOCKS || type == ROOT || type == INDEX || type == TAIL)
+    {
+        m_os.write(data.data(), data.size());
+        return;
+    }
 
-    buff64  = htonll(time);
-    m_os.write(reinterpret_cast<char const*>(&buff64), sizeof(buff64));
+    if(!m_block.empty() && m_block.size() + data.size() > m_size)
+        flush();
 
-    m_os.write(reinterpret_cast<char const*>(data.data()), data.size());
+    if(type == PUSH_PROP)
+    {
+        if(m_offsets.size() <= indx)
+            m_offsets.resize(indx + 1, UINT32_MAX);
+        if(m_offsets[indx] == UINT32_MAX)
+            m_offsets[indx] = m_block.size();
+
+        m_tmin  = std::min(m_tmin, time);
+        m_tmax  = std::max(m_tmax, time);
+    }
+    else
+    {
+        m_meta += data;
+    }
+
+    m_block    += data;
+    m_count++;
+}
+
+//  BLOCK: record count, tmin, tmax, prop count, offset of the first record of
+//  each prop in the records, then the records
+void    Writer::flush()
+{
+    if(m_block.empty())
+        return;
+
+    std::string head;
+
+    put32(head, m_count);
+    put64(head, m_tmin);
+    put64(head, m_tmax);
+    put32(head, m_offsets.size());
+    for(auto offset: m_offsets)
+    {
+        put32(head, offset);
+    }
+
+    std::string frame;
+
+    put32(frame, INFO(BLOCK, 0));
+    put32(frame, head.size() + m_block.size());
+
+    put64(m_index, m_os.tellp());
+    put32(m_index, frame.size() + head.size() + m_block.size());
+    put32(m_index, m_count);
+    put64(m_index, m_tmin);
+    put64(m_index, m_tmax);
+    m_blocks++;
+
+    m_os.write(frame.data(), frame.size());
+    m_os.write(head.data(), head.size());
+    m_os.write(m_block.data(), m_block.size());
+
+    m_block.clear();
+    m_offsets.clear();
+    m_count = 0;
+    m_tmin  = UINT64_MAX;
+    m_tmax  = 0;
 }
 
 void    encode(std::ostream& os, Type* const type, std::string prefix = "")
@@ -1201,13 +1716,6 @@ std::string Writer::encode( Type*   type)
 
     return os.str();
 }
-#define     INFO(type, ID)  (((type) << 16) | (ID))
-#define     ROOT        0x0001
-#define     DECL_TYPE   0x0002
-#define     DECL_PROP   0x0003
-#define     DECL_CONF   0x0004
-#define     PUSH_PROP   0x0005
-#define     PUSH_CONF   0x0006
 
 uint8_t Writer::declType(   Type*               type)
 {
@@ -1243,6 +1751,14 @@ uint8_t Writer::declProp(   uint8_t             type,
 
     record(INFO(DECL_PROP, type), name);
 
+    if(m_columns)
+    {
+        if(type == 0 || type > m_types.size())
+            throw std::runtime_error("undeclared type");
+
+        m_columns->props.emplace_back(m_types[type - 1]);
+    }
+
     return m_props.size();
 }
 
@@ -1250,12 +1766,650 @@ void    Writer::pushData(   uint8_t             prop,
                             uint64_t            time,
                             std::string const&  data)
 {
+    if(m_columns)
+    {
+        if(prop == 0 || prop > m_columns->props.size())
+            throw std::runtime_error("undeclared prop");
+
+        auto&   segment = m_columns->props[prop - 1];
+
+        segment.push(time, data);
+        m_columns->time = time;
+
+        if(segment.size >= m_size)
+        {
+            //  props holding samples older than the whole segment go along, so
+            //  the horizon keeps up and a reader holds about a segment per prop
+            auto    tmin    = segment.tmin();
+
+            flush(prop);
+            for(size_t other = 1; other <= m_columns->props.size(); other++)
+            {
+                if(m_columns->props[other - 1].count != 0 && m_columns->props[other - 1].tmin() < tmin)
+                    flush(other);
+            }
+        }
+
+        return;
+    }
+
     record(INFO(PUSH_PROP, prop), time, data);
 }
 
+void    Writer::flush(      uint8_t             prop)
+{
+    auto&   segment = m_columns->props[prop - 1];
+    auto    horizon = m_columns->time;
+
+    if(segment.count == 0)
+        return;
+
+    //  samples are pushed in time order, the oldest one still held bounds those to come
+    for(auto& other: m_columns->props)
+    {
+        if(&other != &segment && other.count != 0)
+            horizon = std::min(horizon, other.tmin());
+    }
+
+    record(INFO(SEGMENT, prop), segment.build(horizon));
+}
+
+//  one record off the front of data, as laid out by Writer::record,
+//  false if not even its info and size are left
+static bool parse(std::string_view& data, RecordView& record)
+{
+    if(data.size() < sizeof(uint32_t) * 2)
+        return  false;
+
+    auto    info    = get32(data);
+    auto    size    = get32(data);
+
+    record.type = info >> 16;
+    record.indx = info & 0xff;
+    record.time = 0;
+
+    if(record.type == PUSH_PROP)
+    {
+        if(size < sizeof(uint64_t) || data.size() < sizeof(uint64_t))
+            throw std::runtime_error("truncated record");
+
+        record.time = get64(data);
+        size       -= sizeof(uint64_t);
+    }
+
+    if(data.size() < size)
+        throw std::runtime_error("truncated record");
+
+    record.data = data.substr(0, size);
+    data.remove_prefix(size);
+
+    return  true;
+}
+
+//  the records of a BLOCK, past its header
+static std::string_view records(std::string_view block)
+{
+    get32(block);       //  count
+    get64(block);       //  tmin
+    get64(block);       //  tmax
+
+    auto    props   = get32(block);
+    take(block, size_t(props) * sizeof(uint32_t));
+
+    return  block;
+}
+
+//  walks the SEGMENT records of one prop, a sample at a time
+class Cursor
+{
+public:
+    void        add(std::string_view segment, bool copy);
+    bool        step();
+    void        rebuild();
+
+    uint64_t                        time    = 0;
+    std::string                     data;       //  the payload last rebuilt
+    bool                            queued  = false;
+
+private:
+    void        join(size_t begin, size_t end);
+
+private:
+    std::deque<std::pair<std::string_view, bool>>
+                                    m_segments; //  not opened yet, and whether owned
+    std::deque<std::string>         m_owned;    //  segments read off streams, the open one first
+    bool                            m_owns  = false;
+    Shape                           m_shape;
+    std::string_view                m_times;
+    std::vector<std::string_view>   m_cols;
+    std::vector<int64_t>            m_last;
+    uint32_t                        m_left  = 0;
+    int64_t                         m_delta = 0;
+};
+
+class Reader::Columns
+{
+public:
+    void    add(uint8_t prop, std::string_view segment, bool copy);
+    bool    next(RecordView& record);
+
+    uint64_t                        horizon = 0;    //  UINT64_MAX once the file is read through
+
+private:
+    using   Head    = std::tuple<uint64_t, uint8_t, Cursor*>;   //  the next sample of a prop
+
+    std::map<uint8_t, Cursor>       m_cursors;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>>
+                                    m_heads;
+};
+
+//  a segment to open once those before it are done, copied if read off a stream
+void    Cursor::add(std::string_view segment, bool copy)
+{
+    if(copy)
+        segment = m_owned.emplace_back(segment);
+
+    m_segments.emplace_back(segment, copy);
+}
+
+//  moves to the time of the next sample, opening the next segment when the
+//  current one is done, which drops a copied one
+bool    Cursor::step()
+{
+    while(m_left == 0)
+    {
+        if(m_segments.empty())
+            return  false;
+
+        if(m_owns)
+            m_owned.pop_front();
+
+        auto    data    = m_segments.front().first;
+        m_owns  = m_segments.front().second;
+        m_segments.pop_front();
+
+        m_left  = get32(data);
+        get64(data);        //  tmin
+        get64(data);        //  tmax
+        get64(data);        //  horizon
+
+        auto    size    = get32(data);
+        auto    ops     = std::string_view(take(data, size), size);
+        if(ops != m_shape.ops)
+            m_shape = Shape(std::string(ops));
+
+        if(get32(data) != m_shape.columns + 1)
+            throw std::runtime_error("invalid segment");
+
+        std::vector<uint32_t>   sizes(m_shape.columns + 1);
+        for(auto& size: sizes)
+        {
+            size    = get32(data);
+        }
+
+        m_times = std::string_view(take(data, sizes[0]), sizes[0]);
+        m_cols.resize(m_shape.columns);
+        for(size_t i = 0; i < m_cols.size(); i++)
+        {
+            m_cols[i]   = std::string_view(take(data, sizes[i + 1]), sizes[i + 1]);
+        }
+
+        m_last.assign(m_shape.columns, 0);
+        m_delta = 0;
+        time    = 0;
+    }
+
+    m_delta = unzigzag(m_delta, getVarint(m_times));
+    time   += m_delta;
+    m_left--;
+
+    return  true;
+}
+
+//  the plain payload of the current sample, as DataWriter would have built it
+void    Cursor::rebuild()
+{
+    data.clear();
+    join(0, m_shape.ops.size());
+}
+
+void    Cursor::join(size_t begin, size_t end)
+{
+    for(auto op = begin; op < end; op++)
+    {
+        auto&   col     = m_cols[m_shape.column[op]];
+
+        switch(m_shape.ops[op])
+        {
+            case 'i':
+            {
+                auto&   last    = m_last[m_shape.column[op]];
+
+                last    = unzigzag(last, getVarint(col));
+                put64(data, last);
+                break;
+            }
+            case 'n':
+                data.append(take(col, sizeof(uint64_t)), sizeof(uint64_t));
+                break;
+            case 'b':
+                data.append(take(col, sizeof(bool)), sizeof(bool));
+                break;
+            case 's':
+            {
+                auto    size    = getVarint(col);
+
+                put32(data, size);
+                data.append(take(col, size), size);
+                break;
+            }
+            case '[':
+            {
+                auto    size    = getVarint(col);
+
+                put32(data, size);
+                for(uint64_t i = 0; i < size; i++)
+                {
+                    join(op + 1, m_shape.close[op]);
+                }
+                op  = m_shape.close[op];
+                break;
+            }
+        }
+    }
+}
+
+void    Reader::Columns::add(uint8_t prop, std::string_view segment, bool copy)
+{
+    auto&   cursor  = m_cursors[prop];
+
+    cursor.add(segment, copy);
+    if(!cursor.queued && cursor.step())
+    {
+        cursor.queued   = true;
+        m_heads.emplace(cursor.time, prop, &cursor);
+    }
+}
+
+//  the earliest sample over all the props, the lower prop first on a tie,
+//  once no segment still to come can hold an earlier one
+bool    Reader::Columns::next(RecordView& record)
+{
+    if(m_heads.empty())
+        return  false;
+
+    auto    [time, prop, cursor]    = m_heads.top();
+
+    if(time >= horizon && horizon != UINT64_MAX)
+        return  false;
+
+    m_heads.pop();
+    cursor->rebuild();
+
+    record.type = PUSH_PROP;
+    record.indx = prop;
+    record.time = time;
+    record.data = cursor->data;
+
+    if(cursor->step())
+        m_heads.emplace(cursor->time, prop, cursor);
+    else
+        cursor->queued  = false;
+
+    return  true;
+}
+
+Reader::Reader()
+    : m_selected(1, false)
+{
+}
+
+Reader::~Reader()
+{
+    close();
+}
+
+void    Reader::open(std::string filename, unsigned advice)
+{
+    close();
+
+    auto    fd  = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::runtime_error("cannot open " + filename);
+    }
+
+    struct stat st;
+    if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        auto    base    = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(base != MAP_FAILED)
+        {
+            m_base  = static_cast<char const*>(base);
+            m_size  = st.st_size;
+            m_curr  = 0;
+
+            //  hints only, the kernel is free to refuse them
+            if(advice & SEQUENTIAL)
+                ::madvise(base, m_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            if(advice & HUGEPAGE)
+                ::madvise(base, m_size, MADV_HUGEPAGE);
+#endif
+        }
+    }
+
+    ::close(fd);
+
+    if(m_base != nullptr)
+    {
+        index();
+        return;
+    }
+
+    m_is.open(filename, std::ios_base::binary | std::ios_base::in);
+
+    if(!m_is.is_open())
+    {
+        throw std::runtime_error("cannot open " + filename);
+    }
+}
+
+void    Reader::close()
+{
+    if(m_base != nullptr)
+    {
+        ::munmap(const_cast<char*>(m_base), m_size);
+
+        m_base  = nullptr;
+        m_size  = 0;
+        m_curr  = 0;
+    }
+
+    if(m_is.is_open())
+        m_is.close();
+
+    m_inner     = {};
+    m_replay    = {};
+    m_indexed   = false;
+    m_meta      = {};
+    m_ranged    = false;
+    m_next      = 0;
+    m_blocks.clear();
+    m_reach.clear();
+    m_floor.clear();
+    m_selected.assign(1, false);
+    m_columns.reset();
+}
+
+//  a v2 file starts with the ROOT records "referee" and "v2.0.0" and ends
+//  with a TAIL record holding the offset of its INDEX.  A writer that crashed
+//  or is still running has left neither, the blocks are then read in order
+//  and seek() is refused
+void    Reader::index()
+{
+    auto    head    = std::string_view(m_base, m_size);
+    auto    root    = RecordView();
+
+    if(!parse(head, root) || root.type != ROOT || !parse(head, root) || root.type != ROOT || root.data != "v2.0.0")
+        return;
+
+    auto    tail    = sizeof(uint32_t) * 2 + sizeof(uint64_t);
+    auto    data    = std::string_view(m_base, m_size);
+
+    //  whether data starts with a whole record of type, parse() throws on a cut one
+    auto    whole   = [](std::string_view data, uint16_t type)
+    {
+        if(data.size() < sizeof(uint32_t) * 2)
+            return  false;
+
+        auto    info    = get32(data);
+        auto    size    = get32(data);
+
+        return  info >> 16 == type && size <= data.size();
+    };
+
+    if(m_size < tail)
+        return;
+
+    data.remove_prefix(m_size - tail);
+    if(!whole(data, TAIL) || !parse(data, root) || root.data.size() != sizeof(uint64_t))
+        return;
+
+    auto    offset  = get64(root.data);
+    if(offset > m_size - tail)
+        return;
+
+    data    = std::string_view(m_base + offset, m_size - tail - offset);
+    if(!whole(data, INDEX) || !parse(data, root))
+        return;
+
+    auto    meta    = get32(root.data);
+    m_meta  = std::string_view(take(root.data, meta), meta);
+
+    m_blocks.resize(get32(root.data));
+    for(auto& block: m_blocks)
+    {
+        block.offset    = get64(root.data);
+        block.size      = get32(root.data);
+        block.count     = get32(root.data);
+        block.tmin      = get64(root.data);
+        block.tmax      = get64(root.data);
+    }
+
+    m_reach.resize(m_blocks.size());
+    m_floor.resize(m_blocks.size());
+    for(size_t i = 0; i < m_blocks.size(); i++)
+    {
+        m_reach[i]  = std::max(m_blocks[i].tmax, i ? m_reach[i - 1] : 0);
+    }
+    for(size_t i = m_blocks.size(); i-- > 0; )
+    {
+        m_floor[i]  = std::min(m_blocks[i].tmin, i + 1 < m_blocks.size() ? m_floor[i + 1] : UINT64_MAX);
+    }
+
+    m_indexed   = true;
+}
+
+bool    Reader::seek(uint64_t from, uint64_t to)
+{
+    if(!m_indexed)
+        return  false;
+
+    //  the first block holding a record timed from on
+    m_next      = std::lower_bound(m_reach.begin(), m_reach.end(), from) - m_reach.begin();
+    m_curr      = m_next < m_blocks.size() ? m_blocks[m_next].offset : m_size;
+    m_inner     = {};
+    m_replay    = m_meta;
+    m_selected.assign(1, false);
+    m_ranged    = true;
+    m_from      = from;
+    m_to        = to;
+
+    return  true;
+}
+
+void    Reader::select(std::vector<std::string> names)
+{
+    m_select    = names;
+}
+
+//  counts the declared props and drops the samples of those not selected
+bool    Reader::admit(RecordView const& record)
+{
+    if(record.type == DECL_PROP)
+        m_selected.push_back(m_select.empty() || std::find(m_select.begin(), m_select.end(), record.data) != m_select.end());
+
+    return  record.type != PUSH_PROP || selected(record.indx);
+}
+
+//  undeclared props are let through for the caller to report
+bool    Reader::selected(uint8_t prop) const
+{
+    return  m_select.empty() || prop >= m_selected.size() || m_selected[prop];
+}
+
+bool    Reader::read(char* data, size_t size)
+{
+    return  bool(m_is.read(data, size));
+}
+
+char const* Reader::buffer(size_t size)
+{
+    m_buff.resize(size);
+    if(!m_is.read(m_buff.data(), size))
+        return  nullptr;
+
+    return  m_buff.data();
+}
+
+//  the next record of the file itself, BLOCK ones included
+bool    Reader::frame(RecordView& record)
+{
+    if(m_base != nullptr)
+    {
+        auto    rest    = std::string_view(m_base + m_curr, m_size - m_curr);
+        auto    found   = parse(rest, record);
+
+        m_curr  = m_size - rest.size();
+
+        return  found;
+    }
+
+    uint32_t    info;
+    uint32_t    size;
+    uint64_t    time;
+
+    if(!read(reinterpret_cast<char*>(&info), sizeof(info)))
+        return  false;
+    if(!read(reinterpret_cast<char*>(&size), sizeof(size)))
+        return  false;
+
+    info    = ntohl(info);
+    size    = ntohl(size);
+
+    record.type = info >> 16;
+    record.indx = info & 0xff;
+    record.time = 0;
+
+    if(record.type == PUSH_PROP)
+    {
+        if(size < sizeof(time))
+            throw std::runtime_error("truncated record");
+
+        if(!read(reinterpret_cast<char*>(&time), sizeof(time)))
+            throw std::runtime_error("truncated record");
+
+        record.time = ntohll(time);
+        size       -= sizeof(time);
+    }
+
+    auto    data    = buffer(size);
+    if(data == nullptr)
+        throw std::runtime_error("truncated record");
+
+    record.data = std::string_view(data, size);
+
+    return  true;
+}
+
+bool    Reader::next(RecordView& record)
+{
+    for(;;)
+    {
+        if(!m_replay.empty())
+        {
+            parse(m_replay, record);
+            admit(record);
+            return  true;
+        }
+
+        if(!m_inner.empty())
+        {
+            if(!parse(m_inner, record))
+                throw std::runtime_error("truncated block");
+
+            //  after seek the meta records come from the index
+            if(m_ranged && (record.type != PUSH_PROP || record.time < m_from || record.time > m_to))
+                continue;
+
+            if(!admit(record))
+                continue;
+
+            return  true;
+        }
+
+        //  no block from here on reaches back into the range
+        if(m_ranged && m_next < m_floor.size() && m_floor[m_next] > m_to)
+            return  false;
+
+        //  v3 samples as soon as the segments read so far settle them
+        if(m_columns && m_columns->next(record))
+            return  true;
+
+        if(!frame(record))
+        {
+            if(!m_columns)
+                return  false;
+
+            m_columns->horizon  = UINT64_MAX;
+            return  m_columns->next(record);
+        }
+
+        switch(record.type)
+        {
+            case BLOCK:
+                m_inner = records(record.data);
+                m_next++;
+                break;
+            case INDEX:
+            case TAIL:
+                break;
+            case SEGMENT:
+            {
+                if(!m_columns)
+                    m_columns   = std::make_unique<Columns>();
+
+                //  count, tmin, tmax, then the horizon, skipped segments move it too
+                auto    head    = record.data;
+                get32(head);
+                get64(head);
+                get64(head);
+                m_columns->horizon  = std::max(m_columns->horizon, get64(head));
+
+                if(selected(record.indx))
+                    m_columns->add(record.indx, record.data, m_base == nullptr);
+                break;
+            }
+            default:
+                if(!admit(record))
+                    break;
+
+                return  true;
+        }
+    }
+}
+
+bool    Reader::next(Record& record)
+{
+    RecordView  view;
+
+    if(!next(view))
+        return  false;
+
+    record.type = view.type;
+    record.indx = view.indx;
+    record.time = view.time;
+    record.data.assign(view.data);
+
+    return  true;
+}
+
 void    readDB(std::string filename)
 {
-    std::ifstream   is(filename, std::ios_base::binary | std::ios_base::in);
+    Reader      reader;
+    RecordView  record;
 
     std::vector<std::string>    prop2name;
     std::vector<std::string>    conf2name;
@@ -1263,65 +2417,40 @@ void    readDB(std::string filename)
     conf2name.push_back("-");
     prop2name.push_back("-");
 
-    while(is.eof() == false)
+    reader.open(filename);
+
+    while(reader.next(record))
     {
-        uint16_t    type;
-        uint32_t    info;
-        uint32_t    size;
-        uint64_t    time;
-        uint8_t     indx;
-        std::string data;
-        is.read(reinterpret_cast<char*>(&info), sizeof(info));
-        is.read(reinterpret_cast<char*>(&size), sizeof(size));
-
-        info    = ntohl(info);
-        size    = ntohl(size);
-        type    = info >> 16;
-        indx    = info & 0xff;
-
-
-        switch(type)
+        auto&   data    = record.data;
+        auto    indx    = record.indx;
+
+        switch(record.type)
         {
             case ROOT:
-                data.resize(size);
-                is.read(reinterpret_cast<char*>(data.data()), size);
                 std::cout << data << std::endl;
                 break;
             case DECL_TYPE:
-                data.resize(size);
-                is.read(reinterpret_cast<char*>(data.data()), size);
                 std::cout << "decl type: "  << data << std::endl;
                 break;
             case DECL_PROP:
-                data.resize(size);
-                is.read(reinterpret_cast<char*>(data.data()), data.size());
                 std::cout << "decl prop: " << data << std::endl;
-                prop2name.push_back(data);
+                prop2name.emplace_back(data);
                 break;
             case DECL_CONF:
-                data.resize(size);
-                is.read(reinterpret_cast<char*>(data.data()), size);
                 std::cout << "decl conf: "  << data << std::endl;
-                conf2name.push_back(data);
+                conf2name.emplace_back(data);
                 break;
             case PUSH_PROP:
-                data.resize(size - sizeof(time));
-                is.read(reinterpret_cast<char*>(&time), sizeof(time));
-                time    = ntohll(time);
-                is.read(reinterpret_cast<char*>(data.data()), data.size());
-                std::cout << prop2name[indx] << " @ " << std::dec << std::setw(16) << std::setfill('0') << time << ":";
+                std::cout << prop2name[indx] << " @ " << std::dec << std::setw(16) << std::setfill('0') << record.time << ":";
                 printHex(data) << std::endl;
                 break;
             case PUSH_CONF:
-                data.resize(size);
-                is.read(reinterpret_cast<char*>(data.data()), data.size());
-                std::cout << prop2name[indx];
+                std::cout << conf2name[indx];
                 printHex(data) << std::endl;
                 break;
             default:
                 std::exit(1);
         }
-
     }
 }
 
@@ -24,7 +24,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <deque>
 #include <sstream>
@@ -227,11 +229,12 @@ private:
     std::unique_ptr<Impl>   m_impl;
 };
 
+//  decodes in place, data must outlive the reader
 class DataReader
 {
 public:
-    DataReader( std::string const&  data);
-    DataReader( std::string const&  data,
+    DataReader( std::string_view    data);
+    DataReader( std::string_view    data,
                 Type*               type);
     ~DataReader();
 
@@ -239,21 +242,39 @@ public:
     DataReader& number( double&     data);
     DataReader& boolean(bool&       data);
     DataReader& string( std::string&data);
+    DataReader& string( std::string_view&
+                                    data);  //  points into data
     DataReader& size(   unsigned&   size);
     void        done();
 
     class Impl;
 
 private:
-    std::unique_ptr<Impl>   m_impl;
+    std::string_view        m_data;
+    std::unique_ptr<Impl>   m_impl;     //  typed only, plain reads decode m_data
+};
+
+//  FLAT writes v1, one record after the other. BLOCKS writes v2: the records
+//  are grouped into blocks of about `block` bytes, each headed by its record
+//  count, time range and where each prop first appears in it, and close()
+//  appends an index of the blocks for Reader::seek. COLUMNS writes v3: the
+//  samples of each prop are kept apart in segments of about `block` bytes,
+//  with delta-of-delta timestamps and one column per leaf of its type.
+//  Samples are pushed in time order
+enum Format : unsigned
+{
+    FLAT        = 1,
+    BLOCKS      = 2,
+    COLUMNS     = 3,
 };
 
 class Writer
 {
 public:
-    Writer() = default;
+    Writer();
+    ~Writer();
 
-    void    open(std::string filename);
+    void    open(std::string filename, Format format = FLAT, size_t block = 64 << 10);
     void    close();
 
     uint8_t declType(  Type*               type);
@@ -276,6 +297,13 @@ private:
                         uint64_t            time,
                         std::string const&  data);
 
+    void    emit(       uint16_t            type,
+                        uint8_t             indx,
+                        uint64_t            time,
+                        std::string const&  data);
+    void    flush();
+    void    flush(      uint8_t             prop);
+
     std::string 
             encode(     Type*               type);
 private:
@@ -283,6 +311,157 @@ private:
     std::vector<Type*>  m_types;
     std::vector<std::pair<std::string, uint8_t>>    m_confs;
     std::vector<std::pair<std::string, uint8_t>>    m_props;
+
+    Format              m_format    = FLAT;
+    size_t              m_size      = 0;        //  of a block
+    std::string         m_block;                //  records of the open block
+    uint32_t            m_count     = 0;
+    uint64_t            m_tmin      = UINT64_MAX;
+    uint64_t            m_tmax      = 0;
+    std::vector<uint32_t>
+                        m_offsets;              //  per prop, UINT32_MAX if absent
+    std::string         m_meta;                 //  the DECL_* and PUSH_CONF records
+    std::string         m_index;                //  one entry per block
+    uint32_t            m_blocks    = 0;
+
+    class Columns;
+    std::unique_ptr<Columns>
+                        m_columns;              //  the open segment of each prop
+};
+
+enum RecordType : uint16_t
+{
+    ROOT        = 0x0001,
+    DECL_TYPE   = 0x0002,
+    DECL_PROP   = 0x0003,
+    DECL_CONF   = 0x0004,
+    PUSH_PROP   = 0x0005,
+    PUSH_CONF   = 0x0006,
+    BLOCK       = 0x0007,   //  v2, a block header and the records in it
+    INDEX       = 0x0008,   //  v2, the meta records and one entry per block
+    TAIL        = 0x0009,   //  v2, the file offset of INDEX, always last
+    SEGMENT     = 0x000A,   //  v3, the columns of a run of samples of one prop
+};
+
+class Record
+{
+public:
+    uint16_t    type    = 0;
+    uint8_t     indx    = 0;
+    uint64_t    time    = 0;    //  valid for PUSH_PROP only
+    std::string data;
+};
+
+//  data points into the mapped file, or into the reader for streams,
+//  and is valid until the next call to Reader::next
+class RecordView
+{
+public:
+    uint16_t    type    = 0;
+    uint8_t     indx    = 0;
+    uint64_t    time    = 0;    //  valid for PUSH_PROP only
+    std::string_view
+                data;
+};
+
+//  madvise hints for a mapped file, ignored for streams
+enum Advice : unsigned
+{
+    NORMAL      = 0x0000,
+    SEQUENTIAL  = 0x0001,
+    HUGEPAGE    = 0x0002,
+};
+
+//  an INDEX entry, offset and size are those of the BLOCK record
+class Block
+{
+public:
+    uint64_t    offset  = 0;
+    uint32_t    size    = 0;
+    uint32_t    count   = 0;
+    uint64_t    tmin    = 0;    //  of its PUSH_PROP records
+    uint64_t    tmax    = 0;
+};
+
+//  maps regular files and walks their records in place,
+//  falls back to reading pipes and other streams record by record.
+//  v2 blocks are opened transparently, the records come out in the order
+//  they were written. The PUSH_PROP records of v3 segments are rebuilt
+//  and merged in time order as the segments come in, each one as soon as
+//  no later segment can hold an earlier sample
+class Reader
+{
+public:
+    Reader();
+    ~Reader();
+
+    Reader(Reader const&)               = delete;
+    Reader& operator=(Reader const&)    = delete;
+
+    void    open(std::string filename, unsigned advice = SEQUENTIAL);
+    void    close();
+
+    bool    mapped() const {return m_base != nullptr;}
+    bool    indexed() const {return m_indexed;}
+
+    std::vector<Block> const&
+            blocks() const {return m_blocks;}
+
+    //  jumps to the first block that may hold a PUSH_PROP record timed in
+    //  [from, to], O(log blocks). next() then returns the DECL_* and
+    //  PUSH_CONF records of the file followed by the PUSH_PROP records in
+    //  the range. false, and no move, for v1 files, streams and v2 files
+    //  their writer did not close
+    bool    seek(uint64_t from, uint64_t to = UINT64_MAX);
+
+    //  only the PUSH_PROP records of the props declared under these names
+    //  are returned, all of them if empty. v3 segments of other props are
+    //  skipped undecoded
+    void    select(std::vector<std::string> names);
+
+    bool    next(Record&     record);
+    bool    next(RecordView& record);
+
+private:
+    bool    frame(RecordView& record);
+    void    index();
+    bool    admit(RecordView const& record);
+    bool    selected(uint8_t prop) const;
+
+    bool    read(char* data, size_t size);
+    char const*
+            buffer(size_t size);
+
+private:
+    std::ifstream       m_is;
+    char const*         m_base  = nullptr;
+    size_t              m_size  = 0;
+    size_t              m_curr  = 0;
+    std::string         m_buff;
+
+    std::string_view    m_inner;            //  rest of the current block
+    std::string_view    m_replay;           //  meta records still to return after seek
+
+    bool                m_indexed   = false;
+    std::string_view    m_meta;
+    std::vector<Block>  m_blocks;
+    std::vector<uint64_t>
+                        m_reach;            //  max tmax of the blocks up to each
+    std::vector<uint64_t>
+                        m_floor;            //  min tmin of the blocks from each on
+
+    bool                m_ranged    = false;
+    uint64_t            m_from      = 0;
+    uint64_t            m_to        = 0;
+    size_t              m_next      = 0;    //  index of the next block
+
+    std::vector<std::string>
+                        m_select;
+    std::vector<bool>   m_selected;         //  per prop declared so far
+
+    class Columns;
+    std::unique_ptr<Columns>
+                        m_columns;          //  v3 segments of the selected props
 };
 
 void    readData(Type* main, std::string const& data);
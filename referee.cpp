@@ -55,21 +55,109 @@
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/LegacyPassManager.h"
-#include "llvm/Transforms/InstCombine/InstCombine.h"
-#include "llvm/Transforms/Scalar.h"
-#include "llvm/Transforms/Scalar/GVN.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <typeinfo>
 
 #include "antlr2ast.hpp"
+#include "cache.hpp"
+#include "chunks.hpp"
 #include "strings.hpp"
+#include "jit.hpp"
+#include "pool.hpp"
+#include "report.hpp"
+#include "trace.hpp"
+#include "visitors/cheader.hpp"
 #include "visitors/compile.hpp"
+#include "visitors/printer.hpp"
 
-void    Referee::compile(std::istream& is, std::string name, std::ostream& os)
+//  the PassBuilder level of -O<level>
+static llvm::OptimizationLevel  level(unsigned level)
+{
+    if(level > 3)
+    {
+        throw std::runtime_error("opt level " + std::to_string(level) + " is not in 0..3");
+    }
+
+    auto    levels  = std::array{
+                        llvm::OptimizationLevel::O0,
+                        llvm::OptimizationLevel::O1,
+                        llvm::OptimizationLevel::O2,
+                        llvm::OptimizationLevel::O3};
+
+    return  levels[level];
+}
+
+//  runs the default module pipeline of the given -O level, module passes let
+//  the inliner, IPSCCP and the loop vectorizer see across the emitted functions;
+//  the target machine gives the vectorizers the vector width and costs of the cpu
+static void     optimize(llvm::Module* TheModule, unsigned optLevel, llvm::TargetMachine* TM)
+{
+    auto    O       = level(optLevel);
+
+    llvm::PipelineTuningOptions     PTO;
+    PTO.LoopVectorization   = optLevel >= 2;
+    PTO.SLPVectorization    = optLevel >= 2;
+
+    llvm::LoopAnalysisManager       LAM;
+    llvm::FunctionAnalysisManager   FAM;
+    llvm::CGSCCAnalysisManager      CGAM;
+    llvm::ModuleAnalysisManager     MAM;
+    llvm::PassBuilder               PB(TM, PTO);
+
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+    auto    MPM     = O == llvm::OptimizationLevel::O0
+                    ? PB.buildO0DefaultPipeline(O)
+                    : PB.buildPerModuleDefaultPipeline(O);
+
+    {
+        Report::Scope   scope("optimize");
+
+        MPM.run(*TheModule, MAM);
+    }
+
+    if(Report::enabled())
+    {
+        for(auto& func: TheModule->functions())
+        {
+            if(!func.isDeclaration())
+                Report::optimized(func.getName().str(), func.size(), func.getInstructionCount());
+        }
+    }
+}
+
+static Module*  parse(
+                    std::istream&       is,
+                    std::string         name)
 {
     antlr4::ANTLRInputStream    input(is);
     referee::refereeLexer       lexer(&input);
@@ -77,53 +165,232 @@ void    Referee::compile(std::istream& is, std::string name, std::ostream& os)
     referee::refereeParser      parser(&tokens);
     Antlr2AST                   antlr2ast(name);
 
-    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
-    auto    TheModule   = std::make_unique<llvm::Module>(name, *TheContext);
+    referee::refereeParser::ProgramContext* tree;
+    {
+        Report::Scope   scope("parse");
+
+        tree    = parser.program();
+    }
+
+    Report::Scope   scope("ast");
+
+    return  std::any_cast<Module*>(antlr2ast.visitProgram(tree));
+}
+
+//  the debug() the generated code may call, see jit.cpp
+static void     declare(
+                    llvm::LLVMContext*  TheContext,
+                    llvm::Module*       TheModule)
+{
     auto    TheBuilder  = std::make_unique<llvm::IRBuilder<>>(*TheContext);   
-    auto    TheFPM      = std::make_unique<llvm::legacy::FunctionPassManager>(TheModule.get());
 
     auto    funcType    = llvm::FunctionType::get(TheBuilder->getVoidTy(), {TheBuilder->getInt64Ty()}, false);
     auto    func        = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, "debug", *TheModule);
+}
+
+//  IR of the part-th of `parts` groups the exprs and specs of `module` are dealt
+//  round-robin into, Compile::make is not reentrant and runs on the caller
+static void     generate(
+                    Module*             module,
+                    llvm::LLVMContext*  TheContext,
+                    llvm::Module*       TheModule,
+                    Options const&      options,
+                    size_t              part    = 0,
+                    size_t              parts   = 1)
+{
+    declare(TheContext, TheModule);
+
+    Report::Scope   scope("generate");
+
+    Compile::make(TheContext, TheModule, module, options, part, parts);
+}
+
+//  IR of the exprs and specs of `module` compiled to the functions in `names`
+static void     generate(
+                    Module*             module,
+                    llvm::LLVMContext*  TheContext,
+                    llvm::Module*       TheModule,
+                    Options const&      options,
+                    std::set<std::string> const&    names)
+{
+    declare(TheContext, TheModule);
+
+    Report::Scope   scope("generate");
+
+    Compile::make(TheContext, TheModule, module, options, names);
+}
+
+static Module*  build(
+                    std::istream&       is,
+                    std::string         name,
+                    llvm::LLVMContext*  TheContext,
+                    llvm::Module*       TheModule,
+                    llvm::TargetMachine* TM,
+                    Options const&      options)
+{
+    auto*   module  = parse(is, name);
+
+    generate(module, TheContext, TheModule, options);
+
+    optimize(TheModule, options.optLevel, TM);
+
+    return  module;
+}
+
+static llvm::ExitOnError ExitOnErr;
 
+llvm::orc::ThreadSafeModule Referee::module(std::istream& is, std::string name, Options const& options)
+{
+    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
+    auto    TheModule   = std::make_unique<llvm::Module>(name, *TheContext);
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+
+    //  row strides get folded into the IR, emit it for the layout and cpu the JIT will use
+    auto    TM          = ExitOnErr(ExitOnErr(RefereeJIT::target(options.cpu, options.features)).createTargetMachine());
+
+    TheModule->setDataLayout(TM->createDataLayout());
+    TheModule->setTargetTriple(TM->getTargetTriple().str());
+
+    build(is, name, TheContext.get(), TheModule.get(), TM.get(), options);
+
+    return  llvm::orc::ThreadSafeModule(std::move(TheModule), std::move(TheContext));
+}
+
+void    Referee::compile(std::istream& is, std::string name, std::ostream& os, Options const& options)
+{
+    try {
+        auto    TSM = module(is, name, options);
+        auto    xyz = llvm::raw_os_ostream(os);
+
+        TSM.withModuleDo([&](llvm::Module& M) {
+            M.print(xyz, nullptr);
+        });
+    }
+    catch(Exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+    }    
+}
+
+bool    Referee::emit(
+                std::istream&       is,
+                std::string         name,
+                std::string         path,
+                Emit                kind,
+                Options const&      options)
+{
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
 
+    //  position independent, so the object links into a shared library as well
+    auto    JTMB        = ExitOnErr(RefereeJIT::target(options.cpu, options.features));
+    JTMB.setRelocationModel(llvm::Reloc::PIC_);
+
+    auto    TM          = ExitOnErr(JTMB.createTargetMachine());
+    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
+    auto    TheModule   = std::make_unique<llvm::Module>(name, *TheContext);
+
+    TheModule->setDataLayout(TM->createDataLayout());
+    TheModule->setTargetTriple(TM->getTargetTriple().str());
+
     try {
-        auto*   tree    = parser.program();
-        auto*   module  = std::any_cast<Module*>(antlr2ast.visitProgram(tree));
+        //  the step functions call the referee_window_* runtime, which only the JIT binds
+        if(options.monitor && (kind == Emit::obj || kind == Emit::so))
+            throw std::runtime_error("--monitor can't be emitted as obj or so, the window runtime lives in referee");
+
+        auto    module  = build(is, name, TheContext.get(), TheModule.get(), TM.get(), options);
 
-        Compile::make(TheContext.get(), TheModule.get(), module);
+        //  function names carry the spec positions, C callers get an alias
+        //  "<stem>_spec_<row>_<col>_<row>_<col>" of each
+        auto    output  = std::filesystem::path(path);
+        auto    stem    = output.stem().string();
+        auto    symbol  = [](std::string text)
+        {
+            std::string result;
+            for(auto c: text)
+            {
+                if(std::isalnum((unsigned char)c))
+                    result  += c;
+                else if(!result.ends_with("_"))
+                    result  += '_';
+            }
+            return  result;
+        };
+
+        std::vector<std::pair<std::string, std::string>>    functions;
+        auto    exports = [&](std::string kind, Position const& pos)
+        {
+            auto    funcName    = Compile::name(pos);
+            auto    func        = TheModule->getFunction(funcName);
 
-        TheFPM->add(llvm::createInstructionCombiningPass());
-        TheFPM->add(llvm::createReassociatePass());
-        TheFPM->add(llvm::createGVNPass());
-        TheFPM->add(llvm::createCFGSimplificationPass());
-        TheFPM->add(llvm::createLoopStrengthReducePass());
-        TheFPM->add(llvm::createLoopLoadEliminationPass());
-        TheFPM->add(llvm::createLoopDataPrefetchPass());
-        TheFPM->add(llvm::createLoopSimplifyCFGPass());
-        TheFPM->add(llvm::createLoopGuardWideningPass());
-        TheFPM->add(llvm::createLoopDistributePass());
-        TheFPM->add(llvm::createInstructionCombiningPass());
-        TheFPM->add(llvm::createReassociatePass());
-        TheFPM->add(llvm::createGVNPass());
-        TheFPM->add(llvm::createCFGSimplificationPass());
+            if(!func || func->isDeclaration())
+                return;
 
-        TheFPM->doInitialization();
+            auto    alias       = symbol(stem) + "_" + kind + "_" + symbol(funcName);
+            llvm::GlobalAlias::create(alias, func);
+            functions.emplace_back(alias, funcName);
+        };
 
-        auto& functions = TheModule->getFunctionList();
-        std::vector<std::string>    names;
+        for(auto expr: module->getExprs())
+            exports("expr", expr->where());
+        for(auto spec: module->getSpecs())
+            exports("spec", spec->where());
 
-        for(auto iter = functions.begin(); iter != functions.end(); iter++)
+        std::ofstream   header(std::filesystem::path(output).replace_extension(".h"));
+        CHeader::make(header, stem, module, options, functions);
+
+        std::error_code         error;
+        if(kind == Emit::ll || kind == Emit::bc)
         {
-            names.push_back(iter->getName().str());
+            llvm::raw_fd_ostream    os(path, error);
+            if(error)
+                throw std::runtime_error(path + ": " + error.message());
+
+            if(kind == Emit::ll)
+                TheModule->print(os, nullptr);
+            else
+                llvm::WriteBitcodeToFile(*TheModule, os);
 
-            TheFPM->run(*iter);
+            return  true;
         }
 
-        auto    xyz = llvm::raw_os_ostream(os);
-        TheModule->print(xyz, nullptr);
+        auto    object  = kind == Emit::so ? output.string() + ".o" : output.string();
+        {
+            llvm::raw_fd_ostream        os(object, error);
+            if(error)
+                throw std::runtime_error(object + ": " + error.message());
+
+            llvm::legacy::PassManager   PM;
+            if(TM->addPassesToEmitFile(PM, os, nullptr, llvm::CGFT_ObjectFile))
+                throw std::runtime_error("the target can't emit an object file");
+
+            Report::Scope   scope("codegen");
+
+            PM.run(*TheModule);
+        }
+
+        if(kind == Emit::so)
+        {
+            //  the system compiler driver links it, libc provides malloc and free
+            auto    cc      = std::getenv("CC") ? std::string(std::getenv("CC")) : std::string("cc");
+            auto    command = cc + " -shared -o '" + output.string() + "' '" + object + "'";
+            auto    status  = std::system(command.c_str());
+
+            std::filesystem::remove(object, error);
+
+            if(status != 0)
+                throw std::runtime_error(command + " failed");
+        }
+
+        return  true;
     }
     catch(Exception& e)
     {
@@ -132,5 +399,790 @@ void    Referee::compile(std::istream& is, std::string name, std::ostream& os)
     catch(std::exception& e)
     {
         std::cerr << "exception: " << e.what() << std::endl;
-    }    
-}
\ No newline at end of file
+    }
+
+    return  false;
+}
+
+bool    Referee::check(
+                std::istream&       is,
+                std::string         name,
+                std::string         trace,
+                std::string         conf,
+                std::ostream&       os,
+                Options const&      options)
+{
+    using   clock   = std::chrono::steady_clock;
+    using   msec    = std::chrono::duration<double, std::milli>;
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+
+    level(options.optLevel);    //  before a worker throws from the pipeline
+
+    auto    t0      = clock::now();
+    auto    source  = std::string(std::istreambuf_iterator<char>(is), {});
+    auto    text    = std::istringstream(source);
+    auto    module  = parse(text, name);
+    Pool    pool(options.jobs);
+
+    //  exprs then specs, in the order Compile::make emits them
+    std::vector<Position>       positions;
+    for(auto expr: module->getExprs())
+        positions.push_back(expr->where());
+    for(auto spec: module->getSpecs())
+        positions.push_back(spec->where());
+
+    //  one module per worker, each on its own context, so that optimization
+    //  and codegen of the parts run concurrently
+    auto    parts   = std::max<size_t>(1, std::min<size_t>(pool.size(), positions.size()));
+    auto    part    = [&](std::string const& key, size_t k)
+    {
+        return  parts == 1 ? key : key + "." + std::to_string(k) + "-" + std::to_string(parts);
+    };
+
+    //  with a cache hit on every part the module is only parsed, for the trace
+    //  layout, and the objects replace IR generation, optimization and codegen
+    std::unique_ptr<Cache>                              cache;
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>>    objects;
+    std::string                                         key;
+    if(!options.cache.empty() && !options.specialize)
+    {
+        cache   = std::make_unique<Cache>(options.cache, options.cacheSize);
+        key     = Cache::key(source, options);
+
+        for(size_t k = 0; k < parts; k++)
+        {
+            auto    object  = cache->load(part(key, k));
+            if(!object)
+                break;
+
+            objects.push_back(std::move(object));
+        }
+
+        if(objects.size() != parts)
+            objects.clear();
+    }
+
+    //  functions are compiled and optimized when first called, or all of a part when
+    //  first looked up; the cache stores whole parts and so compiles them eagerly
+    auto    TheJIT      = ExitOnErr(RefereeJIT::Create(cache.get(), options.cpu, options.features));
+    auto    cached      = !objects.empty();
+    auto    lazy        = options.lazy && !cache;
+
+    TheJIT->setOptimizer([&](llvm::Module& M) {
+        auto    TM  = ExitOnErr(TheJIT->createTargetMachine());
+        optimize(&M, options.optLevel, TM.get());
+    });
+
+    std::vector<std::unique_ptr<llvm::LLVMContext>> TheContexts;
+    std::vector<std::unique_ptr<llvm::Module>>      TheModules;
+    for(size_t k = 0; k < (cached ? 1 : parts); k++)
+    {
+        TheContexts.push_back(std::make_unique<llvm::LLVMContext>());
+        TheModules.push_back(std::make_unique<llvm::Module>(part(key.empty() ? name : key, k), *TheContexts.back()));
+        TheModules.back()->setDataLayout(TheJIT->getDataLayout());
+        TheModules.back()->setTargetTriple(TheJIT->getTargetTriple().str());
+    }
+
+    std::set<std::string>   symbols;
+    size_t                  total   = 0;
+    if(cached)
+    {
+        Compile::declare(TheContexts[0].get(), TheModules[0].get(), module, options);
+
+        for(auto& object: objects)
+            symbols.merge(Cache::symbols(*object, TheJIT->getDataLayout().getGlobalPrefix()));
+    }
+    else
+    {
+        for(size_t k = 0; k < parts; k++)
+            generate(module, TheContexts[k].get(), TheModules[k].get(), options, k, parts);
+
+        for(auto& TheModule: TheModules)
+        {
+            for(auto& func: TheModule->functions())
+            {
+                if(!func.isDeclaration())
+                    symbols.insert(func.getName().str());
+            }
+        }
+
+        total   = symbols.size();
+    }
+
+    //  every part declares the same types, the trace lays rows out by the first
+    auto    propType= llvm::StructType::getTypeByName(*TheContexts[0], "__prop_t");
+    auto    confType= llvm::StructType::getTypeByName(*TheContexts[0], "__conf_t");
+    auto    colsType= llvm::StructType::getTypeByName(*TheContexts[0], "__cols_t");
+
+    std::vector<std::string>    names;
+    std::vector<bool>           chunked;
+    for(auto& pos: positions)
+    {
+        auto    funcName    = Compile::name(pos);
+        auto    selected    = options.lines.empty()
+                            || std::find(options.lines.begin(), options.lines.end(), pos.beg.row) != options.lines.end();
+
+        if(!symbols.count(funcName) || !selected)
+            continue;
+
+        names.push_back(funcName);
+        chunked.push_back(symbols.count(funcName + ".chunk") != 0);
+    }
+
+    auto    t1      = clock::now();
+    auto    rowSize = TheJIT->getDataLayout().getTypeAllocSize(propType);
+    Trace   data(module, TheJIT->getDataLayout(), propType, confType, colsType);
+
+    if(trace.ends_with(".csv"))
+        data.loadCsv(trace);
+    else
+        data.loadRdb(trace);
+
+    if(!conf.empty())
+        data.loadConf(conf);
+
+    auto    t2      = clock::now();
+
+    //  the trailing arguments are cols with Layout::columns, then the witness
+    //  with Options::witness, each function is called through the type it was
+    //  emitted with, see call
+    std::vector<intptr_t>       funcs(names.size());
+    std::vector<Chunks>         chunks;
+    std::vector<size_t>         slots(names.size());
+
+    if(cached)
+    {
+        for(auto& object: objects)
+            ExitOnErr(TheJIT->addObject(std::move(object)));
+    }
+    else
+    {
+        for(size_t k = 0; k < parts; k++)
+        {
+            if(options.specialize)
+                Compile::specialize(TheModules[k].get(), data.conf());
+
+            auto    TSM     = llvm::orc::ThreadSafeModule(std::move(TheModules[k]), std::move(TheContexts[k]));
+
+            if(lazy)
+                ExitOnErr(TheJIT->addLazyModule(std::move(TSM)));
+            else
+                ExitOnErr(TheJIT->addModule(std::move(TSM)));
+        }
+    }
+
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        if(chunked[i])
+        {
+            slots[i]    = chunks.size();
+            chunks.emplace_back(nullptr, nullptr, nullptr);
+        }
+    }
+
+    //  an eager lookup materializes the module defining the symbol on the calling
+    //  thread, the first one into each part compiles it while the others wait;
+    //  a lazy one only returns the stub
+    pool.run(names.size(), [&](size_t i) {
+        auto    symbol  = ExitOnErr(TheJIT->lookup(names[i]));
+        funcs[i]        = (intptr_t)symbol.getAddress();
+
+        if(chunked[i])
+        {
+            auto    chunk   = ExitOnErr(TheJIT->lookup(names[i] + ".chunk"));
+            auto    horizon = ExitOnErr(TheJIT->lookup(names[i] + ".horizon"));
+            auto    seams   = ExitOnErr(TheJIT->lookup(names[i] + ".seams"));
+
+            chunks[slots[i]]    = Chunks(
+                (Chunks::func_t)(intptr_t)chunk.getAddress(),
+                (int64_t const*)(intptr_t)horizon.getAddress(),
+                (uint8_t const*)(intptr_t)seams.getAddress());
+        }
+    });
+
+    //  subformulas shared by several functions are tabulated once, level by
+    //  level, ahead of the specs; the functions compute those left empty, all
+    //  of them when only some specs are checked
+    std::map<unsigned, std::vector<std::pair<intptr_t, void**>>>    shared;
+    for(auto& symbol: symbols)
+    {
+        unsigned    level   = 0;
+        unsigned    index   = 0;
+        char        rest    = 0;
+
+        if(!options.lines.empty() || std::sscanf(symbol.c_str(), "shared.%u.%u%c", &level, &index, &rest) != 2)
+            continue;
+
+        shared[level].emplace_back(
+            (intptr_t)ExitOnErr(TheJIT->lookup(symbol)).getAddress(),
+            (void**)(intptr_t)ExitOnErr(TheJIT->lookup(symbol + ".buffer")).getAddress());
+    }
+
+    auto    t3      = clock::now();
+    auto    passed  = 0u;
+
+    for(auto& [level, fills]: shared)
+    {
+        pool.run(fills.size(), [&](size_t f) {
+            auto    [fill, buffer]  = fills[f];
+
+            //  fillers never take the witness
+            *buffer = colsType
+                    ? ((void* (*)(void*, void*, void*, void*))fill)(data.frst(), data.last(), data.conf(), data.cols())
+                    : ((void* (*)(void*, void*, void*))fill)(data.frst(), data.last(), data.conf());
+        });
+    }
+
+    //  specs only read the trace and conf, each one runs on whichever worker
+    //  gets to it and the report keeps the module order; the chunked ones
+    //  follow one at a time, each spreading its chunks over the pool
+    std::vector<char>           results(funcs.size());
+    std::vector<double>         times(funcs.size());
+    std::vector<size_t>         whole;
+    std::vector<std::array<int64_t, 4>>
+                                witnesses(funcs.size(), {-1, -1, -1, 0});
+
+    auto    call    = [&](size_t i) -> bool
+    {
+        using   func3_t = bool (*)(void*, void*, void*);
+        using   func4_t = bool (*)(void*, void*, void*, void*);
+        using   func5_t = bool (*)(void*, void*, void*, void*, void*);
+
+        if(colsType && options.witness)
+            return  ((func5_t)funcs[i])(data.frst(), data.last(), data.conf(), data.cols(), witnesses[i].data());
+        if(colsType)
+            return  ((func4_t)funcs[i])(data.frst(), data.last(), data.conf(), data.cols());
+        if(options.witness)
+            return  ((func4_t)funcs[i])(data.frst(), data.last(), data.conf(), witnesses[i].data());
+
+        return  ((func3_t)funcs[i])(data.frst(), data.last(), data.conf());
+    };
+
+    for(size_t i = 0; i < funcs.size(); i++)
+    {
+        if(!chunked[i])
+            whole.push_back(i);
+    }
+
+    pool.run(whole.size(), [&](size_t w) {
+        auto    i       = whole[w];
+        auto    beg     = clock::now();
+        results[i]      = call(i);
+        times[i]        = msec(clock::now() - beg).count();
+    });
+
+    for(size_t i = 0, c = 0; i < funcs.size(); i++)
+    {
+        if(!chunked[i])
+            continue;
+
+        auto    beg     = clock::now();
+        results[i]      = chunks[c++].run(pool, (char*)data.frst(), data.size(), rowSize, data.conf(), options.chunk);
+        times[i]        = msec(clock::now() - beg).count();
+
+        //  chunks only tell whether the spec holds, the whole function finds where it doesn't
+        if(!results[i] && options.witness)
+            call(i);
+    }
+
+    auto    t4      = clock::now();
+
+    for(auto& [level, fills]: shared)
+    {
+        for(auto [fill, buffer]: fills)
+        {
+            std::free(*buffer);
+            *buffer = nullptr;
+        }
+    }
+
+    for(size_t i = 0; i < funcs.size(); i++)
+    {
+        passed += results[i];
+
+        os  << (results[i] ? "PASS  " : "FAIL  ") 
+            << std::setw(24) << std::left << names[i] 
+            << std::fixed << std::setprecision(3) << times[i] << " ms";
+
+        auto&   witness = witnesses[i];
+        if(witness[0] >= 0)
+        {
+            os  << "  at " << witness[1] << " (row " << witness[0];
+            if(witness[2] >= 0)
+                os  << ", decided at row " << witness[2];
+            os  << ")";
+        }
+
+        os  << std::endl;
+    }
+
+    auto    eval    = std::chrono::duration<double>(t4 - t3).count();
+
+    os  << "specs:  " << passed << " passed, " << funcs.size() - passed << " failed" << std::endl;
+    os  << "trace:  " << data.size() << " events loaded in " << msec(t2 - t1).count() << " ms" << std::endl;
+    os  << "build:  " << msec(t1 - t0).count() << " ms, jit: " << msec(t3 - t2).count() << " ms";
+    if(cached)
+        os  << ", cached";
+    else
+        os  << ", " << TheJIT->compiled() << " of " << total << " functions compiled" << (lazy ? " lazily" : "")
+            << (options.specialize ? " for the conf" : "");
+    os  << std::endl;
+    os  << "eval:   " << msec(t4 - t3).count() << " ms, " 
+        << std::setprecision(0) << (eval > 0 ? data.size() / eval : 0.0) << " events/sec" << std::endl;
+
+    return  passed == funcs.size();
+}
+
+using   init_t  = void (*)(void*);
+using   step_t  = bool (*)(void*, void*, void*);
+
+//  the code of one build of Referee::monitor, removed from the JIT once no
+//  stepper runs it any more
+struct  Build
+{
+    llvm::orc::ResourceTrackerSP    tracker;
+
+    ~Build()
+    {
+        ExitOnErr(tracker->remove());
+    }
+};
+
+//  the init/step/done functions of a past-time expr or spec and the state they keep
+struct  Stepper
+{
+    std::string         key;        //  the expr or spec printed, moving or reformatting it keeps the key
+    std::string         name;
+    step_t              step;
+    init_t              done;
+    std::vector<char>   state;
+    bool                passed  = true;
+    int64_t             time    = 0;
+    size_t              from    = SIZE_MAX; //  the stepper of the previous table this one continues
+    std::shared_ptr<Build>  build;
+};
+
+//  what Referee::monitor steps every sample with
+struct  Steppers
+{
+    std::vector<Stepper>    steppers;
+    std::set<std::string>   keys;           //  of every expr and spec, past-time or not
+};
+
+//  the key and function name of each distinct expr and spec of `module`
+static std::vector<std::pair<std::string, std::string>> entries(Module* module)
+{
+    std::vector<std::pair<std::string, std::string>>    result;
+    std::set<std::string>                               names;
+
+    auto    add     = [&](Base* base, Position const& pos)
+    {
+        auto    funcName    = Compile::name(pos);
+
+        if(!names.insert(funcName).second)
+            return;
+
+        std::ostringstream  key;
+        Printer::output(key, base);
+        result.emplace_back(key.str(), funcName);
+    };
+
+    for(auto expr: module->getExprs())
+        add(expr, expr->where());
+    for(auto spec: module->getSpecs())
+        add(spec, spec->where());
+
+    return  result;
+}
+
+//  the structure of `type`, equal for types laid out alike
+static std::string  shape(Type* type)
+{
+    if(auto array = dynamic_cast<TypeArray*>(type))
+        return  shape(array->type) + "[" + std::to_string(array->size) + "]";
+
+    std::string result  = typeid(*type).name();
+
+    if(auto record = dynamic_cast<TypeStruct*>(type))
+    {
+        for(auto& member: record->members)
+            result  += " " + member.name + ":" + shape(member.data);
+    }
+
+    if(auto enumeration = dynamic_cast<TypeEnum*>(type))
+    {
+        for(auto& item: enumeration->items)
+            result  += " " + item;
+    }
+
+    return  "(" + result + ")";
+}
+
+//  the props and conf of `module`, a module of the same shape reads the rows and
+//  conf of a Trace built for the other
+static std::string  shape(Module* module)
+{
+    std::string result;
+
+    for(auto name: module->getPropNames())
+        result  += "data " + name + ":" + shape(module->getProp(name)) + ";";
+    for(auto name: module->getConfNames())
+        result  += "conf " + name + ":" + shape(module->getConf(name)) + ";";
+
+    return  result;
+}
+
+//  steppers of the exprs and specs of `module`, those with the key of one of
+//  `previous` continue it, the others run the code of TSM, added to the JIT
+//  under a tracker of its own, where their functions are named with `suffix`
+static std::unique_ptr<Steppers>    install(
+                                        Module*                     module,
+                                        llvm::orc::ThreadSafeModule TSM,
+                                        std::string const&          suffix,
+                                        Steppers const*             previous,
+                                        RefereeJIT*                 TheJIT)
+{
+    auto    result  = std::make_unique<Steppers>();
+    auto    build   = std::make_shared<Build>();
+    auto    kept    = std::map<std::string, size_t>();
+    auto    stepped = std::set<std::string>();
+    auto    listed  = entries(module);
+
+    if(previous)
+    {
+        for(size_t i = 0; i < previous->steppers.size(); i++)
+            kept[previous->steppers[i].key] = i;
+    }
+
+    TSM.withModuleDo([&](llvm::Module& M) {
+        for(auto& [key, funcName]: listed)
+        {
+            if(M.getFunction(funcName + ".step" + suffix))
+                stepped.insert(funcName);
+        }
+    });
+
+    build->tracker  = TheJIT->getMainJITDylib().createResourceTracker();
+    ExitOnErr(TheJIT->addModule(std::move(TSM), build->tracker));
+
+    for(auto& entry: listed)
+    {
+        auto&   key         = entry.first;
+        auto&   funcName    = entry.second;
+
+        result->keys.insert(key);
+
+        if(kept.count(key))
+        {
+            auto&   from    = previous->steppers[kept[key]];
+
+            result->steppers.push_back(Stepper{key, funcName, from.step, from.done, {}, true, 0, kept[key], from.build});
+            continue;
+        }
+
+        if(!stepped.count(funcName))
+            continue;
+
+        auto    symbol  = [&](std::string kind) {return ExitOnErr(TheJIT->lookup(funcName + kind + suffix)).getAddress();};
+        auto    size    = (int64_t const*)(intptr_t)symbol(".size");
+        auto    init    = (init_t)(intptr_t)symbol(".init");
+        auto    step    = (step_t)(intptr_t)symbol(".step");
+        auto    done    = (init_t)(intptr_t)symbol(".done");
+
+        result->steppers.push_back(Stepper{key, funcName, step, done, std::vector<char>(*size + 1), true, 0, SIZE_MAX, build});
+        init(result->steppers.back().state.data());
+    }
+
+    return  result;
+}
+
+//  finishes the steppers of a table no sample runs any more, those taken over
+//  have no state left; its builds go once no later table keeps a stepper of them
+static void     retire(Steppers* steppers)
+{
+    if(!steppers)
+        return;
+
+    for(auto& stepper: steppers->steppers)
+    {
+        if(!stepper.state.empty())
+            stepper.done(stepper.state.data());
+    }
+
+    delete steppers;
+}
+
+//  makes `next` current, the steppers it keeps take over the state of those they
+//  continue; runs on the evaluator between two samples, so it only moves, unless
+//  the table replaced before was not retired yet
+static void     adopt(std::unique_ptr<Steppers>& current, Steppers* next, std::atomic<Steppers*>& retired)
+{
+    for(auto& stepper: next->steppers)
+    {
+        if(stepper.from == SIZE_MAX)
+            continue;
+
+        auto&   from    = current->steppers[stepper.from];
+
+        stepper.state   = std::exchange(from.state, {});
+        stepper.passed  = from.passed;
+        stepper.time    = from.time;
+    }
+
+    retire(retired.exchange(current.release()));
+    current.reset(next);
+}
+
+//  steppers for the `path` as it is now: only the exprs and specs that are not
+//  in `latest` are compiled, with a context and a target machine of their own;
+//  the props and conf have to keep their shape, the trace is decoded by them
+static std::unique_ptr<Steppers>    reload(
+                                        std::string const&  path,
+                                        std::string const&  name,
+                                        Module*             loaded,
+                                        Options const&      options,
+                                        RefereeJIT*         TheJIT,
+                                        Steppers const*     latest,
+                                        size_t              generation,
+                                        std::ostream&       os)
+{
+    using   clock   = std::chrono::steady_clock;
+    using   msec    = std::chrono::duration<double, std::milli>;
+
+    auto    t0          = clock::now();
+    auto    suffix      = "." + std::to_string(generation);
+    auto    TM          = ExitOnErr(TheJIT->createTargetMachine());
+    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
+    auto    TheModule   = std::make_unique<llvm::Module>(name + suffix, *TheContext);
+    std::ifstream   is(path, std::ios_base::in);
+
+    TheModule->setDataLayout(TheJIT->getDataLayout());
+    TheModule->setTargetTriple(TM->getTargetTriple().str());
+
+    //  a module name is taken once per process
+    auto    module  = parse(is, name + suffix);
+
+    if(shape(module) != shape(loaded))
+        throw std::runtime_error("the data or conf declarations changed, restart to check them");
+
+    std::set<std::string>   names;
+    for(auto& [key, funcName]: entries(module))
+    {
+        if(!latest->keys.count(key))
+            names.insert(funcName);
+    }
+
+    generate(module, TheContext.get(), TheModule.get(), options, names);
+    optimize(TheModule.get(), options.optLevel, TM.get());
+
+    //  kept functions of earlier builds may still hold the names
+    for(auto& value: TheModule->global_values())
+    {
+        if(!value.isDeclaration() && !value.hasLocalLinkage())
+            value.setName(value.getName().str() + suffix);
+    }
+
+    auto    result  = install(module, llvm::orc::ThreadSafeModule(std::move(TheModule), std::move(TheContext)), suffix, latest, TheJIT);
+    auto    kept    = std::count_if(result->steppers.begin(), result->steppers.end(), [](auto& stepper) {return stepper.from != SIZE_MAX;});
+
+    os  << "reload: " << names.size() << " compiled, " << kept << " kept, " << latest->steppers.size() - kept << " dropped in "
+        << std::fixed << std::setprecision(3) << msec(clock::now() - t0).count() << " ms" << std::endl;
+
+    return  result;
+}
+
+//  polls `path` until `stop` and reloads it when its modification time changes;
+//  a reload is published in `pending` and the next one waits until the evaluator
+//  adopted it, the table it replaced comes back in `retired` to be freed here,
+//  off the evaluator.  `pending` is cleared only after `retired` is set, so the
+//  table is retired here before the next reload can replace another one
+static void     watch(
+                    std::string const&                  path,
+                    std::filesystem::file_time_type     stamp,
+                    std::string const&                  name,
+                    Module*                             loaded,
+                    Options const&                      options,
+                    RefereeJIT*                         TheJIT,
+                    Steppers const*                     latest,
+                    std::atomic<Steppers*>&             pending,
+                    std::atomic<Steppers*>&             retired,
+                    std::atomic<bool> const&            stop,
+                    std::ostream&                       os)
+{
+    for(size_t generation = 1; !stop; std::this_thread::sleep_for(std::chrono::milliseconds(100)))
+    {
+        if(pending)
+            continue;
+
+        retire(retired.exchange(nullptr));
+
+        std::error_code error;
+        auto    modified    = std::filesystem::last_write_time(path, error);
+
+        if(error || modified == stamp)
+            continue;
+
+        stamp   = modified;
+
+        try {
+            auto    next    = reload(path, name, loaded, options, TheJIT, latest, generation++, os);
+
+            latest  = next.get();
+            pending = next.release();
+        }
+        catch(Exception& e)
+        {
+            os  << "reload: " << e.what() << ", the loaded specs stay" << std::endl;
+        }
+        catch(std::exception& e)
+        {
+            os  << "reload: " << e.what() << ", the loaded specs stay" << std::endl;
+        }
+    }
+}
+
+bool    Referee::monitor(
+                std::istream&       is,
+                std::string         name,
+                std::string         trace,
+                std::string         conf,
+                std::ostream&       os,
+                Options const&      options)
+{
+    using   clock   = std::chrono::steady_clock;
+    using   msec    = std::chrono::duration<double, std::milli>;
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+
+    auto    TheJIT      = ExitOnErr(RefereeJIT::Create(nullptr, options.cpu, options.features));
+    auto    TM          = ExitOnErr(TheJIT->createTargetMachine());
+    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
+    auto    TheModule   = std::make_unique<llvm::Module>(name, *TheContext);
+    auto    monitored   = options;
+
+    monitored.monitor   = true;
+    if(monitored.layout == Layout::columns)
+        monitored.layout    = Layout::pointers; //  steps read one row rewritten in place
+    TheModule->setDataLayout(TheJIT->getDataLayout());
+    TheModule->setTargetTriple(TM->getTargetTriple().str());
+
+    //  edits made while the build runs are picked up by the first reload
+    auto    stamp   = options.watch.empty() ? std::filesystem::file_time_type() : std::filesystem::last_write_time(options.watch);
+
+    auto    t0      = clock::now();
+    auto    module  = build(is, name, TheContext.get(), TheModule.get(), TM.get(), monitored);
+    auto    propType= llvm::StructType::getTypeByName(*TheContext, "__prop_t");
+    auto    confType= llvm::StructType::getTypeByName(*TheContext, "__conf_t");
+    auto    rowSize = TheJIT->getDataLayout().getTypeAllocSize(propType);
+
+    //  the trace keeps decoding samples by propType while they stream in,
+    //  so hold on to the context after the JIT is done with the module
+    auto    TheTSC  = llvm::orc::ThreadSafeContext(std::move(TheContext));
+    auto    current = install(module, llvm::orc::ThreadSafeModule(std::move(TheModule), TheTSC), "", nullptr, TheJIT.get());
+
+    auto    t1      = clock::now();
+    Trace   data(module, TheJIT->getDataLayout(), propType, confType);
+    auto    count   = size_t(0);
+
+    if(!conf.empty())
+        data.loadConf(conf);
+
+    //  with Options::watch a reload builds the next steppers while the trace
+    //  streams, the evaluator swaps them in between two samples
+    std::atomic<Steppers*>  pending = nullptr;
+    std::atomic<Steppers*>  retired = nullptr;
+    std::atomic<bool>       stop    = false;
+    std::thread             watcher;
+
+    //  stops the watcher however the stream ends
+    struct  Join
+    {
+        std::atomic<bool>&  stop;
+        std::thread&        watcher;
+
+        ~Join()
+        {
+            stop    = true;
+            if(watcher.joinable())
+                watcher.join();
+        }
+    }   join{stop, watcher};
+
+    if(!options.watch.empty())
+    {
+        watcher = std::thread([&, latest = current.get()]() {
+            watch(options.watch, stamp, name, module, monitored, TheJIT.get(), latest, pending, retired, stop, os);
+        });
+    }
+
+    auto    step    = [&](void* curr) {
+        if(auto next = pending.load(std::memory_order_acquire))
+        {
+            adopt(current, next, retired);
+            pending = nullptr;
+        }
+
+        for(auto& stepper: current->steppers)
+        {
+            if(stepper.passed && !stepper.step(stepper.state.data(), curr, data.conf()))
+            {
+                stepper.passed  = false;
+                stepper.time    = *static_cast<int64_t const*>(curr);
+            }
+        }
+        count++;
+    };
+
+    if(trace.ends_with(".csv"))
+    {
+        data.loadCsv(trace);
+
+        for(auto curr = static_cast<char*>(data.frst()) + rowSize; curr < data.last(); curr += rowSize)
+        {
+            step(curr);
+        }
+    }
+    else
+    {
+        data.streamRdb(trace, step);
+    }
+
+    auto    t2      = clock::now();
+    auto    passed  = 0u;
+
+    //  a reload the trace ended before has seen no sample, it is dropped
+    stop    = true;
+    if(watcher.joinable())
+        watcher.join();
+    retire(retired.exchange(nullptr));
+    retire(pending.exchange(nullptr));
+
+    auto&   steppers    = current->steppers;
+    for(auto& stepper: steppers)
+    {
+        stepper.done(stepper.state.data());
+        passed += stepper.passed;
+
+        os  << (stepper.passed ? "PASS  " : "FAIL  ") 
+            << std::setw(24) << std::left << stepper.name;
+
+        if(!stepper.passed)
+            os  << "at " << stepper.time;
+
+        os  << std::endl;
+    }
+
+    auto    eval    = std::chrono::duration<double>(t2 - t1).count();
+
+    os  << "specs:  " << passed << " passed, " << steppers.size() - passed << " failed, " << current->keys.size() - steppers.size() << " not past-time" << std::endl;
+    os  << "build:  " << std::fixed << std::setprecision(3) << msec(t1 - t0).count() << " ms" << std::endl;
+    os  << "eval:   " << count << " events in " << msec(t2 - t1).count() << " ms, " 
+        << std::setprecision(0) << (eval > 0 ? count / eval : 0.0) << " events/sec" << std::endl;
+
+    return  passed == steppers.size();
+}
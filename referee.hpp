@@ -25,9 +25,31 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+
+#include "options.hpp"
+
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+
+//  what Referee::emit writes
+enum class Emit
+{
+    ll,         //  textual IR
+    bc,         //  bitcode
+    obj,        //  a native object
+    so,         //  a shared library, linked by $CC or cc
+};
 
 class Referee
 {
 public:
-    static void     compile(std::istream& is, std::string name, std::ostream& os = std::cout);
+    static void     compile(std::istream& is, std::string name, std::ostream& os = std::cout, Options const& options = Options());
+    //  the optimized module compiled from is, with the data layout and triple of the JIT for options.cpu
+    //  and options.features, ready for RefereeJIT::addModule; throws on errors
+    static llvm::orc::ThreadSafeModule
+                    module( std::istream& is, std::string name, Options const& options = Options());
+    //  writes the compiled module to path and a C header declaring its types and functions next to it
+    static bool     emit(   std::istream& is, std::string name, std::string path, Emit kind, Options const& options = Options());
+    static bool     check(  std::istream& is, std::string name, std::string trace, std::string conf = "", std::ostream& os = std::cout, Options const& options = Options());
+    static bool     monitor(std::istream& is, std::string name, std::string trace, std::string conf = "", std::ostream& os = std::cout, Options const& options = Options());
 };
\ No newline at end of file
@@ -0,0 +1,1062 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "gtest/gtest.h"
+#include "../rdb/database.hpp"
+#include "cache.hpp"
+#include "referee.hpp"
+#include "report.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstring>
+#include <dlfcn.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+
+//  modules are hash-consed by name, so every test compiles the file under its own name
+
+TEST(Check, Csv)
+{
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_TRUE(Referee::check(stream, "check.csv", "../test/check/check.csv", "../test/check/conf.csv", os));
+    EXPECT_EQ(os.str().find("FAIL"), std::string::npos);
+}
+
+TEST(Check, Columns)
+{
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+    Options             options;
+
+    options.layout  = Layout::columns;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_TRUE(Referee::check(stream, "check.columns", "../test/check/check.csv", "../test/check/conf.csv", os, options));
+    EXPECT_EQ(os.str().find("FAIL"), std::string::npos);
+}
+
+TEST(Check, Values)
+{
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+    Options             options;
+
+    options.layout  = Layout::values;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_TRUE(Referee::check(stream, "check.values", "../test/check/check.csv", "../test/check/conf.csv", os, options));
+    EXPECT_EQ(os.str().find("FAIL"), std::string::npos);
+}
+
+TEST(Check, OptLevel)
+{
+    std::string         filename    = "../test/check/check.ref";
+
+    for(auto level: {0u, 1u, 2u, 3u})
+    {
+        std::ifstream       stream(filename, std::ios_base::in);
+        std::ostringstream  os;
+        Options             options;
+
+        options.optLevel    = level;
+
+        ASSERT_TRUE(stream.is_open());
+        EXPECT_TRUE(Referee::check(stream, "check.O" + std::to_string(level), "../test/check/check.csv", "../test/check/conf.csv", os, options));
+        EXPECT_EQ(os.str().find("FAIL"), std::string::npos);
+    }
+}
+
+TEST(Check, Cpu)
+{
+    std::string         filename    = "../test/check/check.ref";
+
+    //  the host, a baseline cpu, and the host without its vector extensions
+    for(auto [cpu, features]: {std::pair{"", ""}, std::pair{"generic", ""}, std::pair{"", "-avx,-avx2,-avx512f"}})
+    {
+        std::ifstream       stream(filename, std::ios_base::in);
+        std::ostringstream  os;
+        Options             options;
+
+        options.cpu         = cpu;
+        options.features    = features;
+        options.layout      = Layout::columns;
+
+        ASSERT_TRUE(stream.is_open());
+        EXPECT_TRUE(Referee::check(stream, std::string("check.cpu.") + cpu + features, "../test/check/check.csv", "../test/check/conf.csv", os, options));
+        EXPECT_EQ(os.str().find("FAIL"), std::string::npos);
+    }
+
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+    Options             options;
+
+    options.cpu         = "no-such-cpu";
+    EXPECT_THROW(Referee::check(stream, "check.cpu.unknown", "../test/check/check.csv", "../test/check/conf.csv", os, options), std::runtime_error);
+}
+
+TEST(Check, Jobs)
+{
+    std::string         filename    = "../test/check/check.ref";
+    std::ostringstream  one;
+    std::ostringstream  four;
+    Options             options;
+
+    //  the report keeps the module order whichever worker ran a spec
+    auto    verdicts    = [](std::string const& text) {
+        std::istringstream  is(text);
+        std::string         line;
+        std::string         result;
+
+        while(std::getline(is, line) && (line.starts_with("PASS") || line.starts_with("FAIL")))
+        {
+            result  += line.substr(0, 30) + "\n";
+        }
+
+        return  result;
+    };
+
+    std::ifstream       stream1(filename, std::ios_base::in);
+    options.jobs    = 1;
+    EXPECT_TRUE(Referee::check(stream1, "check.jobs1", "../test/check/check.csv", "../test/check/conf.csv", one, options));
+
+    std::ifstream       stream4(filename, std::ios_base::in);
+    options.jobs    = 4;
+    EXPECT_TRUE(Referee::check(stream4, "check.jobs4", "../test/check/check.csv", "../test/check/conf.csv", four, options));
+
+    EXPECT_FALSE(verdicts(one.str()).empty());
+    EXPECT_EQ(verdicts(one.str()), verdicts(four.str()));
+}
+
+TEST(Check, Lazy)
+{
+    std::string         filename    = "../test/check/check.ref";
+    Options             options;
+
+    auto    run     = [&](std::string name)
+    {
+        std::ifstream       stream(filename, std::ios_base::in);
+        std::ostringstream  os;
+
+        EXPECT_TRUE(Referee::check(stream, name, "../test/check/check.csv", "../test/check/conf.csv", os, options));
+
+        return  os.str();
+    };
+
+    //  only the function of the one spec checked gets compiled
+    options.lines   = {14};
+    auto    lazy    = run("check.lazy");
+    EXPECT_NE(lazy.find("PASS  14:0 .. 14:4"), std::string::npos);
+    EXPECT_NE(lazy.find("1 of 5 functions compiled lazily"), std::string::npos);
+
+    options.lazy    = false;
+    auto    eager   = run("check.eager");
+    EXPECT_NE(eager.find("PASS  14:0 .. 14:4"), std::string::npos);
+    EXPECT_NE(eager.find("5 of 5 functions compiled"), std::string::npos);
+    EXPECT_EQ(eager.find("lazily"), std::string::npos);
+}
+
+TEST(Check, Specialize)
+{
+    std::string         filename    = "../test/check/check.ref";
+    Options             options;
+
+    auto    run     = [&](std::string name, std::string conf, bool expected)
+    {
+        std::ifstream       stream(filename, std::ios_base::in);
+        std::ostringstream  os;
+
+        EXPECT_EQ(Referee::check(stream, name, "../test/check/check.csv", conf, os, options), expected);
+
+        return  os.str();
+    };
+
+    options.specialize  = true;
+    options.cache       = "specialize.cache";
+
+    //  C.lo and C.hi are folded into 13:0, a different conf compiles it again
+    auto    fits    = run("check.specialize", "../test/check/conf.csv", true);
+    EXPECT_NE(fits.find("5 of 5 functions compiled lazily for the conf"), std::string::npos);
+
+    std::ofstream("specialize.csv") << "C.lo,C.hi\n4,9\n";
+    auto    narrow  = run("check.specialize.narrow", "specialize.csv", false);
+    EXPECT_NE(narrow.find("FAIL  13:0 .. 13:29"), std::string::npos);
+    EXPECT_EQ(narrow.find("cached"), std::string::npos);
+
+    std::filesystem::remove_all("specialize.cache");
+}
+
+TEST(Check, TimeReport)
+{
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+    Options             options;
+
+    options.lazy    = false;
+
+    Report::reset();
+    Report::enable();
+    EXPECT_TRUE(Referee::check(stream, "check.report", "../test/check/check.csv", "../test/check/conf.csv", os, options));
+    Report::enable(false);
+
+    std::ostringstream  text;
+    std::ostringstream  json;
+    Report::print(text);
+    Report::print(json, true);
+
+    //  phases nest, functions carry their sizes before and after the optimizer
+    EXPECT_NE(text.str().find("  function"), std::string::npos);
+    EXPECT_NE(text.str().find("13:0 .. 13:29"), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\": \"parse\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\": \"generate/function/typecalc\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\": \"optimize\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\": \"codegen\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\": \"13:0 .. 13:29\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"opt_insts\""), std::string::npos);
+    EXPECT_EQ(json.str().find("\"nodes\": 0,"), std::string::npos);
+
+    //  names are JSON strings, control characters included
+    Report::reset();
+    Report::enable();
+    {
+        Report::Scope   scope("tab\there");
+    }
+    Report::enable(false);
+    json.str("");
+    Report::print(json, true);
+    EXPECT_NE(json.str().find("\"name\": \"tab\\u0009here\""), std::string::npos);
+
+    Report::reset();
+}
+
+TEST(Check, NoConf)
+{
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_FALSE(Referee::check(stream, "check.noconf", "../test/check/check.csv", "", os));
+    EXPECT_NE(os.str().find("FAIL"), std::string::npos);
+}
+
+TEST(Check, Rdb)
+{
+    using namespace referee::db;
+
+    auto    boolean = TypeBoolean();
+    auto    integer = TypeInteger();
+    auto    number  = TypeNumber();
+    auto    record  = TypeBuilderRecord().integer("lo").integer("hi").build();
+
+    Writer  writer;
+    writer.open("check.rdb");
+
+    auto    typeB   = writer.declType(&boolean);
+    auto    typeI   = writer.declType(&integer);
+    auto    typeN   = writer.declType(&number);
+    auto    typeC   = writer.declType(record);
+
+    auto    confC   = writer.declConf(typeC, "C");
+    writer.pushData(confC, DataWriter().integer(1).integer(3).build());
+
+    auto    propA   = writer.declProp(typeB, "a");
+    auto    propN   = writer.declProp(typeI, "n");
+    auto    propX   = writer.declProp(typeN, "x");
+    auto    propM   = writer.declProp(typeI, "m");
+
+    //  x is pushed once and held for the whole trace
+    writer.pushData(propX,  0, DataWriter().number(0.5).build());
+    for(auto [time, a, n, m]: {std::tuple(0, false, 1, 1), std::tuple(10, true, 2, 2), std::tuple(20, false, 3, 1)})
+    {
+        writer.pushData(propA, time, DataWriter().boolean(a).build());
+        writer.pushData(propN, time, DataWriter().integer(n).build());
+        writer.pushData(propM, time, DataWriter().integer(m).build());
+    }
+    writer.close();
+
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_TRUE(Referee::check(stream, "check.rdb", "check.rdb", "", os));
+    EXPECT_NE(os.str().find("3 events"), std::string::npos);
+}
+
+TEST(Check, RdbMapped)
+{
+    using namespace referee::db;
+
+    auto    integer = TypeInteger();
+    auto    string  = TypeString();
+
+    Writer  writer;
+    writer.open("mapped.rdb");
+
+    auto    propN   = writer.declProp(writer.declType(&integer), "n");
+    auto    propS   = writer.declProp(writer.declType(&string), "s");
+    for(int64_t time = 0; time < 4; time++)
+    {
+        writer.pushData(propN, time, DataWriter().integer(-time).build());
+        writer.pushData(propS, time, DataWriter().string(std::string(time, 'x')).build());
+    }
+    writer.close();
+
+    Reader      reader;
+    RecordView  record;
+
+    reader.open("mapped.rdb", SEQUENTIAL | HUGEPAGE);
+    EXPECT_TRUE(reader.mapped());
+
+    auto    count   = 0;
+    while(reader.next(record))
+    {
+        if(record.type != PUSH_PROP)
+            continue;
+
+        DataReader  data(record.data);
+        if(record.indx == propN)
+        {
+            int64_t value;
+            data.integer(value);
+            EXPECT_EQ(value, -int64_t(record.time));
+        }
+        else
+        {
+            std::string_view    value;
+            int64_t             past;
+            data.string(value);
+            EXPECT_EQ(value, std::string(record.time, 'x'));
+            EXPECT_THROW(data.integer(past), std::runtime_error);
+        }
+        count++;
+    }
+    EXPECT_EQ(count, 8);
+
+    //  a record cut short by the end of the file
+    auto    size    = std::filesystem::file_size("mapped.rdb");
+    std::filesystem::resize_file("mapped.rdb", size - 2);
+
+    reader.open("mapped.rdb");
+    EXPECT_THROW(while(reader.next(record)) {}, std::runtime_error);
+    reader.close();
+}
+
+TEST(Check, RdbBlocks)
+{
+    using namespace referee::db;
+
+    auto    integer = TypeInteger();
+    auto    write   = [&](std::string filename, Format format) {
+        Writer  writer;
+        writer.open(filename, format, 96);
+
+        auto    typeI   = writer.declType(&integer);
+        auto    propN   = writer.declProp(typeI, "n");
+        auto    propM   = writer.declProp(typeI, "m");
+        for(uint64_t time = 0; time < 100; time++)
+        {
+            writer.pushData(time % 3 ? propN : propM, time * 10, DataWriter().integer(time).build());
+        }
+        writer.close();
+    };
+
+    write("flat.rdb", FLAT);
+    write("blocks.rdb", BLOCKS);
+
+    auto    records = [](Reader& reader) {
+        std::vector<std::tuple<uint16_t, uint8_t, uint64_t, std::string>>  records;
+        RecordView  record;
+
+        while(reader.next(record))
+        {
+            if(record.type != ROOT)
+                records.emplace_back(record.type, record.indx, record.time, record.data);
+        }
+
+        return  records;
+    };
+
+    Reader  flat;
+    Reader  blocks;
+
+    flat.open("flat.rdb");
+    blocks.open("blocks.rdb");
+    EXPECT_FALSE(flat.indexed());
+    EXPECT_FALSE(flat.seek(0));
+    ASSERT_TRUE(blocks.indexed());
+    EXPECT_GT(blocks.blocks().size(), 10);
+
+    auto    all     = records(flat);
+    EXPECT_EQ(all.size(), 103);
+    EXPECT_EQ(records(blocks), all);
+
+    //  the declarations, then the samples timed in [205, 400]
+    ASSERT_TRUE(blocks.seek(205, 400));
+    auto    range   = records(blocks);
+    ASSERT_EQ(range.size(), 3 + 20);
+    EXPECT_EQ(std::get<0>(range[2]), DECL_PROP);
+    EXPECT_EQ(std::get<2>(range[3]), 210);
+    EXPECT_EQ(std::get<2>(range.back()), 400);
+
+    ASSERT_TRUE(blocks.seek(2000));
+    EXPECT_EQ(records(blocks).size(), 3);
+
+    //  a writer that did not get to close() leaves no TAIL, or stops within
+    //  the blocks; what was written is read in order without the index
+    auto    last    = blocks.blocks().back();
+    for(auto [file, size]: {std::pair("open.rdb", std::filesystem::file_size("blocks.rdb") - 16), std::pair("cut.rdb", last.offset)})
+    {
+        std::filesystem::copy_file("blocks.rdb", file, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(file, size);
+
+        Reader  open;
+        open.open(file);
+        EXPECT_FALSE(open.indexed());
+        EXPECT_FALSE(open.seek(0));
+        EXPECT_EQ(records(open).size(), all.size() - (size == last.offset ? last.count : 0));
+        std::filesystem::remove(file);
+    }
+
+    std::ifstream       stream("../test/check/check.ref", std::ios_base::in);
+    std::ostringstream  os;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_FALSE(Referee::check(stream, "check.blocks", "blocks.rdb", "", os));
+    EXPECT_NE(os.str().find("100 events"), std::string::npos);
+
+    write("columns.rdb", COLUMNS);
+    stream.clear();
+    stream.seekg(0);
+    os.str("");
+
+    EXPECT_FALSE(Referee::check(stream, "check.segments", "columns.rdb", "", os));
+    EXPECT_NE(os.str().find("100 events"), std::string::npos);
+}
+
+TEST(Check, RdbColumns)
+{
+    using namespace referee::db;
+
+    auto    integer = TypeInteger();
+    auto    string  = TypeString();
+    auto    sample  = TypeBuilderRecord()
+                        .integer("lo")
+                        .number("x")
+                        .boolean("b")
+                        .array("xs", TypeBuilderArray().integer().build())
+                        .string("s")
+                        .build();
+
+    auto    write   = [&](std::string filename, Format format) {
+        Writer  writer;
+        writer.open(filename, format, 256);
+
+        auto    typeI   = writer.declType(&integer);
+        auto    typeS   = writer.declType(&string);
+        auto    typeR   = writer.declType(sample);
+
+        std::vector<uint8_t>    props;
+        for(auto i = 0; i < 80; i++)
+        {
+            props.push_back(writer.declProp(typeI, "p" + std::to_string(i)));
+        }
+        auto    propS   = writer.declProp(typeS, "s");
+        auto    propR   = writer.declProp(typeR, "r");
+
+        for(int64_t time = 0; time < 200; time++)
+        {
+            writer.pushData(props[time % 80], 1000 + time * time, DataWriter().integer(time * 7 - 500).build());
+
+            if(time % 5 == 0)
+                writer.pushData(propS, 1000 + time * time, DataWriter().string(std::string(time % 7, 'a' + time % 26)).build());
+
+            auto    data    = DataWriter();
+            data.integer(-time).number(time / 4.0).boolean(time % 2).size(time % 4);
+            for(auto i = 0; i < time % 4; i++)
+            {
+                data.integer(time + i);
+            }
+            writer.pushData(propR, 1000 + time * time, data.string("r" + std::to_string(time)).build());
+        }
+        writer.close();
+    };
+
+    write("flat.rdb", FLAT);
+    write("columns.rdb", COLUMNS);
+
+    auto    records = [](std::string filename, std::vector<std::string> select) {
+        std::vector<std::tuple<uint16_t, uint8_t, uint64_t, std::string>>  records;
+        Reader      reader;
+        RecordView  record;
+
+        reader.open(filename);
+        reader.select(select);
+        while(reader.next(record))
+        {
+            if(record.type == PUSH_PROP)
+                records.emplace_back(record.type, record.indx, record.time, record.data);
+        }
+
+        return  records;
+    };
+
+    auto    all     = records("flat.rdb", {});
+    EXPECT_EQ(all.size(), 200 + 40 + 200);
+    EXPECT_EQ(records("columns.rdb", {}), all);
+
+    auto    some    = records("flat.rdb", {"p3", "s", "r"});
+    EXPECT_EQ(some.size(), 3 + 40 + 200);
+    EXPECT_EQ(records("columns.rdb", {"p3", "s", "r"}), some);
+
+    EXPECT_LT(std::filesystem::file_size("columns.rdb"), std::filesystem::file_size("flat.rdb"));
+
+    //  read off a pipe, samples come out while the rest of the file is still to come
+    std::ifstream   file("columns.rdb", std::ios_base::binary);
+    std::string     bytes(std::istreambuf_iterator<char>(file), {});
+    size_t          half    = 0;
+    while(half < bytes.size() / 2)
+    {
+        uint32_t    size;
+        std::memcpy(&size, bytes.data() + half + sizeof(uint32_t), sizeof(size));
+        half   += 2 * sizeof(uint32_t) + ntohl(size);
+    }
+
+    std::filesystem::remove("columns.pipe");
+    ASSERT_EQ(mkfifo("columns.pipe", 0600), 0);
+
+    std::atomic<bool>   seen    = false;
+    bool                early   = false;
+    std::thread         writer([&]() {
+        std::ofstream   pipe("columns.pipe", std::ios_base::binary);
+        pipe << bytes.substr(0, half) << std::flush;
+
+        for(auto i = 0; i < 500 && !seen; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        early   = seen;
+        pipe << bytes.substr(half);
+    });
+
+    std::vector<std::tuple<uint16_t, uint8_t, uint64_t, std::string>>  streamed;
+    {
+        Reader      reader;
+        RecordView  record;
+
+        reader.open("columns.pipe");
+        while(reader.next(record))
+        {
+            if(record.type != PUSH_PROP)
+                continue;
+
+            streamed.emplace_back(record.type, record.indx, record.time, record.data);
+            seen    = true;
+        }
+    }
+    writer.join();
+
+    EXPECT_TRUE(early);
+    EXPECT_EQ(streamed, all);
+    std::filesystem::remove("columns.pipe");
+}
+
+TEST(Check, Monitor)
+{
+    using namespace referee::db;
+
+    auto    boolean = TypeBoolean();
+    auto    integer = TypeInteger();
+    auto    number  = TypeNumber();
+    auto    record  = TypeBuilderRecord().integer("lo").integer("hi").build();
+
+    Writer  writer;
+    writer.open("monitor.rdb");
+
+    auto    typeB   = writer.declType(&boolean);
+    auto    typeI   = writer.declType(&integer);
+    auto    typeN   = writer.declType(&number);
+    auto    typeC   = writer.declType(record);
+
+    auto    confC   = writer.declConf(typeC, "C");
+    writer.pushData(confC, DataWriter().integer(1).integer(3).build());
+
+    auto    propA   = writer.declProp(typeB, "a");
+    auto    propN   = writer.declProp(typeI, "n");
+    auto    propX   = writer.declProp(typeN, "x");
+    auto    propM   = writer.declProp(typeI, "m");
+
+    //  n leaves [C.lo, C.hi] at 30, everything else holds
+    writer.pushData(propX,  0, DataWriter().number(0.5).build());
+    for(auto [time, a, n, m]: {std::tuple(0, false, 1, 1), std::tuple(10, true, 2, 2), std::tuple(20, false, 3, 1), std::tuple(30, false, 4, 1)})
+    {
+        writer.pushData(propA, time, DataWriter().boolean(a).build());
+        writer.pushData(propN, time, DataWriter().integer(n).build());
+        writer.pushData(propM, time, DataWriter().integer(m).build());
+    }
+    writer.close();
+
+    std::string         filename    = "../test/check/check.ref";
+    std::ifstream       stream(filename, std::ios_base::in);
+    std::ostringstream  os;
+
+    ASSERT_TRUE(stream.is_open());
+    EXPECT_FALSE(Referee::monitor(stream, "monitor.rdb", "monitor.rdb", "", os));
+    EXPECT_NE(os.str().find("at 30"), std::string::npos);
+    EXPECT_NE(os.str().find("3 passed, 1 failed, 1 not past-time"), std::string::npos);
+    EXPECT_NE(os.str().find("4 events"), std::string::npos);
+}
+
+TEST(Check, Watch)
+{
+    using namespace referee::db;
+
+    auto    boolean = TypeBoolean();
+    auto    integer = TypeInteger();
+    auto    number  = TypeNumber();
+    auto    record  = TypeBuilderRecord().integer("lo").integer("hi").build();
+
+    //  the trace up to 30, and up to 70 with the first one as its prefix
+    auto    write   = [&](std::string filename, int until)
+    {
+        Writer  writer;
+        writer.open(filename);
+
+        auto    typeB   = writer.declType(&boolean);
+        auto    typeI   = writer.declType(&integer);
+        auto    typeN   = writer.declType(&number);
+        auto    typeC   = writer.declType(record);
+
+        auto    confC   = writer.declConf(typeC, "C");
+        writer.pushData(confC, DataWriter().integer(1).integer(3).build());
+
+        auto    propA   = writer.declProp(typeB, "a");
+        auto    propN   = writer.declProp(typeI, "n");
+        auto    propX   = writer.declProp(typeN, "x");
+        auto    propM   = writer.declProp(typeI, "m");
+
+        writer.pushData(propX,  0, DataWriter().number(0.5).build());
+        for(auto [time, a, n, m]: {std::tuple(0, false, 1, 1), std::tuple(10, true, 2, 2), std::tuple(20, false, 3, 1), std::tuple(30, false, 4, 1),
+                                   std::tuple(40, false, 5, 1), std::tuple(50, false, 5, 1), std::tuple(60, false, 6, 1), std::tuple(70, false, 6, 1)})
+        {
+            if(time > until)
+                break;
+            writer.pushData(propA, time, DataWriter().boolean(a).build());
+            writer.pushData(propN, time, DataWriter().integer(n).build());
+            writer.pushData(propM, time, DataWriter().integer(m).build());
+        }
+        writer.close();
+
+        std::ifstream   is(filename, std::ios_base::binary);
+        return  std::string(std::istreambuf_iterator<char>(is), {});
+    };
+
+    auto    head    = write("watch.head.rdb", 30);
+    auto    full    = write("watch.full.rdb", 70);
+    ASSERT_EQ(full.substr(0, head.size()), head);
+
+    std::filesystem::copy_file("../test/check/check.ref", "watch.ref", std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::remove("watch.rdb");
+    ASSERT_EQ(mkfifo("watch.rdb", 0600), 0);
+
+    std::ostringstream  os;
+    Options             options;
+    bool                passed  = true;
+
+    options.watch   = "watch.ref";
+
+    std::thread monitor([&]() {
+        std::ifstream   stream(options.watch, std::ios_base::in);
+        passed  = Referee::monitor(stream, "check.watch", "watch.rdb", "", os, options);
+    });
+
+    //  opening the pipe waits for the monitor to be built, G(a => (n == 2))
+    //  is swapped for G(n < 6) while the trace streams
+    {
+        std::ofstream   pipe("watch.rdb", std::ios_base::binary);
+        pipe << head << std::flush;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        std::ifstream   is("../test/check/check.ref");
+        std::string     text(std::istreambuf_iterator<char>(is), {});
+        text.replace(text.find("G(a => (n == 2));"), 17, "G(n < 6);");
+        std::ofstream("watch.ref") << text;
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+
+        pipe << full.substr(head.size());
+    }
+    monitor.join();
+
+    //  13:0 failed at 30 before the reload and keeps its verdict
+    EXPECT_FALSE(passed);
+    EXPECT_NE(os.str().find("reload: 1 compiled, 3 kept, 1 dropped"), std::string::npos);
+    EXPECT_NE(os.str().find("at 30"), std::string::npos);
+    EXPECT_NE(os.str().find("at 60"), std::string::npos);
+    EXPECT_NE(os.str().find("2 passed, 2 failed, 1 not past-time"), std::string::npos);
+    EXPECT_NE(os.str().find("8 events"), std::string::npos);
+
+    std::filesystem::remove("watch.rdb");
+}
+
+TEST(Check, Bitset)
+{
+    //  200 rows so the packed verdicts of the untimed operators span several words
+    std::ofstream   csv("bitset.csv");
+    csv << "__time__,a,b,n,x\n";
+    for(int i = 0; i < 200; i++)
+    {
+        csv << i * 10 << "," << (i % 7 == 0 ? "true" : "false") << "," << (i % 3 == 0 ? "true" : "false") << "," << i % 11 << "," << (i % 13) * 0.25 << "\n";
+    }
+    csv.close();
+
+    //  the last two read whole words of the columns with Layout::columns
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "data n: integer;\n"
+                      "data x: number;\n"
+                      "G(a => F(b));\n"
+                      "G(F(a));\n"
+                      "G(O(a));\n"
+                      "G(a || Uw(!a, b));\n"
+                      "G(H(!b) || Sw(!a, b));\n"
+                      "G(Uw((n < 10) || !b, (x >= 2.75) && (n != 3)));\n"
+                      "G(Uw(n < 10, ((x >= 1.5) || !a) && (n > 9)));\n";
+
+    auto    verdicts    = [&](std::string name, bool bitset, Layout layout)
+    {
+        Options             options;
+        options.bitset  = bitset;
+        options.layout  = layout;
+
+        std::istringstream  is(source);
+        std::ostringstream  os;
+        Referee::check(is, name, "bitset.csv", "", os, options);
+
+        std::istringstream  lines(os.str());
+        std::string         line;
+        std::string         result;
+        while(std::getline(lines, line))
+        {
+            if(line.starts_with("PASS") || line.starts_with("FAIL"))
+                result  += line.substr(0, 4) + " ";
+        }
+
+        return  result;
+    };
+
+    EXPECT_EQ(verdicts("bitset.on", true, Layout::pointers), "PASS FAIL PASS FAIL FAIL FAIL PASS ");
+    EXPECT_EQ(verdicts("bitset.off", false, Layout::pointers), "PASS FAIL PASS FAIL FAIL FAIL PASS ");
+    EXPECT_EQ(verdicts("bitset.columns", true, Layout::columns), "PASS FAIL PASS FAIL FAIL FAIL PASS ");
+    EXPECT_EQ(verdicts("bitset.columns.off", false, Layout::columns), "PASS FAIL PASS FAIL FAIL FAIL PASS ");
+}
+
+TEST(Check, Share)
+{
+    std::ofstream   csv("share.csv");
+    csv << "__time__,a,b\n";
+    for(int i = 0; i < 200; i++)
+    {
+        csv << i * 10 << "," << (i % 5 == 0 ? "true" : "false") << "," << (i % 4 == 0 && i < 190 ? "true" : "false") << "\n";
+    }
+    csv.close();
+
+    //  F(b) and Uw(!a, b) are nested in several specs, the second one under the first
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "G(a => F(b));\n"
+                      "G(!a => F(b));\n"
+                      "G(F(b) || Uw(!a, b));\n"
+                      "G(a => F(Uw(!a, b)));\n"
+                      "G(b => F(Uw(!a, b)));\n";
+
+    auto    run     = [&](std::string name, bool share, unsigned jobs)
+    {
+        Options             options;
+        options.share   = share;
+        options.jobs    = jobs;
+
+        std::istringstream  is(source);
+        std::ostringstream  os;
+        Referee::check(is, name, "share.csv", "", os, options);
+
+        std::istringstream  lines(os.str());
+        std::string         line;
+        std::string         result;
+        while(std::getline(lines, line))
+        {
+            if(line.starts_with("PASS") || line.starts_with("FAIL"))
+                result  += line.substr(0, 4) + " ";
+        }
+
+        return  result;
+    };
+
+    EXPECT_EQ(run("share.off", false, 1), "FAIL FAIL FAIL PASS PASS ");
+    EXPECT_EQ(run("share.on", true, 1), "FAIL FAIL FAIL PASS PASS ");
+    EXPECT_EQ(run("share.parts", true, 3), "FAIL FAIL FAIL PASS PASS ");
+
+    //  a function called on its own computes the buffers it reads
+    std::istringstream  is(source);
+    std::ostringstream  ir;
+    Referee::compile(is, "share.ll", ir);
+    EXPECT_NE(ir.str().find("define noalias i8* @shared.0.0("), std::string::npos);
+    EXPECT_NE(ir.str().find("define noalias i8* @shared.1."), std::string::npos);
+    EXPECT_NE(ir.str().find("call i8* @shared.0.0("), std::string::npos);
+}
+
+TEST(Check, Chunk)
+{
+    std::ofstream   csv("chunk.csv");
+    csv << "__time__,a,b\n";
+    for(int i = 0; i < 1000; i++)
+    {
+        csv << i * 10 << "," << (i % 7 == 0 ? "true" : "false") << "," << (i % 3 == 0 ? "true" : "false") << "\n";
+    }
+    csv.close();
+
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "G(a => F(b));\n"
+                      "G(F(a));\n"
+                      "G(O(a) && Xw(F[0:40](b)));\n"
+                      "G(a || Uw(!a, b));\n"
+                      "G(H(!b) || Sw(!a, F(b)));\n"
+                      "G(b || Ys(b) || Xs(b) || Xs(Xs(b)));\n";
+
+    //  chunks of a few rows put every seam on many chunk edges
+    auto    verdicts    = [&](std::string name, size_t chunk, bool bitset)
+    {
+        Options             options;
+        options.chunk   = chunk;
+        options.bitset  = bitset;
+
+        std::istringstream  is(source);
+        std::ostringstream  os;
+        Referee::check(is, name, "chunk.csv", "", os, options);
+
+        std::istringstream  lines(os.str());
+        std::string         line;
+        std::string         result;
+        while(std::getline(lines, line))
+        {
+            if(line.starts_with("PASS") || line.starts_with("FAIL"))
+                result  += line.substr(0, 4) + " ";
+        }
+
+        return  result;
+    };
+
+    EXPECT_EQ(verdicts("chunk.whole", 0, true), "PASS FAIL PASS FAIL PASS PASS ");
+    EXPECT_EQ(verdicts("chunk.1", 1, true), "PASS FAIL PASS FAIL PASS PASS ");
+    EXPECT_EQ(verdicts("chunk.7", 7, true), "PASS FAIL PASS FAIL PASS PASS ");
+    EXPECT_EQ(verdicts("chunk.100", 100, false), "PASS FAIL PASS FAIL PASS PASS ");
+}
+
+TEST(Check, Witness)
+{
+    std::ofstream   csv("witness.csv");
+    csv << "__time__,a,b\n";
+    for(int i = 0; i < 10; i++)
+    {
+        csv << i * 10 << "," << (i == 3 ? "true" : "false") << "," << (i < 2 ? "true" : "false") << "\n";
+    }
+    csv.close();
+
+    auto    source  = "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "G(a => F[0:20](b));\n"
+                      "G(!a);\n"
+                      "G(F(a) || H(!a));\n"
+                      "G(b => F(a));\n";
+
+    //  rows count from 1, row 0 is the sentinel in front of the trace
+    for(auto chunk: {0, 4})
+    {
+        Options             options;
+        options.witness = true;
+        options.chunk   = chunk;
+
+        std::istringstream  is(source);
+        std::ostringstream  os;
+        EXPECT_FALSE(Referee::check(is, "witness." + std::to_string(chunk), "witness.csv", "", os, options));
+        EXPECT_NE(os.str().find("at 30 (row 4, decided at row 6)"), std::string::npos);
+        EXPECT_NE(os.str().find("at 30 (row 4)\n"), std::string::npos);
+        EXPECT_NE(os.str().find("at 40 (row 5, decided at row 4)"), std::string::npos);
+        EXPECT_NE(os.str().find("1 passed, 3 failed"), std::string::npos);
+    }
+}
+
+TEST(Check, Cache)
+{
+    std::string         filename    = "../test/check/check.ref";
+    auto                dir         = std::filesystem::temp_directory_path() / "referee-check-cache";
+    Options             options;
+
+    std::filesystem::remove_all(dir);
+    options.cache   = dir.string();
+    options.jobs    = 1;
+
+    //  the first run compiles and stores the object, the second one loads it
+    auto    run     = [&](std::string name)
+    {
+        std::ifstream       stream(filename, std::ios_base::in);
+        std::ostringstream  os;
+
+        EXPECT_TRUE(Referee::check(stream, name, "../test/check/check.csv", "../test/check/conf.csv", os, options));
+        EXPECT_EQ(os.str().find("FAIL"), std::string::npos);
+
+        return  os.str();
+    };
+
+    auto    cold    = run("cache.cold");
+    auto    warm    = run("cache.warm");
+    EXPECT_EQ(cold.find(", cached"), std::string::npos);
+    EXPECT_NE(warm.find(", cached"), std::string::npos);
+    EXPECT_EQ(std::count(cold.begin(), cold.end(), '\n'), std::count(warm.begin(), warm.end(), '\n'));
+
+    //  other options compile other code
+    options.optLevel    = 1;
+    EXPECT_EQ(run("cache.O1").find(", cached"), std::string::npos);
+
+    //  four workers compile the module in four parts, stored as four objects
+    options.jobs        = 4;
+    auto    split   = run("cache.split");
+    auto    joined  = run("cache.joined");
+    EXPECT_EQ(split.find(", cached"), std::string::npos);
+    EXPECT_NE(joined.find(", cached"), std::string::npos);
+    EXPECT_EQ(std::count(split.begin(), split.end(), '\n'), std::count(joined.begin(), joined.end(), '\n'));
+    options.jobs        = 1;
+
+    //  a limit below one object evicts every one of them
+    options.cacheSize   = 1;
+    options.optLevel    = 0;
+    run("cache.evict");
+    EXPECT_EQ(run("cache.evicted").find(", cached"), std::string::npos);
+
+    std::filesystem::remove_all(dir);
+
+    //  every option is a field of its own, changing any one of them changes the key
+    auto    source  = std::string("data a: boolean;\nG(a);\n");
+    auto    base    = Cache::key(source, Options());
+    std::set<std::string>   keys    = {base};
+    for(auto change: std::vector<std::function<void(Options&)>>{
+            [](Options& o) {o.sweep     = !o.sweep;},
+            [](Options& o) {o.bitset    = !o.bitset;},
+            [](Options& o) {o.monitor   = !o.monitor;},
+            [](Options& o) {o.layout    = Layout::columns;},
+            [](Options& o) {o.chunk     = 1024;},
+            [](Options& o) {o.witness   = !o.witness;},
+            [](Options& o) {o.optLevel  = 3 - o.optLevel;},
+            [](Options& o) {o.share     = !o.share;},
+            [](Options& o) {o.cpu       = "x86-64";},
+            [](Options& o) {o.cpu       = "x86-64 +avx2";},
+            [](Options& o) {o.cpu       = "x86-64"; o.features = "+avx2";}})
+    {
+        Options options;
+        change(options);
+        EXPECT_TRUE(keys.insert(Cache::key(source, options)).second);
+    }
+}
+
+TEST(Check, Emit)
+{
+    auto    dir     = std::filesystem::temp_directory_path() / "referee-check-emit";
+    auto    source  = "type mode: enum {IDLE, BUSY};\n"
+                      "conf R: struct {lo: integer; hi: integer;};\n"
+                      "data a: boolean;\n"
+                      "data b: boolean;\n"
+                      "data m: mode;\n"
+                      "G(a => F(b));\n";
+
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    for(auto [kind, file]: {std::pair(Emit::obj, "spec.o"), std::pair(Emit::bc, "spec.bc"), std::pair(Emit::so, "libspec.so")})
+    {
+        std::istringstream  is(source);
+        EXPECT_TRUE(Referee::emit(is, std::string("emit.") + file, (dir / file).string(), kind));
+        EXPECT_TRUE(std::filesystem::exists(dir / file));
+    }
+
+    std::ifstream       header(dir / "libspec.h");
+    std::stringstream   text;
+    text << header.rdbuf();
+    EXPECT_NE(text.str().find("typedef struct __prop_t"), std::string::npos);
+    EXPECT_NE(text.str().find("struct R\n{\n    int64_t lo;"), std::string::npos);
+    EXPECT_NE(text.str().find("m_BUSY = 2"), std::string::npos);
+    EXPECT_NE(text.str().find("bool    libspec_expr_6_0_6_12(__prop_t const* frst"), std::string::npos);
+
+    //  the rows of a module with boolean props a and b and an enum m, laid out as pointers
+    struct Row
+    {
+        int64_t         time;
+        bool const*     a;
+        bool const*     b;
+        int8_t const*   m;
+    };
+
+    bool const      T   = true;
+    bool const      F   = false;
+    int8_t const    M   = 1;
+    std::vector<Row> rows;
+    for(int i = 0; i < 13; i++)
+    {
+        rows.push_back({i * 10 - 1, i % 5 == 1 ? &T : &F, i % 5 == 3 ? &T : &F, &M});
+    }
+
+    auto    so      = dlopen((dir / "libspec.so").c_str(), RTLD_NOW | RTLD_LOCAL);
+    ASSERT_NE(so, nullptr) << dlerror();
+
+    auto    func    = (bool (*)(void*, void*, void*))dlsym(so, "libspec_expr_6_0_6_12");
+    ASSERT_NE(func, nullptr);
+    EXPECT_TRUE(func(&rows[0], &rows[10], nullptr));
+    EXPECT_FALSE(func(&rows[0], &rows[12], nullptr));
+
+    dlclose(so);
+
+    //  the window runtime of the step functions isn't linked into objects
+    Options     options;
+    options.monitor = true;
+    for(auto [kind, file]: {std::pair(Emit::obj, "monitor.o"), std::pair(Emit::so, "libmonitor.so")})
+    {
+        std::istringstream  is(source);
+        EXPECT_FALSE(Referee::emit(is, std::string("emit.") + file, (dir / file).string(), kind, options));
+        EXPECT_FALSE(std::filesystem::exists(dir / file));
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -61,99 +61,24 @@
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/GVN.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
-#include "llvm/IRReader/IRReader.h"
-#include "llvm/Support/SourceMgr.h"
 #include <memory>
 
 #include "antlr2ast.hpp"
+#include "jit.hpp"
 #include "strings.hpp"
 #include "visitors/compile.hpp"
 
 
-//  LCOV_EXCL_START 
-//  GCOV_EXCL_START 
-extern "C"
-void    debug(int64_t value)
-{
-    printf("debug: %lld\n", value);
-}
-//  GCOV_EXCL_STOP
-//  LCOV_EXCL_STOP
-
-class RefereeJIT 
-{
-private:
-    std::unique_ptr<llvm::orc::ExecutionSession>    ES;
-    llvm::DataLayout                                DL;
-    llvm::orc::MangleAndInterner                    Mangle;
-    llvm::orc::RTDyldObjectLinkingLayer             ObjectLayer;
-    llvm::orc::IRCompileLayer                       CompileLayer;
-    llvm::orc::JITDylib&                            MainJD;
-
-public:
-    RefereeJIT(
-            std::unique_ptr<llvm::orc::ExecutionSession>    ES,
-            llvm::orc::JITTargetMachineBuilder              JTMB, 
-            llvm::DataLayout                                DL)
-        : ES(std::move(ES))
-        , DL(std::move(DL))
-        , Mangle(*this->ES, this->DL)
-        , ObjectLayer(*this->ES,[]() { return std::make_unique<llvm::SectionMemoryManager>(); })
-        , CompileLayer(*this->ES, ObjectLayer, std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(JTMB)))
-        , MainJD(this->ES->createBareJITDylib("<main>")) 
-    {
-
-        llvm::ExitOnError()(MainJD.define(
-            llvm::orc::absoluteSymbols(llvm::orc::SymbolMap{
-                { Mangle("debug"), llvm::JITEvaluatedSymbol::fromPointer(&debug)}})));
-
-        MainJD.addGenerator(cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(DL.getGlobalPrefix())));
-    }
-
-    ~RefereeJIT() 
-    {
-        if (auto Err = ES->endSession())
-        {
-            ES->reportError(std::move(Err));
-        }
-    }
-
-    static llvm::Expected<std::unique_ptr<RefereeJIT>> Create() 
-    {
-        auto EPC = llvm::orc::SelfExecutorProcessControl::Create();
-        if (!EPC)
-            return EPC.takeError();
-
-        auto    ES     = std::make_unique<llvm::orc::ExecutionSession>(std::move(*EPC));
-        auto    JTMB   = llvm::orc::JITTargetMachineBuilder(ES->getExecutorProcessControl().getTargetTriple());
-        auto    DL     = JTMB.getDefaultDataLayoutForTarget();
-        
-        if (!DL)
-            return DL.takeError();
-
-        return std::make_unique<RefereeJIT>(std::move(ES), std::move(JTMB), std::move(*DL));
-    }
-
-    const llvm::DataLayout& getDataLayout() const   { return DL; }
-    llvm::orc::JITDylib&    getMainJITDylib()       { return MainJD; }
-    llvm::Error             addModule(llvm::orc::ThreadSafeModule TSM, llvm::orc::ResourceTrackerSP RT = nullptr)
-    {
-        if (!RT)
-            RT = MainJD.getDefaultResourceTracker();
-        return CompileLayer.add(RT, std::move(TSM));
-    }
-
-    llvm::Expected<llvm::JITEvaluatedSymbol>    lookup(llvm::StringRef Name)
-    {
-        return ES->lookup({&MainJD}, Mangle(Name.str()));
-    }
-};
-
 typedef struct state_t {
     uint64_t    time;
     bool*       lttr[26];
 } state_t;
 
+typedef struct value_t {
+    uint64_t    time;
+    bool        lttr[26];
+} value_t;
+
 typedef struct conf_t {
     int64_t     i;
     bool        b;
@@ -167,6 +92,10 @@ class LogicTest : public ::testing::Test {
 
 protected:
     state_t     state[28];  //  1 + 26 + 1
+    int64_t     times[28];  //  state as Layout::columns lays it out
+    bool        column[26][28];
+    bool*       cols[26];
+    value_t     values[28]; //  state as Layout::values lays it out
     conf_t      conf;
     bool        T   = true;
     bool        F   = false;
@@ -186,6 +115,23 @@ protected:
         state[ 0].time  = state[ 1].time - 1;
         state[27].time  = state[26].time + 1;
 
+        for(int i = 0; i < 28; i++)
+        {
+            times[i]        = state[i].time;
+            values[i].time  = state[i].time;
+
+            for(int j = 0; j < 26; j++)
+            {
+                column[j][i]    = i > 0 && i < 27 && i - 1 == j;
+                values[i].lttr[j]   = column[j][i];
+            }
+        }
+
+        for(int j = 0; j < 26; j++)
+        {
+            cols[j] = column[j];
+        }
+
         conf.i  = 1;
         conf.b  = true;
         conf.n  = 1.1;
@@ -212,40 +158,30 @@ protected:
         }
 */
     }
+
+    void    run(std::string filename, std::string name, bool expected, Options const& options = Options());
+    void    monitor(std::string filename, std::string name, bool expected);
 };
 
 static llvm::ExitOnError ExitOnErr;
 
-TEST_F(LogicTest, Pass)
+void    LogicTest::run(std::string filename, std::string name, bool expected, Options const& options)
 {
-    std::string                 filename    = "../test/logic/pass.ref";
     std::ifstream               stream(filename, std::ios_base::in);
 
     ASSERT_TRUE(stream.is_open());
 
-    std::ostringstream          os;
-    Referee::compile(stream, filename, os);
-    std::string                 ir  = os.str();
-    auto    ref     = llvm::StringRef(ir);
-    auto    buff    = llvm::MemoryBuffer::getMemBuffer(ref);
-
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
-    llvm::InitializeNativeTargetAsmParser();
+    auto    TSM         = Referee::module(stream, name, options);
     auto    TheJIT      = ExitOnErr(RefereeJIT::Create());
 
-    auto    error       = std::make_unique<llvm::SMDiagnostic>();
-    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
-    auto    TheModule   = llvm::parseIR(*buff, *error, *TheContext);
-    auto    TheBuilder  = std::make_unique<llvm::IRBuilder<>>(*TheContext);   
-    auto    TheFPM      = std::make_unique<llvm::legacy::FunctionPassManager>(TheModule.get());
+    auto    TheModule   = TSM.getModuleUnlocked();
+    auto    TheBuilder  = std::make_unique<llvm::IRBuilder<>>(TheModule->getContext());   
+    auto    TheFPM      = std::make_unique<llvm::legacy::FunctionPassManager>(TheModule);
 #if 0
     auto    funcType    = llvm::FunctionType::get(TheBuilder->getVoidTy(), {TheBuilder->getInt64Ty()}, false);
     auto    func        = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, "debug", *TheModule);
 #endif
         
-    TheModule->setDataLayout(TheJIT->getDataLayout());
-
     try {
         TheFPM->add(llvm::createInstructionCombiningPass());
         TheFPM->add(llvm::createReassociatePass());
@@ -269,12 +205,13 @@ TEST_F(LogicTest, Pass)
 
         for(auto iter = functions.begin(); iter != functions.end(); iter++)
         {
-            names.push_back(iter->getName().str());
+            if(!iter->isDeclaration())
+                names.push_back(iter->getName().str());
 
             TheFPM->run(*iter);
         }
 
-        ExitOnErr(TheJIT->addModule(llvm::orc::ThreadSafeModule(std::move(TheModule), std::move(TheContext))));
+        ExitOnErr(TheJIT->addModule(std::move(TSM)));
 
         //auto    symbol  = ExitOnErr(TheJIT->lookup("30:3 .. 30:13"));
         //auto    func    = (bool (*)(state_t*, state_t*, void*))(intptr_t)symbol.getAddress();
@@ -284,12 +221,17 @@ TEST_F(LogicTest, Pass)
             for(auto name: names)
             {
                 auto    symbol  = ExitOnErr(TheJIT->lookup(name));
-                auto    func    = (bool (*)(state_t*, state_t*, void*))(intptr_t)symbol.getAddress();
-                if(name == "debug")
-                    continue;
-                auto    result  = func(&state[0], &state[27], &conf);
+                auto    func    = (bool (*)(void*, void*, void*))(intptr_t)symbol.getAddress();
+                auto    funcC   = (bool (*)(void*, void*, void*, void*))(intptr_t)symbol.getAddress();
+                if(name == "debug" || name.starts_with("shared."))
+                    continue;   //  fillers of shared subformulas, the functions call them
+                auto    result  = options.layout == Layout::columns
+                                ? funcC(&times[0], &times[27], &conf, cols)
+                                : options.layout == Layout::values
+                                ? func(&values[0], &values[27], &conf)
+                                : func(&state[0], &state[27], &conf);
                 std::cout << std::setw(20) << std::left << name << " eval: " << result << std::endl; 
-                ASSERT_TRUE(result);
+                ASSERT_EQ(result, expected);
             }
         }
     }
@@ -305,83 +247,138 @@ TEST_F(LogicTest, Pass)
     }
 }
 
-TEST_F(LogicTest, Fail)
+void    LogicTest::monitor(std::string filename, std::string name, bool expected)
 {
-    std::string                 filename    = "../test/logic/fail.ref";
     std::ifstream               stream(filename, std::ios_base::in);
 
     ASSERT_TRUE(stream.is_open());
 
-    std::ostringstream          os;
-    Referee::compile(stream, filename, os);
-    std::string                 ir  = os.str();
-    auto    ref     = llvm::StringRef(ir);
-    auto    buff    = llvm::MemoryBuffer::getMemBuffer(ref);
+    Options                     options;
+    options.monitor = true;
 
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
-    llvm::InitializeNativeTargetAsmParser();
+    auto    TSM         = Referee::module(stream, name, options);
     auto    TheJIT      = ExitOnErr(RefereeJIT::Create());
+    auto    TheModule   = TSM.getModuleUnlocked();
 
-    auto    error       = std::make_unique<llvm::SMDiagnostic>();
-    auto    TheContext  = std::make_unique<llvm::LLVMContext>();
-    auto    TheModule   = llvm::parseIR(*buff, *error, *TheContext);
-    auto    TheBuilder  = std::make_unique<llvm::IRBuilder<>>(*TheContext);   
-    auto    TheFPM      = std::make_unique<llvm::legacy::FunctionPassManager>(TheModule.get());
-        
-    TheModule->setDataLayout(TheJIT->getDataLayout());
+    ASSERT_TRUE(TheModule);
 
-    try {
-        TheFPM->add(llvm::createInstructionCombiningPass());
-        TheFPM->add(llvm::createReassociatePass());
-        TheFPM->add(llvm::createGVNPass());
-        TheFPM->add(llvm::createCFGSimplificationPass());
-        TheFPM->add(llvm::createLoopStrengthReducePass());
-        TheFPM->add(llvm::createLoopLoadEliminationPass());
-        TheFPM->add(llvm::createLoopDataPrefetchPass());
-        TheFPM->add(llvm::createLoopSimplifyCFGPass());
-        TheFPM->add(llvm::createLoopGuardWideningPass());
-        TheFPM->add(llvm::createLoopDistributePass());
-        TheFPM->add(llvm::createInstructionCombiningPass());
-        TheFPM->add(llvm::createReassociatePass());
-        TheFPM->add(llvm::createGVNPass());
-        TheFPM->add(llvm::createCFGSimplificationPass());
+    std::vector<std::string>    names;
+    for(auto& func: TheModule->getFunctionList())
+    {
+        auto    funcName    = func.getName().str();
 
-        TheFPM->doInitialization();
+        if(funcName.ends_with(".step"))
+            names.push_back(funcName.substr(0, funcName.size() - 5));
+    }
 
-        auto& functions = TheModule->getFunctionList();
-        std::vector<std::string>    names;
+    ASSERT_FALSE(names.empty());
 
-        for(auto iter = functions.begin(); iter != functions.end(); iter++)
-        {
-            names.push_back(iter->getName().str());
+    ExitOnErr(TheJIT->addModule(std::move(TSM)));
 
-            TheFPM->run(*iter);
-        }
+    for(auto name: names)
+    {
+        auto    check   = (bool (*)(state_t*, state_t*, void*))(intptr_t)ExitOnErr(TheJIT->lookup(name)).getAddress();
+        auto    size    = (int64_t const*)(intptr_t)ExitOnErr(TheJIT->lookup(name + ".size")).getAddress();
+        auto    init    = (void (*)(void*))(intptr_t)ExitOnErr(TheJIT->lookup(name + ".init")).getAddress();
+        auto    step    = (bool (*)(void*, state_t*, void*))(intptr_t)ExitOnErr(TheJIT->lookup(name + ".step")).getAddress();
+        auto    done    = (void (*)(void*))(intptr_t)ExitOnErr(TheJIT->lookup(name + ".done")).getAddress();
 
-        ExitOnErr(TheJIT->addModule(llvm::orc::ThreadSafeModule(std::move(TheModule), std::move(TheContext))));
+        std::vector<char>   data(*size + 1);
+        auto    result  = true;
 
+        init(data.data());
+        for(int i = 1; i <= 26; i++)
         {
-            for(auto name: names)
-            {
-                auto    symbol  = ExitOnErr(TheJIT->lookup(name));
-                auto    func    = (bool (*)(state_t*, state_t*, void*))(intptr_t)symbol.getAddress();
-                if(name == "debug")
-                    continue;
-                auto    result  = func(&state[0], &state[27], &conf);
-                std::cout << std::setw(20) << std::left << name << " eval: " << result << std::endl; 
-                ASSERT_FALSE(result);
-            }
+            result  = step(data.data(), &state[i], &conf) && result;
         }
+        done(data.data());
+
+        std::cout << std::setw(20) << std::left << name << " step: " << result << std::endl; 
+        ASSERT_EQ(result, check(&state[0], &state[27], &conf));
+        ASSERT_EQ(result, expected);
     }
-    catch(Exception& e)
-    {
-        std::cerr << "exception: " << e.what() << std::endl;
-        ASSERT_TRUE(false);
-    }
-    catch(std::exception& e)
-    {
-        std::cerr << "exception: " << e.what() << std::endl;
-        ASSERT_TRUE(false);
-    }
+}
+
+TEST_F(LogicTest, Pass)
+{
+    run("../test/logic/pass.ref", "pass", true);
+}
+
+TEST_F(LogicTest, Fail)
+{
+    run("../test/logic/fail.ref", "fail", false);
+}
+
+TEST_F(LogicTest, PassNoSweep)
+{
+    Options options;
+    options.sweep   = false;
+
+    run("../test/logic/pass.ref", "pass-no-sweep", true, options);
+}
+
+TEST_F(LogicTest, FailNoSweep)
+{
+    Options options;
+    options.sweep   = false;
+
+    run("../test/logic/fail.ref", "fail-no-sweep", false, options);
+}
+
+TEST_F(LogicTest, PassNoBitset)
+{
+    Options options;
+    options.bitset  = false;
+
+    run("../test/logic/pass.ref", "pass-no-bitset", true, options);
+}
+
+TEST_F(LogicTest, FailNoBitset)
+{
+    Options options;
+    options.bitset  = false;
+
+    run("../test/logic/fail.ref", "fail-no-bitset", false, options);
+}
+
+TEST_F(LogicTest, PassColumns)
+{
+    Options options;
+    options.layout  = Layout::columns;
+
+    run("../test/logic/pass.ref", "pass-columns", true, options);
+}
+
+TEST_F(LogicTest, FailColumns)
+{
+    Options options;
+    options.layout  = Layout::columns;
+
+    run("../test/logic/fail.ref", "fail-columns", false, options);
+}
+
+TEST_F(LogicTest, PassValues)
+{
+    Options options;
+    options.layout  = Layout::values;
+
+    run("../test/logic/pass.ref", "pass-values", true, options);
+}
+
+TEST_F(LogicTest, FailValues)
+{
+    Options options;
+    options.layout  = Layout::values;
+
+    run("../test/logic/fail.ref", "fail-values", false, options);
+}
+
+TEST_F(LogicTest, PassMonitor)
+{
+    monitor("../test/logic/pass.ref", "pass-monitor", true);
+}
+
+TEST_F(LogicTest, FailMonitor)
+{
+    monitor("../test/logic/fail.ref", "fail-monitor", false);
 }
@@ -0,0 +1,62 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+#include "pool.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(Pool, simple)
+{
+    Pool                            pool(4);
+    std::vector<std::atomic<int>>   calls(1000);
+
+    EXPECT_EQ(pool.size(), 4u);
+
+    for(int batch = 0; batch < 3; batch++)
+    {
+        pool.run(calls.size(), [&](size_t i) {calls[i]++;});
+    }
+
+    for(auto& count: calls)
+    {
+        EXPECT_EQ(count, 3);
+    }
+}
+
+TEST(Pool, steal)
+{
+    Pool                            pool(4);
+    std::vector<std::thread::id>    ids(8);
+
+    //  worker 0 owns the slow tasks 0 and 1, the others have to take them
+    pool.run(ids.size(), [&](size_t i) {
+        if(i < 2)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ids[i]  = std::this_thread::get_id();
+    });
+
+    EXPECT_NE(ids[0], ids[1]);
+}